@@ -0,0 +1,27 @@
+#version 410
+
+uniform sampler2D tex;
+in vec2 fragUV;
+
+// 순서와 상관없는 블렌딩(weighted blended OIT)용 구름 셰이더. (weightedBlendedOIT.h 참고)
+// 화면에 바로 그리지 않고, 누적 버퍼 2개에 나눠서 출력함.
+layout(location = 0) out vec4 accum; // (rgb * a, a) * 가중치. 프래그먼트끼리 더해짐
+layout(location = 1) out float revealage; // a. 프래그먼트끼리 (1 - a) 가 곱해짐
+
+void main(){
+  vec4 color = texture(tex, fragUV);
+
+  // cloud.frag 와 같이 구름 영역의 불투명도를 0.8 로 제한함.
+  color.a = min(color.a, 0.8);
+
+  /*
+    정렬을 하지 않으므로, 앞에 있는 구름이 더 잘 보이도록 깊이에 따라 가중치를 줌.
+    gl_FragCoord.z 는 0(near) ~ 1(far) 이므로 가까울수록 가중치가 커짐.
+    불투명도가 아주 낮은 프래그먼트가 누적 결과를 지배하지 않도록 알파값도 가중치에 곱하고,
+    16비트 부동소수점 버퍼가 넘치거나 0 이 되지 않도록 범위를 제한함.
+  */
+  float weight = clamp(pow(min(1.0, color.a * 10.0) + 0.01, 3.0) * 1e3 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+
+  accum = vec4(color.rgb * color.a, color.a) * weight;
+  revealage = color.a;
+}
@@ -0,0 +1,22 @@
+#version 410
+
+uniform sampler2D accumTex;
+uniform sampler2D revealTex;
+in vec2 fragUV;
+out vec4 outCol;
+
+// 누적 버퍼 2개를 합쳐서 반투명 스프라이트들의 최종 색상을 구함. (weightedBlendedOIT.h 참고)
+void main(){
+  float revealage = texture(revealTex, fragUV).r;
+  if (revealage >= 1.0) {
+    discard; // 반투명 스프라이트가 하나도 안 그려진 픽셀은 건드리지 않음.
+  }
+
+  vec4 accum = texture(accumTex, fragUV);
+
+  // 가중치를 곱해서 더한 색을 가중치 합(accum.a)으로 나누면 가중 평균 색상이 됨.
+  vec3 averageColor = accum.rgb / max(accum.a, 1e-5);
+
+  // 뒤가 비쳐 보이는 정도가 revealage 이므로, 1 - revealage 만큼의 불투명도로 알파 블렌딩함.
+  outCol = vec4(averageColor, 1.0 - revealage);
+}
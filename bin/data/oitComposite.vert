@@ -0,0 +1,10 @@
+#version 410
+
+layout(location = 0) in vec3 pos; // 화면 전체를 덮는 쿼드의 NDC 좌표
+
+out vec2 fragUV;
+
+void main() {
+  gl_Position = vec4(pos.xy, 0.0, 1.0);
+  fragUV = pos.xy * 0.5 + 0.5; // 누적 버퍼는 화면과 같은 크기라서 NDC 좌표를 그대로 uv 로 바꾸면 됨.
+}
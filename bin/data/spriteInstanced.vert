@@ -0,0 +1,23 @@
+#version 410
+
+layout(location = 0) in vec3 pos;
+layout(location = 3) in vec2 uv;
+layout(location = 4) in mat4 model; // 인스턴스마다 다른 모델행렬 (4 ~ 7 번 location)
+layout(location = 8) in vec4 uvRect; // 텍스쳐 아틀라스에서 이 인스턴스가 그릴 영역. xy 는 uv 시작점, zw 는 uv 크기
+
+// 뷰행렬과 투영행렬은 모든 인스턴스, 모든 셰이더가 같으므로 유니폼 버퍼 하나를 공유함. (uniformCache.h 의 CameraBlock 과 같은 레이아웃)
+layout(std140) uniform Camera {
+  mat4 view;
+  mat4 proj;
+  mat4 viewProj; // proj * view
+};
+
+out vec2 fragUV;
+
+void main() {
+  gl_Position = viewProj * model * vec4(pos, 1.0);
+
+  // 스프라이트시트 프레임의 size, offset 계산은 아틀라스를 만들 때 미리 해두었으므로,
+  // 메쉬의 uv 를 아틀라스 영역 안으로 옮겨주기만 하면 됨. (스프라이트시트가 아닌 이미지도 똑같이 처리됨)
+  fragUV = uvRect.xy + vec2(uv.x, 1.0 - uv.y) * uvRect.zw;
+}
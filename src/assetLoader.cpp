@@ -0,0 +1,326 @@
+#include "assetLoader.h"
+#include "fileTime.h"
+#include <fstream>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t MAX_LEVELS = 16;
+
+static size_t alignUp(size_t v) {
+    return (v + 15) & ~(size_t)15;
+}
+
+//--------------------------------------------------------------
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    buffer.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read((char*)buffer.data(), buffer.size());
+    if (!in) {
+        buffer.clear();
+        return false;
+    }
+    bytes = buffer.data();
+    length = buffer.size();
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // 매핑은 파일 디스크립터를 닫아도 유지됨.
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    bytes = (const unsigned char*)mapped;
+    length = (size_t)info.st_size;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    buffer.clear();
+#else
+    if (bytes) {
+        munmap((void*)bytes, length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+}
+
+//--------------------------------------------------------------
+ofPixels TextureData::wrapLevel(int level) const {
+    const TextureLevel& l = levels[level];
+    ofPixels pixels;
+    pixels.setFromExternalPixels(const_cast<unsigned char*>(l.data), l.width, l.height, OF_PIXELS_RGBA);
+    return pixels;
+}
+
+//--------------------------------------------------------------
+// 8비트 RGBA 로 바꾼 뒤, 2x2 박스 필터로 한 레벨씩 줄여가며 밉맵을 만듦.
+static std::shared_ptr<TextureData> buildTextureData(const ofPixels& src, int mipLevels) {
+    auto data = std::make_shared<TextureData>();
+    int w = (int)src.getWidth();
+    int h = (int)src.getHeight();
+    size_t channels = src.getNumChannels();
+
+    std::vector<unsigned char> base((size_t)w * h * 4);
+    for (size_t i = 0; i < (size_t)w * h; ++i) {
+        const unsigned char* p = src.getData() + i * channels;
+        unsigned char* q = &base[i * 4];
+        if (channels >= 3) {
+            q[0] = p[0];
+            q[1] = p[1];
+            q[2] = p[2];
+        } else {
+            q[0] = q[1] = q[2] = p[0];
+        }
+        q[3] = (channels == 4 || channels == 2) ? p[channels - 1] : 255;
+    }
+    data->storage.push_back(std::move(base));
+
+    for (int level = 1; level < mipLevels && (w > 1 || h > 1); ++level) {
+        int nw = std::max(1, w / 2);
+        int nh = std::max(1, h / 2);
+        const std::vector<unsigned char>& prev = data->storage.back();
+        std::vector<unsigned char> next((size_t)nw * nh * 4);
+        for (int y = 0; y < nh; ++y) {
+            int y0 = std::min(y * 2, h - 1);
+            int y1 = std::min(y * 2 + 1, h - 1);
+            for (int x = 0; x < nw; ++x) {
+                int x0 = std::min(x * 2, w - 1);
+                int x1 = std::min(x * 2 + 1, w - 1);
+                for (int c = 0; c < 4; ++c) {
+                    int sum = prev[((size_t)y0 * w + x0) * 4 + c] + prev[((size_t)y0 * w + x1) * 4 + c]
+                        + prev[((size_t)y1 * w + x0) * 4 + c] + prev[((size_t)y1 * w + x1) * 4 + c];
+                    next[((size_t)y * nw + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        data->storage.push_back(std::move(next));
+        w = nw;
+        h = nh;
+    }
+
+    w = (int)src.getWidth();
+    h = (int)src.getHeight();
+    for (const std::vector<unsigned char>& level : data->storage) {
+        data->levels.push_back({ w, h, level.data() });
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return data;
+}
+
+// 임시 파일에 쓴 뒤 이름을 바꿔서, 쓰는 도중에 종료돼도 깨진 캐시 파일이 남지 않도록 함.
+static bool writeCache(const std::string& cachePath, const TextureData& data) {
+    std::string fullPath = ofToDataPath(cachePath);
+    std::string tempPath = fullPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary);
+        if (!out) {
+            return false;
+        }
+        uint32_t count = (uint32_t)data.levels.size();
+        out.write("TXC1", 4);
+        out.write((const char*)&count, sizeof(count));
+
+        size_t offset = alignUp(8 + data.levels.size() * 16);
+        for (const TextureLevel& level : data.levels) {
+            uint32_t w = (uint32_t)level.width;
+            uint32_t h = (uint32_t)level.height;
+            uint64_t start = offset;
+            out.write((const char*)&w, sizeof(w));
+            out.write((const char*)&h, sizeof(h));
+            out.write((const char*)&start, sizeof(start));
+            offset = alignUp(offset + (size_t)w * h * 4);
+        }
+
+        static const char zeros[16] = {};
+        for (const TextureLevel& level : data.levels) {
+            size_t pos = (size_t)out.tellp();
+            out.write(zeros, alignUp(pos) - pos);
+            out.write((const char*)level.data, (size_t)level.width * level.height * 4);
+        }
+        if (!out) {
+            return false;
+        }
+    }
+    std::remove(fullPath.c_str());
+    return std::rename(tempPath.c_str(), fullPath.c_str()) == 0;
+}
+
+// 캐시 파일을 메모리 맵하고 헤더를 검사함. 밉맵 레벨 수가 다르거나 파일이 깨졌으면 nullptr
+static std::shared_ptr<TextureData> mapCache(const std::string& cachePath, int mipLevels) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(ofToDataPath(cachePath))) {
+        return nullptr;
+    }
+    const unsigned char* bytes = file->data();
+    size_t size = file->size();
+    if (size < 8 || memcmp(bytes, "TXC1", 4) != 0) {
+        return nullptr;
+    }
+
+    uint32_t count;
+    memcpy(&count, bytes + 4, sizeof(count));
+    if (count == 0 || count > MAX_LEVELS || size < 8 + (size_t)count * 16) {
+        return nullptr;
+    }
+
+    auto data = std::make_shared<TextureData>();
+    for (uint32_t i = 0; i < count; ++i) {
+        const unsigned char* entry = bytes + 8 + i * 16;
+        uint32_t w, h;
+        uint64_t start;
+        memcpy(&w, entry, sizeof(w));
+        memcpy(&h, entry + 4, sizeof(h));
+        memcpy(&start, entry + 8, sizeof(start));
+        if (w == 0 || h == 0 || start > size || (uint64_t)w * h * 4 > size - start) {
+            return nullptr;
+        }
+        data->levels.push_back({ (int)w, (int)h, bytes + start });
+    }
+
+    // 원본 크기로 만들 수 있는 레벨 수가 요청보다 적을 수 있으므로, 그만큼만 맞으면 같은 설정으로 본다.
+    int expected = 1;
+    for (int w = data->getWidth(), h = data->getHeight(); expected < mipLevels && (w > 1 || h > 1); ++expected) {
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    if ((int)count != expected) {
+        return nullptr;
+    }
+
+    data->mapping = file;
+    data->fromCache = true;
+    return data;
+}
+
+//--------------------------------------------------------------
+AssetLoader::AssetLoader(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        stopping = true;
+    }
+    jobsChanged.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+void AssetLoader::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            jobsChanged.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return; // stopping 이고 남은 일이 없을 때만 종료함. (이미 받은 요청은 끝까지 처리)
+            }
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
+
+std::string AssetLoader::getCachePath(const std::string& path) {
+    return ofFilePath::removeExt(path) + ".texc";
+}
+
+//--------------------------------------------------------------
+std::shared_future<ofPixels> AssetLoader::loadPixels(const std::string& path) {
+    return enqueue<ofPixels>([path]() {
+        ofPixels pixels;
+        if (!ofLoadImage(pixels, path)) {
+            ofLogError("AssetLoader") << "loadPixels(): cannot load " << path;
+        }
+        return pixels;
+    });
+}
+
+std::shared_future<TextureDataPtr> AssetLoader::loadTexture(const std::string& path, int mipLevels) {
+    return enqueue<TextureDataPtr>([path, mipLevels]() -> TextureDataPtr {
+        std::string cachePath = getCachePath(path);
+        // 초 단위로 비교하면 같은 초 안에 PNG 를 고쳐 저장했을 때 오래된 캐시를 그대로 쓰게 되므로, 나노초 수정 시각으로 비교함.
+        if (getModifiedTime(cachePath) >= getModifiedTime(path)) {
+            std::shared_ptr<TextureData> cached = mapCache(cachePath, mipLevels);
+            if (cached) {
+                return cached;
+            }
+        }
+
+        ofPixels pixels;
+        if (!ofLoadImage(pixels, path)) {
+            ofLogError("AssetLoader") << "loadTexture(): cannot load " << path;
+            return nullptr;
+        }
+        std::shared_ptr<TextureData> data = buildTextureData(pixels, mipLevels);
+        if (!writeCache(cachePath, *data)) {
+            ofLogWarning("AssetLoader") << "loadTexture(): cannot write cache " << cachePath;
+        }
+        return data;
+    });
+}
+
+std::shared_future<TextureDataPtr> AssetLoader::storeTexture(const std::string& path, const ofPixels& pixels, int mipLevels) {
+    return enqueue<TextureDataPtr>([path, pixels, mipLevels]() -> TextureDataPtr {
+        std::shared_ptr<TextureData> data = buildTextureData(pixels, mipLevels);
+        if (!writeCache(getCachePath(path), *data)) {
+            ofLogWarning("AssetLoader") << "storeTexture(): cannot write cache " << getCachePath(path);
+        }
+        return data;
+    });
+}
+
+//--------------------------------------------------------------
+void loadTextureData(ofTexture& texture, const TextureData& data) {
+    const TextureLevel& base = data.levels[0];
+    texture.allocate(base.width, base.height, GL_RGBA8, false, GL_RGBA, GL_UNSIGNED_BYTE);
+    texture.loadData(base.data, base.width, base.height, GL_RGBA);
+
+    ofTextureData& texData = texture.getTextureData();
+    glBindTexture(texData.textureTarget, texData.textureID);
+    for (size_t i = 1; i < data.levels.size(); ++i) {
+        const TextureLevel& level = data.levels[i];
+        glTexImage2D(texData.textureTarget, (GLint)i, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.data);
+    }
+    glTexParameteri(texData.textureTarget, GL_TEXTURE_MAX_LEVEL, (GLint)data.levels.size() - 1);
+    glBindTexture(texData.textureTarget, 0);
+
+    if (data.levels.size() > 1) {
+        texData.hasMipmap = true;
+        texture.setTextureMinMagFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "ofMain.h"
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+/**
+ 이미지 디코딩을 워커 스레드들에서 병렬로 처리하고, 디코딩 결과를 캐시 파일로 남겨두는 에셋 로더.
+
+ - load*() 함수들은 바로 리턴하고 std::shared_future 를 돌려주므로, setup() 은 셰이더 로드, 메쉬 생성 같은
+   다른 일을 계속하다가 결과가 필요한 시점에 get() 으로 받으면 됨.
+ - loadTexture() 는 PNG 옆에 <이름>.texc 캐시 파일을 만들어 둠. 캐시 파일에는 밉맵 레벨별 8비트 RGBA 픽셀이
+   업로드할 순서 그대로 (첫 번째 행 = v 0, 셰이더의 fragUV 기준으로 이미 뒤집혀 있는 상태) 들어있어서,
+   다음 실행부터는 PNG 를 디코딩하지 않고 파일을 메모리 맵(mmap) 해서 바로 텍스쳐로 업로드함.
+   캐시 파일이 PNG 보다 오래됐거나 밉맵 레벨 수가 다르면 다시 만듦.
+ - GL 호출은 메인 스레드에서만 할 수 있으므로, 워커 스레드는 픽셀 데이터까지만 준비하고
+   GL 텍스쳐 업로드는 loadTextureData() 로 메인 스레드에서 함.
+
+ 캐시 파일 형식 (리틀 엔디언)
+   char[4]  "TXC1"
+   uint32   밉맵 레벨 수
+     uint32 width, uint32 height, uint64 데이터 시작 위치 (레벨마다, 데이터는 16 바이트 정렬)
+   ...      레벨별 RGBA 픽셀 데이터
+ */
+
+// 읽기 전용으로 메모리 맵한 파일. 소멸될 때 매핑을 해제함.
+class MappedFile {
+    public:
+        MappedFile() {}
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& path);
+        void close();
+
+        const unsigned char* data() const { return bytes; }
+        size_t size() const { return length; }
+
+    private:
+        const unsigned char* bytes = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        std::vector<unsigned char> buffer; // 윈도우에서는 메모리 맵 대신 파일 전체를 읽어둠.
+#endif
+};
+
+struct TextureLevel {
+    int width, height;
+    const unsigned char* data; // width * height * 4 바이트 RGBA
+};
+
+// 밉맵 레벨들까지 준비된 RGBA 텍스쳐 데이터. 캐시 파일에서 읽었으면 levels 는 메모리 맵된 영역을 가리킴.
+struct TextureData {
+    std::vector<TextureLevel> levels;
+    bool fromCache = false;
+
+    int getWidth() const { return levels.empty() ? 0 : levels[0].width; }
+    int getHeight() const { return levels.empty() ? 0 : levels[0].height; }
+
+    // 복사 없이 해당 레벨의 데이터를 가리키는 ofPixels (읽기 전용으로만 사용해야 함)
+    ofPixels wrapLevel(int level = 0) const;
+
+    std::shared_ptr<MappedFile> mapping;
+    std::vector<std::vector<unsigned char>> storage; // 직접 디코딩한 경우 레벨별 데이터
+};
+
+typedef std::shared_ptr<const TextureData> TextureDataPtr;
+
+class AssetLoader {
+    public:
+        // numThreads 가 0 이면 (하드웨어 스레드 개수 - 1) 개를 사용함. (메인 스레드 몫 하나를 남겨둠)
+        explicit AssetLoader(int numThreads = 0);
+        ~AssetLoader();
+
+        // PNG 등의 이미지를 디코딩만 해서 돌려줌. 실패하면 할당되지 않은 ofPixels
+        std::shared_future<ofPixels> loadPixels(const std::string& path);
+
+        // 캐시 파일이 최신이면 메모리 맵해서, 아니면 이미지를 디코딩하고 밉맵을 만든 뒤 캐시 파일을 써서 돌려줌. 실패하면 nullptr
+        std::shared_future<TextureDataPtr> loadTexture(const std::string& path, int mipLevels);
+
+        // 이미 메모리에 있는 픽셀로 밉맵을 만들고 path 의 캐시 파일을 써둠. (방금 만든 아틀라스 페이지처럼 다시 디코딩할 필요가 없는 경우)
+        std::shared_future<TextureDataPtr> storeTexture(const std::string& path, const ofPixels& pixels, int mipLevels);
+
+        int getNumThreads() const { return (int)workers.size(); }
+
+        static std::string getCachePath(const std::string& path);
+
+        // 그 밖에 메인 스레드를 막지 않아야 하는 일(장면 캐시 저장 등)을 워커 스레드에서 실행함.
+        template <class T>
+        std::shared_future<T> enqueue(std::function<T()> job);
+
+    private:
+
+        void workerLoop();
+
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> jobs;
+        std::mutex jobsMutex;
+        std::condition_variable jobsChanged;
+        bool stopping = false;
+};
+
+// 밉맵 레벨까지 포함해서 GL 텍스쳐로 업로드함. (메인 스레드에서만 호출)
+void loadTextureData(ofTexture& texture, const TextureData& data);
+
+//--------------------------------------------------------------
+template <class T>
+std::shared_future<T> AssetLoader::enqueue(std::function<T()> job) {
+    // packaged_task 는 복사할 수 없으므로 shared_ptr 로 감싸서 std::function 에 넣음.
+    auto task = std::make_shared<std::packaged_task<T()>>(job);
+    std::shared_future<T> result = task->get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        jobs.push([task]() { (*task)(); });
+    }
+    jobsChanged.notify_one();
+    return result;
+}
@@ -0,0 +1,1257 @@
+#include "benchmarks.h"
+#include "ofApp.h"
+#include "transformBatch.h"
+#include "transformHierarchy.h"
+#include "spriteCulling.h"
+#include "textureAtlas.h"
+#include "assetLoader.h"
+#include "sceneFile.h"
+#include "simulation.h"
+#include "frameProfiler.h"
+#include "spriteBatch.h"
+#include "walkerAnimation.h"
+#include <chrono>
+#include <functional>
+#include <iterator>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// fn 을 repeats 번 돌려서 가장 빠른 한 번의 시간(초)을 리턴함. 처음 한 번은 캐시를 데우는 용도로 시간에서 뺌.
+double bestOf(int repeats, const std::function<void()>& fn) {
+    fn();
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++i) {
+        Clock::time_point start = Clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+// 오브젝트 수가 많을수록 반복 횟수를 줄여서 벤치마크 하나가 몇 초 안에 끝나도록 함.
+int repeatsFor(size_t count) {
+    return count >= 1000000 ? 5 : count >= 100000 ? 20 : 200;
+}
+
+float maxAbsDiff(const glm::mat4& a, const glm::mat4& b) {
+    float diff = 0.0f;
+    for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 4; ++row) {
+            diff = std::max(diff, std::abs(a[col][row] - b[col][row]));
+        }
+    }
+    return diff;
+}
+
+//--------------------------------------------------------------
+/**
+ transformBatch.h 의 buildMatrices() 를 이전 방식(오브젝트마다 buildMatrix() + inverse())과 비교함.
+
+ 이전 방식은 오브젝트마다 위치, 회전, 크기를 구조체 하나에 담은 AoS 배열을 읽고,
+ buildMatrices() 는 같은 값을 성분별 배열(SoA)로 담아서 한꺼번에 계산함.
+ 두 결과의 최대 오차가 허용 범위를 넘으면 실패로 처리함.
+ */
+int benchTransform() {
+    struct TransformAoS {
+        glm::vec3 trans;
+        float rot;
+        glm::vec3 scale;
+    };
+    const float tolerance = 1e-4f; // inverse() 는 일반 4*4 역행렬 계산이라 닫힌 형태보다 오차가 조금 더 큼
+    bool passed = true;
+
+    for (size_t count : { (size_t)1000, (size_t)100000, (size_t)1000000 }) {
+        ofSeedRandom(1001);
+        std::vector<TransformAoS> aos(count);
+        TransformSoA soa;
+        soa.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            float scale = ofRandom(0.25, 2.0);
+            aos[i].trans = glm::vec3(ofRandom(-2, 2), ofRandom(-2, 2), ofRandom(-1, 0));
+            aos[i].rot = ofRandom(-TWO_PI, TWO_PI);
+            aos[i].scale = glm::vec3(scale, scale * ofRandom(0.5, 1.5), 1.0f);
+            soa.set(i, aos[i].trans, aos[i].rot, aos[i].scale);
+        }
+
+        std::vector<glm::mat4> refModel(count), refInverse(count), model(count), inverse(count);
+        int repeats = repeatsFor(count);
+        double perCall = bestOf(repeats, [&]() {
+            for (size_t i = 0; i < count; ++i) {
+                refModel[i] = buildMatrix(aos[i].trans, aos[i].rot, aos[i].scale);
+                refInverse[i] = glm::inverse(refModel[i]);
+            }
+        });
+        double batched = bestOf(repeats, [&]() {
+            buildMatrices(soa, model.data(), inverse.data());
+        });
+
+        float modelError = 0.0f, inverseError = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            modelError = std::max(modelError, maxAbsDiff(model[i], refModel[i]));
+            inverseError = std::max(inverseError, maxAbsDiff(inverse[i], refInverse[i]));
+        }
+        passed = passed && modelError <= tolerance && inverseError <= tolerance;
+
+        ofLogNotice("bench") << "transform: " << count << " objects, buildMatrix + inverse (AoS) " << ofToString(perCall * 1e9 / count, 2) << " ns/object"
+            << ", buildMatrices (SoA) " << ofToString(batched * 1e9 / count, 2) << " ns/object, speedup " << ofToString(perCall / batched, 2) << "x"
+            << ", max error model " << modelError << " / inverse " << inverseError;
+    }
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ TransformHierarchy::update() 시간을 dirty 노드 수에 따라 측정함.
+
+ 루트 하나 아래에 그룹 노드들이 있고, 그룹마다 스프라이트 노드 100 개가 붙은 장면을 만든 뒤,
+ 무작위로 고른 스프라이트 노드 k 개의 회전값을 바꾸고 update() 에 걸린 시간을 잼.
+ 마지막 줄은 루트 노드를 바꿔서 모든 노드를 다시 계산하는 경우임.
+
+ dirty 노드가 적을 때 시간이 전체 노드 수와 상관없이 dirty 노드 수에 비례해야 함.
+ update() 로 구한 월드행렬이 처음부터 전부 다시 곱한 결과와 다르거나, 바뀐 노드가 없는 update() 뒤의 노드 수가 0 이 아니면 실패로 처리함.
+ */
+int benchHierarchy() {
+    const int groupSize = 100;
+    bool passed = true;
+
+    for (int count : { 10000, 100000, 1000000 }) {
+        TransformHierarchy hierarchy;
+        std::vector<int> leaves;
+        int root = hierarchy.addNode(TransformHierarchy::NO_PARENT, glm::vec3(0, 0, 0));
+        ofSeedRandom(1003);
+        while ((int)hierarchy.size() < count) {
+            int group = hierarchy.addNode(root, glm::vec3(ofRandom(-1, 1), ofRandom(-1, 1), 0), ofRandom(TWO_PI));
+            for (int i = 0; i < groupSize && (int)hierarchy.size() < count; ++i) {
+                leaves.push_back(hierarchy.addNode(group, glm::vec3(ofRandom(-0.5, 0.5), ofRandom(-0.5, 0.5), ofRandom(-1, 0)), ofRandom(TWO_PI)));
+            }
+        }
+        hierarchy.update();
+
+        std::string report;
+        float angle = 0.0f;
+        for (int dirtyCount : { 1, 10, 100, 1000, 10000, -1 }) {
+            if (dirtyCount > (int)leaves.size()) {
+                continue;
+            }
+            const int repeats = 20;
+            double best = std::numeric_limits<double>::max();
+            for (int r = 0; r < repeats; ++r) {
+                angle += 0.01f;
+                if (dirtyCount < 0) {
+                    hierarchy.setRotation(root, angle);
+                } else {
+                    for (int k = 0; k < dirtyCount; ++k) {
+                        hierarchy.setRotation(leaves[(size_t)ofRandom(leaves.size())], angle);
+                    }
+                }
+                Clock::time_point start = Clock::now();
+                hierarchy.update();
+                best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+            }
+            report += "\n    " + (dirtyCount < 0 ? std::string("root dirty") : ofToString(dirtyCount) + " dirty") + ": " + ofToString(best * 1e6, 1) + " us, "
+                + ofToString(hierarchy.getLastUpdateCount()) + " updated / " + ofToString(hierarchy.getLastVisitCount()) + " visited nodes";
+        }
+
+        // getUpdatedNodes() 는 wasUpdated() 가 true 인 노드들과 같아야 함. (마지막 경우는 루트가 바뀌었으므로 전체 노드)
+        size_t wasUpdatedCount = 0;
+        for (size_t i = 0; i < hierarchy.size(); ++i) {
+            wasUpdatedCount += hierarchy.wasUpdated((int)i);
+        }
+        const std::vector<int>& updated = hierarchy.getUpdatedNodes();
+        bool updatedList = wasUpdatedCount == updated.size() && std::all_of(updated.begin(), updated.end(), [&](int node) { return hierarchy.wasUpdated(node); });
+        passed = passed && updatedList;
+        report += updatedList ? "" : "\n    getUpdatedNodes() differs from wasUpdated()";
+
+        // 바뀐 노드가 없는 update() 는 지난 update() 의 수를 남기지 않고 0 을 리턴해야 함.
+        hierarchy.update();
+        bool idle = hierarchy.getLastUpdateCount() == 0 && hierarchy.getLastVisitCount() == 0;
+        passed = passed && idle;
+        report += idle ? "" : "\n    update() with nothing dirty reports stale counts";
+
+        // 처음부터 전부 곱한 월드행렬과 비교함. (로컬행렬은 update() 가 계산해둔 값을 그대로 사용)
+        std::vector<glm::mat4> world(hierarchy.size());
+        for (size_t i = 0; i < hierarchy.size(); ++i) {
+            int parent = hierarchy.getParent((int)i);
+            world[i] = parent == TransformHierarchy::NO_PARENT ? hierarchy.getLocalMatrix((int)i) : world[parent] * hierarchy.getLocalMatrix((int)i);
+            passed = passed && world[i] == hierarchy.getWorldMatrix((int)i);
+        }
+
+        ofLogNotice("bench") << "hierarchy: " << hierarchy.size() << " nodes, update() time by dirty sprite nodes" << report;
+    }
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ spriteCulling.h 의 프러스텀 컬링을 넓은 월드에서 측정함.
+
+ 100 * 100 (그리고 스프라이트가 셀마다 수천 개씩 몰리는 4 * 4) 크기의 월드에 캐릭터 크기의 스프라이트들을 무작위로 흩어놓고 (z 가 0 보다 커서 near 평면 앞에 있는 것도 섞음),
+ forest.scene 과 같은 직교투영 카메라를 월드 여러 곳에 둔 뒤 한 화면당 컬링 시간을 잼.
+ - brute force: 모든 스프라이트를 프러스텀 평면 6개로 검사
+ - grid: ofApp::draw() 처럼 SpatialGrid 에서 프러스텀을 감싸는 셀의 스프라이트만 가져와서 평면 검사
+
+ 그 다음 스프라이트의 10% 가 매 프레임 조금씩 움직일 때, 월드 범위를 다시 구하고 격자를 갱신하는 비용을
+ 움직인 스프라이트 하나당 시간으로 재고, 격자를 처음부터 다시 만드는 비용과 비교함.
+ 격자로 컬링한 결과가 brute force 결과와 다르면 실패로 처리함.
+ */
+int benchCulling() {
+    const float movingFraction = 0.1f;
+    const int moveFrames = 60;
+    const int views = 16;
+    const SpriteBounds local = quadBounds(0.1f, 0.2f, glm::vec3(0, -0.2f, 0)); // forest.scene 의 character 메쉬
+    const glm::mat4 proj = glm::ortho(-1.33f, 1.33f, -1.0f, 1.0f, 0.0f, 10.0f);
+    bool passed = true;
+
+    // 마지막 경우는 군중처럼 셀 몇 개에 스프라이트가 수천 개씩 몰려 있는 장면 (셀 목록이 길어도 격자 갱신 비용이 그대로인지 확인)
+    for (std::pair<int, float> world : { std::make_pair(10000, 100.0f), std::make_pair(100000, 100.0f), std::make_pair(1000000, 100.0f), std::make_pair(100000, 4.0f) }) {
+        const int count = world.first;
+        const float worldSize = world.second;
+        ofSeedRandom(1005);
+        std::vector<glm::vec3> positions(count);
+        std::vector<float> rotations(count);
+        std::vector<SpriteBounds> bounds(count);
+        std::vector<int> handles(count);
+        SpatialGrid grid;
+        for (int i = 0; i < count; ++i) {
+            positions[i] = glm::vec3(ofRandom(-worldSize / 2, worldSize / 2), ofRandom(-worldSize / 2, worldSize / 2), ofRandom(-2, 0.5));
+            rotations[i] = ofRandom(TWO_PI);
+            bounds[i] = transformBounds(local, buildMatrix(positions[i], rotations[i], glm::vec3(1, 1, 1)));
+            handles[i] = grid.insert(bounds[i], i);
+        }
+
+        std::vector<ViewFrustum> frustums;
+        for (int v = 0; v < views; ++v) {
+            CameraData cam;
+            cam.position = glm::vec3(ofRandom(-worldSize / 2, worldSize / 2), ofRandom(-worldSize / 2, worldSize / 2), 0);
+            cam.rotation = ofRandom(-0.3, 0.3);
+            frustums.push_back(extractFrustum(proj * buildViewMatrix(cam)));
+        }
+
+        std::vector<int> visible, candidates, reference;
+        auto bruteForce = [&](const ViewFrustum& frustum, std::vector<int>& out) {
+            out.clear();
+            for (int i = 0; i < count; ++i) {
+                if (intersects(frustum, bounds[i])) {
+                    out.push_back(i);
+                }
+            }
+        };
+        auto gridCull = [&](const ViewFrustum& frustum, std::vector<int>& out) {
+            candidates.clear();
+            out.clear();
+            grid.query(frustum.bounds, candidates);
+            for (int index : candidates) {
+                if (intersects(frustum, bounds[index])) {
+                    out.push_back(index);
+                }
+            }
+        };
+        /**
+         평면 검사는 보수적이라서 회전한 프러스텀의 모서리 근처에 있는 박스는 실제로 겹치지 않아도 통과할 수 있고,
+         격자는 프러스텀을 감싸는 AABB 에 걸친 셀 단위로 조회하므로 이런 박스 중 일부만 결과에 들어감.
+         그래서 격자 결과가 brute force 결과에 포함되고, 프러스텀 AABB 와 겹치는 brute force 결과는 빠짐없이 격자 결과에 있는지 확인함.
+         */
+        auto overlaps = [](const SpriteBounds& a, const SpriteBounds& b) {
+            return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+        };
+        auto verify = [&]() {
+            size_t visibleCount = 0, candidateCount = 0;
+            for (const ViewFrustum& frustum : frustums) {
+                bruteForce(frustum, reference);
+                gridCull(frustum, visible);
+                std::sort(visible.begin(), visible.end());
+                passed = passed && std::includes(reference.begin(), reference.end(), visible.begin(), visible.end());
+                reference.erase(std::remove_if(reference.begin(), reference.end(), [&](int i) { return !overlaps(bounds[i], frustum.bounds); }), reference.end());
+                passed = passed && std::includes(visible.begin(), visible.end(), reference.begin(), reference.end());
+                visibleCount += visible.size();
+                candidateCount += candidates.size();
+            }
+            return std::make_pair(visibleCount, candidateCount);
+        };
+
+        std::pair<size_t, size_t> counts = verify();
+        int repeats = std::max(3, repeatsFor(count) / 10);
+        double bruteTime = bestOf(repeats, [&]() {
+            for (const ViewFrustum& frustum : frustums) {
+                bruteForce(frustum, reference);
+            }
+        });
+        double gridTime = bestOf(repeats, [&]() {
+            for (const ViewFrustum& frustum : frustums) {
+                gridCull(frustum, visible);
+            }
+        });
+
+        // 움직이는 스프라이트: 매 프레임 같은 방향으로 조금씩 이동하고 회전함. (시간은 범위 계산 + 격자 갱신만 잼)
+        int movingCount = (int)(count * movingFraction);
+        std::vector<glm::vec3> velocities(movingCount);
+        for (glm::vec3& velocity : velocities) {
+            velocity = glm::vec3(ofRandom(-0.02, 0.02), ofRandom(-0.02, 0.02), 0);
+        }
+        double moveTime = 0.0;
+        size_t cellChanges = 0;
+        for (int frame = 0; frame < moveFrames; ++frame) {
+            for (int i = 0; i < movingCount; ++i) {
+                positions[i] += velocities[i];
+                rotations[i] += 0.01f;
+            }
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < movingCount; ++i) {
+                SpriteBounds moved = transformBounds(local, buildMatrix(positions[i], rotations[i], glm::vec3(1, 1, 1)));
+                cellChanges += std::floor(moved.min.x) != std::floor(bounds[i].min.x) || std::floor(moved.min.y) != std::floor(bounds[i].min.y)
+                    || std::floor(moved.max.x) != std::floor(bounds[i].max.x) || std::floor(moved.max.y) != std::floor(bounds[i].max.y);
+                bounds[i] = moved;
+                grid.update(handles[i], moved);
+            }
+            moveTime += std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        double rebuildTime = bestOf(3, [&]() {
+            SpatialGrid rebuilt;
+            for (int i = 0; i < count; ++i) {
+                rebuilt.insert(bounds[i], i);
+            }
+        });
+        verify(); // 움직인 뒤에도 격자 조회 결과가 정확해야 함.
+
+        double total = (double)count * views;
+        ofLogNotice("bench") << "culling: " << count << " sprites in " << worldSize << " x " << worldSize << ", " << views << " views"
+            << "\n    visible " << ofToString(counts.first * 100.0 / total, 3) << "%, culled " << ofToString(100.0 - counts.first * 100.0 / total, 3) << "%"
+            << ", grid candidates " << ofToString(counts.second * 100.0 / total, 3) << "% (" << ofToString(counts.first * 100.0 / std::max<size_t>(counts.second, 1), 1) << "% of them visible)"
+            << "\n    brute force " << ofToString(bruteTime * 1e6 / views, 1) << " us/view, grid " << ofToString(gridTime * 1e6 / views, 1) << " us/view, speedup " << ofToString(bruteTime / gridTime, 1) << "x"
+            << "\n    " << movingCount << " moving sprites: bounds + grid update " << ofToString(moveTime * 1e9 / ((double)movingCount * moveFrames), 1) << " ns/sprite ("
+            << ofToString(moveTime * 1e3 / moveFrames, 3) << " ms/frame), cell range changed for " << ofToString(cellChanges * 100.0 / ((double)movingCount * moveFrames), 2) << "%"
+            << ", full grid rebuild " << ofToString(rebuildTime * 1e3, 3) << " ms";
+    }
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ TextureAtlas::build() 의 배치 결과를 검사하고 시간을 잼.
+
+ 크기가 제각각인 이미지 300 개(RGB, RGBA 섞어서)와 스프라이트시트 하나, 페이지보다 큰 이미지 하나를 1024 크기 페이지들에 넣음.
+ - packing efficiency: 페이지 넓이 중 이미지가 차지하는 비율이 기준값보다 작으면 실패
+ - uv round trip: 프레임마다 uv 사각형을 페이지 픽셀 좌표로 되돌렸을 때 정확히 픽셀 경계에 맞고,
+   그 영역의 픽셀이 원본 이미지(스프라이트시트는 해당 프레임)와 같고, 패딩은 가장자리 픽셀로 채워져 있어야 함.
+ - save() 한 디스크립터를 load() 했을 때 프레임 정보가 build() 결과와 같아야 함.
+ - 페이지에 안 들어가는 이미지는 건너뛰고 findFrame() 이 -1 을 리턴해야 함.
+ */
+int benchAtlas() {
+    const int pageSize = 1024;
+    const float minEfficiency = 0.75f;
+    bool passed = true;
+
+    // 좌표와 이미지 번호로 정해지는 픽셀 값이라서, 엉뚱한 위치를 복사하면 바로 드러남.
+    auto texel = [](size_t source, int x, int y, int c) {
+        return (unsigned char)((source * 131 + x * 7 + y * 13 + c * 61) & 0xFF);
+    };
+    auto makeSource = [&](size_t index, int w, int h, bool alpha) {
+        AtlasSource source;
+        source.name = "source_" + ofToString(index);
+        source.pixels.allocate(w, h, alpha ? OF_PIXELS_RGBA : OF_PIXELS_RGB);
+        size_t channels = source.pixels.getNumChannels();
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                for (size_t c = 0; c < channels; ++c) {
+                    source.pixels.getData()[((size_t)y * w + x) * channels + c] = texel(index, x, y, (int)c);
+                }
+            }
+        }
+        return source;
+    };
+
+    ofSeedRandom(1006);
+    std::vector<AtlasSource> sources;
+    for (size_t i = 0; i < 300; ++i) {
+        sources.push_back(makeSource(i, (int)ofRandom(8, 160), (int)ofRandom(8, 160), i % 3 != 0));
+    }
+    AtlasSource sheet = makeSource(sources.size(), 96, 64, true); // 3 * 2 칸에 5 프레임
+    sheet.frameSize = glm::vec2(1.0f / 3, 1.0f / 2);
+    sheet.columns = 3;
+    sheet.frameCount = 5;
+    sources.push_back(sheet);
+    sources.push_back(makeSource(sources.size(), pageSize + 1, 16, true)); // 페이지보다 커서 들어가지 않는 이미지
+
+    TextureAtlas atlas;
+    double buildTime = bestOf(5, [&]() {
+        atlas.build(sources, pageSize);
+    });
+    float efficiency = atlas.getPackingEfficiency();
+    passed = passed && efficiency >= minEfficiency;
+    passed = passed && atlas.findFrame(sources.back().name) == -1;
+
+    size_t checkedFrames = 0, mismatchedFrames = 0;
+    for (size_t i = 0; i + 1 < sources.size(); ++i) {
+        const AtlasSource& source = sources[i];
+        int first = atlas.findFrame(source.name);
+        if (first < 0 || atlas.getFrameCount(source.name) != source.frameCount) {
+            mismatchedFrames++;
+            continue;
+        }
+        size_t channels = source.pixels.getNumChannels();
+        int frameW = (int)std::round(source.frameSize.x * source.pixels.getWidth());
+        int frameH = (int)std::round(source.frameSize.y * source.pixels.getHeight());
+        for (int f = 0; f < source.frameCount; ++f) {
+            checkedFrames++;
+            const AtlasFrame& frame = atlas.getFrame(first + f);
+            const ofPixels& page = atlas.getPages()[frame.page];
+            glm::vec4 rect = frame.uvRect * glm::vec4(page.getWidth(), page.getHeight(), page.getWidth(), page.getHeight());
+            int x0 = (int)std::round(rect.x), y0 = (int)std::round(rect.y);
+            bool ok = std::abs(rect.x - x0) < 1e-3f && std::abs(rect.y - y0) < 1e-3f
+                && std::abs(rect.z - frameW) < 1e-3f && std::abs(rect.w - frameH) < 1e-3f;
+            int srcX0 = (f % source.columns) * frameW, srcY0 = (f / source.columns) * frameH;
+
+            // 프레임 영역 + 이미지 전체 가장자리의 패딩. 패딩 픽셀은 원본의 가장 가까운 픽셀과 같아야 함.
+            int padLeft = f % source.columns == 0 ? TextureAtlas::PADDING : 0;
+            int padTop = f / source.columns == 0 ? TextureAtlas::PADDING : 0;
+            int padRight = srcX0 + frameW == (int)source.pixels.getWidth() ? TextureAtlas::PADDING : 0;
+            int padBottom = srcY0 + frameH == (int)source.pixels.getHeight() ? TextureAtlas::PADDING : 0;
+            for (int y = -padTop; ok && y < frameH + padBottom; ++y) {
+                for (int x = -padLeft; ok && x < frameW + padRight; ++x) {
+                    int sx = srcX0 + std::min(std::max(x, 0), frameW - 1);
+                    int sy = srcY0 + std::min(std::max(y, 0), frameH - 1);
+                    const unsigned char* p = page.getData() + ((size_t)(y0 + y) * page.getWidth() + (x0 + x)) * 4;
+                    for (int c = 0; c < 4; ++c) {
+                        int expected = c < 3 || channels == 4 ? texel(i, sx, sy, c) : 255;
+                        ok = ok && p[c] == expected;
+                    }
+                }
+            }
+            mismatchedFrames += ok ? 0 : 1;
+        }
+    }
+    passed = passed && mismatchedFrames == 0;
+
+    // 디스크립터 저장 -> 로드한 결과가 build() 결과와 같은지 확인하고 파일은 지움.
+    const std::string descriptor = "bench_atlas.bin";
+    TextureAtlas loaded;
+    bool roundTrip = atlas.save(descriptor) && loaded.load(descriptor) && loaded.getNumFrames() == atlas.getNumFrames() && loaded.getNumPages() == atlas.getNumPages();
+    for (size_t f = 0; roundTrip && f < atlas.getNumFrames(); ++f) {
+        roundTrip = loaded.getFrame((int)f).page == atlas.getFrame((int)f).page && loaded.getFrame((int)f).uvRect == atlas.getFrame((int)f).uvRect;
+    }
+    for (size_t i = 0; roundTrip && i < sources.size(); ++i) {
+        roundTrip = loaded.findFrame(sources[i].name) == atlas.findFrame(sources[i].name) && loaded.getFrameCount(sources[i].name) == atlas.getFrameCount(sources[i].name);
+    }
+    passed = passed && roundTrip;
+    ofFile::removeFile(descriptor);
+    for (size_t p = 0; p < atlas.getNumPages(); ++p) {
+        ofFile::removeFile(TextureAtlas::getPagePath(descriptor, p));
+    }
+
+    ofLogNotice("bench") << "atlas: " << sources.size() << " images -> " << atlas.getNumPages() << " pages of " << pageSize << ", " << atlas.getNumFrames() << " frames, build "
+        << ofToString(buildTime * 1e3, 2) << " ms, packing efficiency " << ofToString(efficiency, 3) << " (min " << minEfficiency << ")"
+        << ", uv round trip " << (checkedFrames - mismatchedFrames) << " / " << checkedFrames << " frames exact"
+        << ", descriptor save/load " << (roundTrip ? "matches" : "DIFFERS");
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ 시작할 때 텍스쳐를 준비하는 시간을 세 가지 경로로 비교함. 텍스쳐 목록은 forest.scene 에서 읽음.
+
+ - serial ofImage::load: 아틀라스와 에셋 로더를 만들기 전처럼 PNG 를 하나씩 차례로 디코딩함.
+   (GL 컨텍스트 없이 돌리므로 ofImage::load() 에서 텍스쳐 업로드를 뺀 ofLoadImage() 로 잼)
+ - cold cache: 아틀라스 디스크립터와 .texc 캐시가 없을 때. PNG 들을 병렬로 디코딩해서 아틀라스를 만들고 저장한 뒤 밉맵과 캐시를 만듦.
+ - warm cache: 디스크립터와 캐시가 최신일 때. 디스크립터를 읽고 페이지 캐시를 메모리 맵함.
+ (ofApp::setupAtlas() 와 같은 순서이고, 앱의 캐시를 건드리지 않도록 다른 이름의 디스크립터를 사용함)
+
+ warm cache 로 읽은 페이지 데이터가 cold cache 에서 만든 데이터와 다르면 실패로 처리함.
+ */
+int benchStartup() {
+    const std::string sceneFile = "forest.scene";
+    const std::string descriptor = "bench_startup_atlas.bin";
+    const int mipLevels = 2; // ofApp::setupAtlas() 와 같은 값
+    SceneHeader header;
+    std::vector<SceneSpriteDesc> sprites;
+    if (!SceneLoader::load(sceneFile, header, sprites)) {
+        ofLogError("bench") << "startup: cannot load " << sceneFile;
+        return 1;
+    }
+    std::vector<std::string> files;
+    for (const SceneTextureDesc& texture : header.textures) {
+        files.push_back(texture.file);
+    }
+
+    auto removeCache = [&]() {
+        TextureAtlas previous;
+        if (previous.load(descriptor)) {
+            for (size_t p = 0; p < previous.getNumPages(); ++p) {
+                ofFile::removeFile(TextureAtlas::getPagePath(descriptor, p));
+                ofFile::removeFile(AssetLoader::getCachePath(TextureAtlas::getPagePath(descriptor, p)));
+            }
+        }
+        ofFile::removeFile(descriptor);
+    };
+
+    size_t decodedBytes = 0;
+    double serial = bestOf(3, [&]() {
+        decodedBytes = 0;
+        for (const std::string& file : files) {
+            ofPixels pixels;
+            ofLoadImage(pixels, file);
+            decodedBytes += pixels.size();
+        }
+    });
+
+    AssetLoader loader;
+    std::vector<TextureDataPtr> coldPages, warmPages;
+    double cold = bestOf(3, [&]() {
+        removeCache();
+        std::vector<std::shared_future<ofPixels>> decodes;
+        for (const std::string& file : files) {
+            decodes.push_back(loader.loadPixels(file));
+        }
+        std::vector<AtlasSource> sources(files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            const SceneTextureDesc& texture = header.textures[i];
+            sources[i].name = texture.file;
+            sources[i].pixels = decodes[i].get();
+            sources[i].frameSize = texture.frameSize;
+            sources[i].columns = texture.columns;
+            sources[i].frameCount = texture.frameCount;
+        }
+        TextureAtlas atlas;
+        atlas.build(sources);
+        atlas.save(descriptor);
+        std::vector<std::shared_future<TextureDataPtr>> pages;
+        for (size_t p = 0; p < atlas.getNumPages(); ++p) {
+            pages.push_back(loader.storeTexture(TextureAtlas::getPagePath(descriptor, p), atlas.getPages()[p], mipLevels));
+        }
+        coldPages.clear();
+        for (auto& page : pages) {
+            coldPages.push_back(page.get());
+        }
+    });
+
+    bool warmUsedCache = true;
+    double warm = bestOf(10, [&]() {
+        TextureAtlas atlas;
+        if (isAtlasStale(descriptor, files) || !atlas.load(descriptor)) {
+            warmUsedCache = false;
+            return;
+        }
+        std::vector<std::shared_future<TextureDataPtr>> pages;
+        for (size_t p = 0; p < atlas.getNumPages(); ++p) {
+            pages.push_back(loader.loadTexture(TextureAtlas::getPagePath(descriptor, p), mipLevels));
+        }
+        warmPages.clear();
+        for (auto& page : pages) {
+            warmPages.push_back(page.get());
+            warmUsedCache = warmUsedCache && warmPages.back() && warmPages.back()->fromCache;
+        }
+    });
+
+    bool same = warmUsedCache && warmPages.size() == coldPages.size();
+    for (size_t p = 0; same && p < warmPages.size(); ++p) {
+        const TextureData& a = *warmPages[p];
+        const TextureData& b = *coldPages[p];
+        same = a.levels.size() == b.levels.size();
+        for (size_t l = 0; same && l < a.levels.size(); ++l) {
+            same = a.levels[l].width == b.levels[l].width && a.levels[l].height == b.levels[l].height
+                && memcmp(a.levels[l].data, b.levels[l].data, (size_t)a.levels[l].width * a.levels[l].height * 4) == 0;
+        }
+    }
+    warmPages.clear();
+    coldPages.clear();
+    removeCache();
+
+    ofLogNotice("bench") << "startup: " << files.size() << " textures from " << sceneFile << " (" << ofToString(decodedBytes / (1024.0 * 1024.0), 1) << " MB decoded), "
+        << loader.getNumThreads() << " loader threads"
+        << "\n    serial ofImage::load " << ofToString(serial * 1e3, 2) << " ms"
+        << "\n    cold cache (parallel decode + atlas build + mipmaps + cache write) " << ofToString(cold * 1e3, 2) << " ms"
+        << "\n    warm cache (descriptor + mapped page cache) " << ofToString(warm * 1e3, 3) << " ms, " << ofToString(serial / warm, 1) << "x faster than serial"
+        << (same ? "" : "\n    warm cache data DIFFERS from the cold build");
+    return same ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ 시뮬레이션 스레드의 틱 지터와 보간 지연시간을 재고, 입력 기록 파일로 결정적 재현이 되는지 확인함.
+
+ ofApp 처럼 60Hz 로 시뮬레이션을 돌리면서, 렌더 루프 대신 120Hz 로 sample() 하고 입력(오른쪽 걷기)을 주기적으로 바꿈.
+ 끝나면 기록을 파일로 저장했다가 다시 읽어서 replay() 한 최종 상태가 실제로 돌린 최종 상태와 비트 단위로 같은지 확인함.
+ (--replay 와 같은 경로. 파일을 거치면서 값이 조금이라도 바뀌어도 실패함)
+ */
+int benchSimulation() {
+    const double seconds = 3.0;
+    const double sampleRate = 120.0;
+    Simulation simulation;
+    simulation.start(60.0);
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point next = start;
+    for (int frame = 0; std::chrono::duration<double>(Clock::now() - start).count() < seconds; ++frame) {
+        SimInput input;
+        input.walkRight = (frame / 37) % 2 == 1; // 0.3초 정도마다 걷기를 켜고 끔
+        simulation.setInput(input);
+        simulation.sample();
+        next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / sampleRate));
+        std::this_thread::sleep_until(next);
+    }
+    simulation.stop();
+
+    const std::string path = "bench_simulation.simlog";
+    SimRecording recording = simulation.getRecording(), loaded;
+    bool passed = saveSimRecording(path, recording) && loadSimRecording(path, loaded) && verifySimRecording(loaded);
+    ofFile::removeFile(path);
+
+    SimTimingStats timing = simulation.getTimingStats();
+    ofLogNotice("bench") << "simulation: " << timing.ticks << " ticks in " << seconds << " s (expected " << (int)(seconds / simulation.getTickSeconds()) << "), "
+        << recording.inputs.size() << " input changes, replay from file " << (passed ? "matches" : "FAILED")
+        << "\n    tick jitter mean " << ofToString(timing.meanJitterMicros, 1) << " us / max " << ofToString(timing.maxJitterMicros, 1) << " us, "
+        << timing.lateTicks << " ticks late by more than " << Simulation::LATE_TICK_MICROS << " us"
+        << "\n    interpolation latency mean " << ofToString(timing.meanLatencyMicros, 1) << " us / max " << ofToString(timing.maxLatencyMicros, 1) << " us over " << timing.samples << " samples";
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ frameProfiler.h 의 링 버퍼, 중첩 깊이, summarizeFrames(), 크롬 trace JSON 출력을 확인함. (GL 컨텍스트가 필요 없음)
+
+ - 링 버퍼: 용량보다 많이 기록한 스레드의 트랙에 가장 최근 RING_CAPACITY 개만 순서대로 남는지
+ - 깊이: 중첩된 구간의 깊이, 시간 범위가 맞는지, MAX_DEPTH 보다 깊은 구간은 기록하지 않고 짝만 맞추는지
+ - 동시 읽기: 한 스레드가 계속 기록하는 동안 collect() 로 읽은 기록이 찢어지거나 빠지지 않는지
+ - summarizeFrames(), writeChromeTrace(): 직접 만든 기록으로 기대값과 비교함
+ 구간 하나(begin + end)를 기록하는 시간도 같이 출력함.
+ */
+int benchProfiler() {
+    const size_t capacity = FrameProfiler::RING_CAPACITY;
+    const int maxDepth = FrameProfiler::MAX_DEPTH;
+
+    // 링 버퍼가 몇 바퀴 돌도록 outer, inner 구간을 기록하고 스레드를 끝냄. (종료된 스레드의 트랙은 다음 collect() 에서 전부 읽고 지워짐)
+    FrameProfiler profiler;
+    const size_t iterations = capacity + 100; // 구간 2개씩이므로 약 2바퀴
+    double nsPerScope = 0.0;
+    std::thread writer([&]() {
+        profiler.setThreadName("writer");
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            profiler.beginFrame();
+            profiler.begin("outer");
+            profiler.begin("inner");
+            profiler.end();
+            profiler.end();
+        }
+        nsPerScope = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (iterations * 2);
+    });
+    writer.join();
+
+    std::vector<ProfileTrack> tracks = profiler.collect();
+    bool ringOk = tracks.size() == 1 && tracks[0].name == "writer" && tracks[0].events.size() == capacity;
+    for (size_t e = 0; ringOk && e < capacity; ++e) {
+        // 전체 기록 순서로 보면 e 번째 기록은 (iterations * 2 - capacity + e) 번째이고, 짝수 번째가 inner 임.
+        size_t n = iterations * 2 - capacity + e;
+        const ProfileEvent& event = tracks[0].events[e];
+        bool inner = n % 2 == 0;
+        ringOk = strcmp(event.name, inner ? "inner" : "outer") == 0 && event.depth == (inner ? 1 : 0) && event.frame == n / 2 + 1;
+        if (ringOk && !inner && e > 0) {
+            const ProfileEvent& child = tracks[0].events[e - 1];
+            ringOk = child.startNanos >= event.startNanos && child.startNanos + child.durationNanos <= event.startNanos + event.durationNanos;
+        }
+    }
+    ringOk = ringOk && profiler.collect().empty();
+
+    // MAX_DEPTH 보다 2단계 더 중첩함. 기록되는 건 깊이 0 ~ MAX_DEPTH - 1 뿐이고, 안쪽 구간부터 끝난 순서로 남아야 함.
+    FrameProfiler nested;
+    for (int d = 0; d < maxDepth + 2; ++d) {
+        nested.begin("nested");
+    }
+    for (int d = 0; d < maxDepth + 2; ++d) {
+        nested.end();
+    }
+    nested.end(); // 짝이 없는 end() 는 무시함
+    tracks = nested.collect();
+    bool depthOk = tracks.size() == 1 && tracks[0].events.size() == (size_t)maxDepth;
+    for (int d = 0; depthOk && d < maxDepth; ++d) {
+        depthOk = tracks[0].events[d].depth == maxDepth - 1 - d;
+    }
+    nested.clear();
+    depthOk = depthOk && nested.collect().empty();
+
+    // 기록하는 스레드가 seq 번째 기록에 seq 로 계산되는 값을 넣고, 읽는 쪽은 연속된 seq 인지, 값이 맞는지 확인함.
+    FrameProfiler concurrent;
+    int track = concurrent.createTrack("concurrent");
+    const uint32_t total = 2000000;
+    std::atomic<bool> finished(false);
+    std::thread producer([&]() {
+        for (uint32_t seq = 0; seq < total; ++seq) {
+            concurrent.addEvent(track, { "event", (int64_t)seq, (int64_t)seq * 3, seq, (uint16_t)(seq & 0xFF) });
+        }
+        finished = true;
+    });
+    size_t collects = 0, tornEvents = 0, readEvents = 0;
+    while (!finished) {
+        for (const ProfileTrack& t : concurrent.collect()) {
+            for (size_t e = 0; e < t.events.size(); ++e) {
+                const ProfileEvent& event = t.events[e];
+                uint32_t seq = (uint32_t)event.startNanos;
+                bool ok = event.durationNanos == (int64_t)seq * 3 && event.frame == seq && event.depth == (seq & 0xFF);
+                ok = ok && (e == 0 || seq == (uint32_t)t.events[e - 1].startNanos + 1);
+                tornEvents += ok ? 0 : 1;
+            }
+            readEvents += t.events.size();
+        }
+        collects++;
+    }
+    producer.join();
+    bool concurrentOk = tornEvents == 0 && collects > 0;
+
+    // 트랙 하나에 4프레임, 프레임마다 outer 2ms 하나와 inner 0.5ms 두 개를 넣고, 2 ~ 3 프레임만 요약함.
+    // 두 번째 inner 는 프레임마다 1us 씩 길게 해서, inner 의 max 가 구간 하나(0.503ms)가 아니라 프레임의 합(1.003ms)인지 확인함.
+    ProfileTrack mainTrack;
+    mainTrack.id = 1;
+    mainTrack.name = "main";
+    for (uint32_t f = 1; f <= 4; ++f) {
+        int64_t base = (int64_t)f * 10000000;
+        mainTrack.events.push_back({ "inner", base + 100000, 500000, f, 1 });
+        mainTrack.events.push_back({ "inner", base + 1000000, 500000 + (int64_t)f * 1000, f, 1 });
+        mainTrack.events.push_back({ "outer", base, 2000000 + f, f, 0 }); // 프레임마다 1ns 씩 길게 해서 max 를 확인함
+    }
+    std::vector<ProfileSummary> summary = summarizeFrames({ mainTrack }, 2, 3);
+    bool summaryOk = summary.size() == 2
+        && strcmp(summary[0].name, "outer") == 0 && summary[0].depth == 0 && summary[0].count == 2
+        && std::abs(summary[0].meanMillis - 2.0000025) < 1e-9 && std::abs(summary[0].maxMillis - 2.000003) < 1e-9
+        && strcmp(summary[1].name, "inner") == 0 && summary[1].depth == 1 && summary[1].count == 4
+        && std::abs(summary[1].meanMillis - 1.0025) < 1e-9 && std::abs(summary[1].maxMillis - 1.003) < 1e-9
+        && summarizeFrames({ mainTrack }, 3, 2).empty();
+
+    // 이스케이프가 필요한 트랙 이름과, 마이크로초 단위 변환을 확인함.
+    ProfileTrack escaped;
+    escaped.id = 7;
+    escaped.name = "gpu \"main\"\n\\";
+    escaped.events.push_back({ "draw", 1500, 2000000, 3, 0 });
+    std::ostringstream json;
+    writeChromeTrace({ mainTrack, escaped }, json);
+    std::string text = json.str();
+    size_t completeEvents = 0;
+    for (size_t pos = text.find("\"ph\":\"X\""); pos != std::string::npos; pos = text.find("\"ph\":\"X\"", pos + 1)) {
+        completeEvents++;
+    }
+    // 문자열 밖의 괄호 짝이 맞는지 확인함. (JSON 파서 대신 간단히 구조만 확인)
+    int braces = 0, brackets = 0;
+    bool inString = false, balanced = true;
+    for (size_t i = 0; i < text.size() && balanced; ++i) {
+        char c = text[i];
+        if (inString) {
+            if (c == '\\') i++;
+            else if (c == '"') inString = false;
+            else balanced = (unsigned char)c >= 0x20;
+        } else if (c == '"') inString = true;
+        else if (c == '{') braces++;
+        else if (c == '}') balanced = --braces >= 0;
+        else if (c == '[') brackets++;
+        else if (c == ']') balanced = --brackets >= 0;
+    }
+    bool jsonOk = balanced && !inString && braces == 0 && brackets == 0
+        && text.compare(0, 16, "{\"traceEvents\":[") == 0
+        && completeEvents == mainTrack.events.size() + escaped.events.size()
+        && text.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":7,\"args\":{\"name\":\"gpu \\\"main\\\"\\n\\\\\"}}") != std::string::npos
+        && text.find("{\"name\":\"draw\",\"ph\":\"X\",\"pid\":1,\"tid\":7,\"ts\":1.500,\"dur\":2000.000,\"args\":{\"frame\":3}}") != std::string::npos;
+
+    ofLogNotice("bench") << "profiler: " << ofToString(nsPerScope, 1) << " ns per scope"
+        << "\n    ring wrap " << (ringOk ? "keeps the newest " + ofToString(capacity) + " events" : "FAILED")
+        << ", depth limit " << (depthOk ? "ok" : "FAILED")
+        << ", concurrent collect " << (concurrentOk ? "ok" : "FAILED") << " (" << collects << " collects, " << readEvents << " events read, " << tornEvents << " torn)"
+        << ", summarizeFrames " << (summaryOk ? "ok" : "FAILED") << ", chrome trace json " << (jsonOk ? "ok" : "FAILED");
+    return ringOk && depthOk && concurrentOk && summaryOk && jsonOk ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ 반투명 패스를 깊이 정렬(TRANSPARENT_BACK_TO_FRONT)로 그릴 때와 OIT(TRANSPARENT_ORDER_INDEPENDENT)로 그릴 때의 CPU 비용을 비교함.
+
+ 겹치는 구름처럼 깊이가 제각각인 반투명 스프라이트를 셰이더 2개, 텍스쳐 4개, 메쉬 2개로 submit 하고,
+ SpriteBatch::build() 시간과 드로우콜, 상태 변경 수를 출력함. 깊이 정렬은 상태가 깊이 순서대로 뒤섞여서 드로우콜이 스프라이트 수에 가까워지고,
+ OIT 는 불투명 패스처럼 상태별로 묶이므로 드로우콜이 상태 조합 수만큼만 생김.
+ 셰이더 1 번은 OIT 용 셰이더가 없는 경우(setOrderDependentShader())로, OIT 모드에서도 SPRITE_PASS_TRANSPARENT_SORTED 로 깊이 정렬되는지 확인함.
+ 누적 버퍼에 그리고 합성하는 GPU 비용은 GL 컨텍스트가 필요하므로, 앱의 프로파일러 오버레이의 "oit resolve" 구간으로 확인함.
+ */
+int benchTransparency() {
+    const float orderDependentFraction = 0.1f;
+    bool passed = true;
+
+    CameraData cam;
+    cam.position = glm::vec3(0.3f, -0.2f, 0.0f);
+    cam.rotation = 0.2f;
+    const glm::mat4 view = buildViewMatrix(cam);
+    auto viewZ = [&](const float* instance) {
+        const float* t = instance + SpriteBatch::MODEL_OFFSET + 12; // 모델행렬의 이동 성분
+        return view[0][2] * t[0] + view[1][2] * t[1] + view[2][2] * t[2] + view[3][2];
+    };
+    // first 부터 count 개의 인스턴스가 먼 것부터 (뷰 공간 z 가 작은 것부터) 놓여 있는지
+    auto backToFront = [&](const SpriteBatch& batch, size_t first, size_t count) {
+        const float* data = batch.getInstanceData().data();
+        for (size_t i = first + 1; i < first + count; ++i) {
+            if (viewZ(data + i * SpriteBatch::FLOATS_PER_INSTANCE) < viewZ(data + (i - 1) * SpriteBatch::FLOATS_PER_INSTANCE)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (int count : { 1000, 10000, 100000 }) {
+        ofSeedRandom(1012);
+        SpriteBatch batch;
+        batch.setOrderDependentShader(1, true);
+        size_t orderDependent = 0;
+        for (int i = 0; i < count; ++i) {
+            SpriteInstance instance;
+            instance.model = buildMatrix(glm::vec3(ofRandom(-1.5, 1.5), ofRandom(-1, 1), ofRandom(-2, 0.5)), ofRandom(TWO_PI), glm::vec3(1, 1, 1));
+            int shader = ofRandom(1) < orderDependentFraction ? 1 : 0;
+            orderDependent += shader;
+            batch.submit(SPRITE_PASS_TRANSPARENT, shader, (int)ofRandom(4), (int)ofRandom(2), instance);
+        }
+
+        std::string report;
+        for (TransparentOrder order : { TRANSPARENT_BACK_TO_FRONT, TRANSPARENT_ORDER_INDEPENDENT }) {
+            batch.setTransparentOrder(order);
+            double buildTime = bestOf(repeatsFor(count), [&]() {
+                batch.build(view);
+            });
+
+            // 깊이 정렬: 전체가 한 패스에서 먼 것부터
+            // OIT: 셰이더 0 번은 상태별로 묶인 SPRITE_PASS_TRANSPARENT 그룹들, 그 뒤에 셰이더 1 번만 깊이 정렬된 SPRITE_PASS_TRANSPARENT_SORTED 그룹들
+            const std::vector<SpriteDrawGroup>& groups = batch.getGroups();
+            bool ok = true;
+            if (order == TRANSPARENT_BACK_TO_FRONT) {
+                ok = backToFront(batch, 0, count);
+                for (const SpriteDrawGroup& group : groups) {
+                    ok = ok && group.pass == SPRITE_PASS_TRANSPARENT;
+                }
+            } else {
+                size_t sortedFirst = count - orderDependent;
+                for (const SpriteDrawGroup& group : groups) {
+                    bool sorted = group.first >= sortedFirst;
+                    ok = ok && group.pass == (sorted ? SPRITE_PASS_TRANSPARENT_SORTED : SPRITE_PASS_TRANSPARENT) && group.shader == (sorted ? 1 : 0);
+                }
+                ok = ok && backToFront(batch, sortedFirst, orderDependent);
+            }
+            passed = passed && ok;
+
+            const SpriteBatchStats& stats = batch.getStats();
+            report += "\n    " + std::string(order == TRANSPARENT_BACK_TO_FRONT ? "sorted" : "oit   ") + " build " + ofToString(buildTime * 1e6, 1) + " us ("
+                + ofToString(buildTime * 1e9 / count, 1) + " ns/sprite), " + ofToString(stats.drawCalls) + " draw calls, " + ofToString(stats.stateChanges()) + " state changes"
+                + (ok ? "" : ", order FAILED");
+        }
+        ofLogNotice("bench") << "transparency: " << count << " transparent sprites (" << orderDependent << " without an OIT shader)" << report;
+    }
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+// 헤드리스 앱에서 장면 파일을 고쳐서 reloadScene() 한 뒤 컬링 결과를 확인함. (benchScene() 참고)
+bool checkSceneReload(const SceneHeader& header, const std::vector<SceneSpriteDesc>& sprites) {
+    const std::string path = "bench_scene_reload.scene";
+    const std::string cache = "bench_scene_reload.scnb";
+    saveSceneText(path, header, sprites);
+
+    HeadlessSettings headless;
+    headless.enabled = true;
+    headless.width = 256;
+    headless.height = 192;
+    headless.frames = std::numeric_limits<int>::max(); // 이미지를 저장하고 종료하지 않도록 함
+    SceneSettings settings;
+    settings.file = path;
+    std::unique_ptr<ofApp> app(new ofApp(headless, CrowdSettings(), settings));
+    app->setup();
+    app->draw();
+
+    // 처음에 보이는 스프라이트 중 이름 없는 것 하나를 화면 밖으로 옮기고, 그 스프라이트를 원래 자리에 하나 더 추가함.
+    auto isVisible = [&](int sprite) {
+        return std::find(app->visibleSprites.begin(), app->visibleSprites.end(), sprite) != app->visibleSprites.end();
+    };
+    int moved = -1;
+    for (size_t i = 0; i < app->sceneSprites.size() && moved < 0; ++i) {
+        if (app->sceneSprites[i].name.empty() && isVisible(app->sceneSpriteIndices[i])) {
+            moved = (int)i;
+        }
+    }
+    bool passed = moved >= 0;
+    if (passed) {
+        std::vector<SceneSpriteDesc> edited = app->sceneSprites;
+        edited.push_back(edited[moved]);
+        edited[moved].transform.position.x += 100.0f;
+        saveSceneText(path, header, edited);
+        app->reloadScene();
+        app->draw();
+
+        const SceneSprite& sprite = app->sprites[app->sceneSpriteIndices[moved]];
+        SpriteBounds expected = transformBounds(sprite.localBounds, app->sceneGraph.getWorldMatrix(sprite.node));
+        passed = app->sceneSprites.size() == edited.size() && !isVisible(app->sceneSpriteIndices[moved]) && isVisible(app->sceneSpriteIndices.back())
+            && sprite.worldBounds.min == expected.min && sprite.worldBounds.max == expected.max;
+    }
+    app->exit();
+    app.reset();
+    ofFile::removeFile(path);
+    ofFile::removeFile(cache);
+    return passed;
+}
+
+// 범위를 벗어난 인덱스를 참조하는 스프라이트를 바이너리 파일로 저장해서 읽어봄. 올바른 스프라이트 2개만 남고 프레임 번호가 잘려야 함.
+bool checkBinaryValidation(const SceneHeader& header) {
+    const std::string path = "bench_scene_invalid.scnb";
+    int frameCount = header.textures[0].frameCount;
+    std::vector<SceneSpriteDesc> sprites(7);
+    sprites[0].frame = frameCount + 5;
+    sprites[1].frame = -3;
+    sprites[2].parent = (int)header.nodes.size();
+    sprites[3].mesh = (int)header.meshes.size();
+    sprites[4].shader = -1;
+    sprites[5].texture = (int)header.textures.size();
+    sprites[6].pass = 2;
+    SceneHeader loadedHeader;
+    std::vector<SceneSpriteDesc> loaded;
+    bool passed = saveSceneBinary(path, header, sprites) && SceneLoader::load(path, loadedHeader, loaded)
+        && loaded.size() == 2 && loaded[0].frame == frameCount - 1 && loaded[1].frame == 0;
+    ofFile::removeFile(path);
+    return passed;
+}
+
+bool sameSprites(const std::vector<SceneSpriteDesc>& a, const std::vector<SceneSpriteDesc>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!a[i].sameBinding(b[i]) || a[i].transform != b[i].transform) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ 잘린 .scnb 캐시를 SceneLoader::load() 가 거부하고, 헤드리스 앱은 캐시를 지우고 텍스트 파일의 스프라이트를 모두 읽은 뒤 캐시를 다시 쓰는지 확인함.
+ 헤더 청크에서 자르면 setup() 에서, 두 번째 스프라이트 청크에서 자르면 첫 번째 청크를 캐시에서 추가한 뒤 updateSceneStreaming() 에서 텍스트 파일로 넘어감.
+ */
+bool checkBrokenCache(const SceneHeader& header, const std::vector<SceneSpriteDesc>& baseSprites) {
+    const std::string path = "bench_scene_broken.scene";
+    const std::string cache = "bench_scene_broken.scnb";
+    std::vector<SceneSpriteDesc> sprites;
+    for (size_t i = 0; i < SceneLoader::BINARY_SPRITES_PER_CHUNK + 1000; ++i) {
+        sprites.push_back(baseSprites[i % baseSprites.size()]);
+        sprites.back().transform.position.x += (i / baseSprites.size()) * 0.001f;
+    }
+    saveSceneText(path, header, sprites);
+    SceneHeader textHeader;
+    std::vector<SceneSpriteDesc> textSprites;
+    bool passed = SceneLoader::load(path, textHeader, textSprites) && saveSceneBinary(cache, textHeader, textSprites);
+    std::vector<char> bytes;
+    {
+        std::ifstream in(ofToDataPath(cache), std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    for (size_t cut : { (size_t)40, bytes.size() - 1000 }) {
+        {
+            std::ofstream out(ofToDataPath(cache), std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), cut);
+        }
+        SceneHeader brokenHeader;
+        std::vector<SceneSpriteDesc> brokenSprites;
+        bool rejected = !SceneLoader::load(cache, brokenHeader, brokenSprites);
+
+        HeadlessSettings headless;
+        headless.enabled = true;
+        headless.width = 256;
+        headless.height = 192;
+        headless.frames = std::numeric_limits<int>::max();
+        SceneSettings settings;
+        settings.file = path;
+        std::unique_ptr<ofApp> app(new ofApp(headless, CrowdSettings(), settings));
+        app->setup();
+        bool loaded = sameSprites(app->sceneSprites, textSprites);
+        app->exit();
+        app.reset(); // assetLoader 가 캐시를 다 쓸 때까지 기다림
+
+        SceneHeader cacheHeader;
+        std::vector<SceneSpriteDesc> cacheSprites;
+        bool rewritten = SceneLoader::load(cache, cacheHeader, cacheSprites) && sameSprites(cacheSprites, textSprites);
+        passed = passed && rejected && loaded && rewritten;
+    }
+    ofFile::removeFile(path);
+    ofFile::removeFile(cache);
+    return passed;
+}
+
+/**
+ sceneFile.h 의 텍스트 / 바이너리 장면 파일을 SceneLoader::load() 로 끝까지 읽는 속도(MB/s, 항목/s)를 비교함.
+
+ forest.scene 의 헤더에 고정 시드로 만든 스프라이트(절반은 캐릭터, 절반은 구름)를 더해서 텍스트 파일로 저장하고,
+ 그 파일을 읽은 결과를 바이너리 파일로 저장해서 두 파일을 읽은 결과가 같은지 확인함.
+ (텍스트 형식은 float 를 7자리까지만 저장하므로 생성한 값이 아니라 텍스트를 읽은 값과 비교함)
+
+ 그 밖에 다음을 확인하고, 하나라도 틀리면 실패로 처리함.
+ - 바이너리 스프라이트가 범위를 벗어난 노드, 메쉬, 셰이더, 텍스쳐, 패스를 참조하면 건너뛰고, 프레임 번호는 [0, 프레임 수) 로 자르는지
+ - 잘린 바이너리 캐시: SceneLoader::load() 가 실패하고, 헤드리스 앱은 캐시 대신 텍스트 파일을 끝까지 읽은 뒤 캐시를 다시 쓰는지 (checkBrokenCache())
+ - 핫 리로드: 헤드리스 앱에서 스프라이트 하나를 화면 밖으로 옮기고 스프라이트 하나를 더한 장면을 reloadScene() 한 뒤,
+   옮긴 스프라이트는 컬링 결과에서 빠지고 더한 스프라이트는 들어오는지 (추가할 때의 sceneGraph.update() 가 옮긴 노드의 갱신을 가져가도 격자가 갱신되는지)
+ */
+int benchScene() {
+    const std::string sceneFile = "forest.scene";
+    const std::string textPath = "bench_scene.scene";
+    const std::string binaryPath = "bench_scene.scnb";
+    SceneHeader header;
+    std::vector<SceneSpriteDesc> baseSprites;
+    if (!SceneLoader::load(sceneFile, header, baseSprites)) {
+        ofLogError("bench") << "scene: cannot load " << sceneFile;
+        return 1;
+    }
+    int charMesh = header.findMesh("character");
+    int cloudMesh = header.findMesh("cloud");
+    int alphaTestShader = header.findShader("alphaTest");
+    int cloudShader = header.findShader("cloud");
+    int walkTexture = header.findTexture("walk");
+    int cloudTexture = header.findTexture("cloud");
+    if (charMesh < 0 || cloudMesh < 0 || alphaTestShader < 0 || cloudShader < 0 || walkTexture < 0 || cloudTexture < 0) {
+        ofLogError("bench") << "scene: " << sceneFile << " has no character / cloud mesh, shader or texture";
+        return 1;
+    }
+
+    bool valid = checkBinaryValidation(header);
+    bool reload = checkSceneReload(header, baseSprites);
+    bool broken = checkBrokenCache(header, baseSprites);
+    bool passed = valid && reload && broken;
+
+    for (int count : { 100000, 1000000 }) {
+        ofSeedRandom(1013);
+        std::vector<SceneSpriteDesc> sprites = baseSprites;
+        sprites.reserve(sprites.size() + count);
+        for (int i = 0; i < count; ++i) {
+            SceneSpriteDesc sprite;
+            bool character = i % 2 == 0;
+            sprite.mesh = character ? charMesh : cloudMesh;
+            sprite.shader = character ? alphaTestShader : cloudShader;
+            sprite.texture = character ? walkTexture : cloudTexture;
+            sprite.frame = character ? (int)ofRandom(header.textures[walkTexture].frameCount) : 0;
+            sprite.pass = character ? SPRITE_PASS_OPAQUE : SPRITE_PASS_TRANSPARENT;
+            sprite.transform.position = glm::vec3(ofRandom(-1.3, 1.3), ofRandom(-1, 1), ofRandom(-0.5, 0.0));
+            sprite.transform.rotation = character ? 0.0f : ofRandom(TWO_PI);
+            sprites.push_back(sprite);
+        }
+
+        SceneHeader textHeader, binaryHeader;
+        std::vector<SceneSpriteDesc> textSprites, binarySprites;
+        SceneLoadStats textStats, binaryStats;
+        saveSceneText(textPath, header, sprites);
+        int repeats = count >= 1000000 ? 3 : 5;
+        bool loaded = true;
+        double textTime = bestOf(repeats, [&]() {
+            textSprites.clear();
+            loaded = SceneLoader::load(textPath, textHeader, textSprites, &textStats) && loaded;
+        });
+        saveSceneBinary(binaryPath, textHeader, textSprites);
+        double binaryTime = bestOf(repeats, [&]() {
+            binarySprites.clear();
+            loaded = SceneLoader::load(binaryPath, binaryHeader, binarySprites, &binaryStats) && loaded;
+        });
+        ofFile::removeFile(textPath);
+        ofFile::removeFile(binaryPath);
+
+        bool same = loaded && textSprites.size() == sprites.size() && sameSprites(textSprites, binarySprites);
+        passed = passed && same;
+        auto report = [](const char* format, double seconds, const SceneLoadStats& stats) {
+            double megabytes = stats.bytes / (1024.0 * 1024.0);
+            return "\n    " + std::string(format) + " " + ofToString(megabytes, 1) + " MB in " + ofToString(seconds * 1e3, 1) + " ms ("
+                + ofToString(megabytes / seconds, 1) + " MB/s, " + ofToString(stats.entities / seconds / 1e6, 2) + " M entities/s)";
+        };
+        ofLogNotice("bench") << "scene: " << sprites.size() << " sprites" << report("text  ", textTime, textStats) << report("binary", binaryTime, binaryStats)
+            << ", " << ofToString(textTime / binaryTime, 1) << "x faster" << (same ? "" : "\n    text and binary scenes DIFFER");
+    }
+    ofLogNotice("bench") << "scene: out-of-range binary sprites " << (valid ? "skipped" : "NOT skipped") << ", broken cache " << (broken ? "replaced" : "NOT replaced")
+        << ", hot reload visible set " << (reload ? "updated" : "STALE");
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+// 헤드리스 앱을 frames 프레임 동안 main.cpp 의 --headless 와 같은 순서로 돌림. (이미지를 저장하고 종료하지 않도록 frames 보다 많이 돌리도록 설정함)
+std::unique_ptr<ofApp> runHeadless(int width, int height, int frames, int threads = 0) {
+    HeadlessSettings headless;
+    headless.enabled = true;
+    headless.width = width;
+    headless.height = height;
+    headless.threads = threads;
+    headless.frames = std::numeric_limits<int>::max();
+    std::unique_ptr<ofApp> app(new ofApp(headless));
+    app->setup();
+    for (int i = 0; i < frames; ++i) {
+        app->update();
+        app->draw();
+    }
+    return app;
+}
+
+/**
+ softwareRasterizer.h 의 래스터라이저로 forest.scene 을 해상도, 스레드 수별로 그려서 초당 프레임 수를 재고,
+ bin/data/golden 의 기준 이미지들을 main.cpp 주석에 적힌 설정으로 다시 렌더링해서 비교함.
+
+ 처리량은 앱이 만든 spriteBatch 를 SoftwareRasterizer::draw() 로 그리는 시간만 잼. (컬링, 배치 빌드 제외)
+ 같은 해상도에서 스레드 수에 따라 결과 이미지가 한 픽셀이라도 다르거나, 기준 이미지와 다르면 실패로 처리함.
+ */
+int benchRaster() {
+    struct Golden {
+        const char* path;
+        int width, height, frames;
+    };
+    const Golden goldens[] = {
+        { "golden/forest_1024x768.png", 1024, 768, 1 },
+        { "golden/forest_512x384_30frames.png", 512, 384, 30 },
+    };
+    bool passed = true;
+    for (const Golden& golden : goldens) {
+        std::unique_ptr<ofApp> app = runHeadless(golden.width, golden.height, golden.frames);
+        passed = compareWithGolden(app->rasterizer.getPixels(), golden.path, "bench_raster_diff.png") && passed;
+        app->exit();
+    }
+
+    int hardwareThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> threadCounts;
+    for (int threads : { 1, 2, 4, 8, 16 }) {
+        if (threads < hardwareThreads) {
+            threadCounts.push_back(threads);
+        }
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    std::unique_ptr<ofApp> app = runHeadless(1024, 768, 1);
+    const SceneCamera& sceneCam = app->scene.camera;
+    glm::mat4 view = buildViewMatrix(app->cam);
+    glm::mat4 proj = glm::ortho(sceneCam.left, sceneCam.right, sceneCam.bottom, sceneCam.top, sceneCam.nearClip, sceneCam.farClip);
+    std::string report;
+    for (glm::ivec2 size : { glm::ivec2(512, 384), glm::ivec2(1024, 768), glm::ivec2(1920, 1440), glm::ivec2(3840, 2880) }) {
+        report += "\n    " + ofToString(size.x) + "x" + ofToString(size.y) + ":";
+        ofPixels reference;
+        for (int threads : threadCounts) {
+            app->rasterizer.setup(size.x, size.y, threads);
+            double seconds = bestOf(size.x >= 3840 ? 3 : 10, [&]() {
+                app->rasterizer.draw(app->spriteBatch, view, proj);
+            });
+            bool same = true;
+            if (reference.isAllocated()) {
+                ImageDiff diff = compareImages(app->rasterizer.getPixels(), reference, 0);
+                same = diff.sameSize && diff.mismatched == 0;
+            } else {
+                reference = app->rasterizer.getPixels();
+            }
+            passed = passed && same;
+            report += " " + ofToString(threads) + (threads == 1 ? " thread " : " threads ") + ofToString(1.0 / seconds, 1) + " fps" + (same ? "," : " (image DIFFERS),");
+        }
+        report.pop_back();
+    }
+    app->exit();
+    ofLogNotice("bench") << "raster: forest.scene, " << app->spriteBatch.getStats().instances << " instances, frames/s by resolution and thread count" << report;
+    return passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+/**
+ walkerAnimation.h 의 워커 갱신을 스레드 1, 2, 4, ... 개(하드웨어 스레드 수까지)로 돌려서 워커 하나당 시간을 잼.
+
+ ofApp::setupCrowd() 와 같은 범위, 속도로 워커를 흩어놓고 (프레임은 forest.scene 의 walk 스프라이트시트처럼 11개)
+ 스레드 수마다 같은 워커 데이터에서 시작해서 같은 횟수만큼 갱신함.
+ 워커끼리 서로 영향을 주지 않으므로 스레드 수와 상관없이 결과가 같아야 하고,
+ 위치, 프레임 번호, 인스턴스 데이터가 스레드 1개로 갱신한 결과와 비트 단위로 하나라도 다르면 실패로 처리함.
+ */
+int benchWalkers() {
+    const int iterations = 20;
+    const float dt = 1.0f / 60.0f;
+    std::vector<AtlasFrame> frames;
+    for (int i = 0; i < 11; ++i) {
+        frames.push_back({ 0, glm::vec4((i % 3) / 3.0f, (i / 3) / 4.0f, 1.0f / 3.0f, 1.0f / 4.0f) });
+    }
+    int hardwareThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    bool passed = true;
+
+    for (int count : { 10000, 100000, 1000000 }) {
+        WalkerSoA initial;
+        ofSeedRandom(1010);
+        for (int i = 0; i < count; ++i) {
+            glm::vec2 pos(ofRandom(-1.45, 1.45), ofRandom(-0.95, -0.15));
+            glm::vec2 vel(ofRandom(0.1, 0.35), 0.0);
+            initial.add(pos, vel, ofRandom(frames.size() / 12.0f));
+        }
+
+        WalkerSoA reference;
+        std::vector<SpriteInstance> referenceInstances;
+        std::string report;
+        for (int threads = 1; ; threads = std::min(threads * 2, hardwareThreads)) {
+            WalkerAnimation animation;
+            animation.setup(frames, 12.0f, glm::vec2(-1.45, -0.95), glm::vec2(1.45, -0.15), 0.35f, -0.25f);
+            animation.getWalkers() = initial;
+            std::vector<SpriteInstance> instances(count);
+            animation.update(dt, instances.data(), threads); // 캐시, 스레드를 데우는 용도로 시간에서 뺌
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                animation.update(dt, instances.data(), threads);
+            }
+            double nsPerWalker = std::chrono::duration<double>(Clock::now() - start).count() * 1e9 / ((double)iterations * count);
+
+            const WalkerSoA& walkers = animation.getWalkers();
+            bool same = true;
+            if (threads == 1) {
+                reference = walkers;
+                referenceInstances = instances;
+            } else {
+                same = walkers.posX == reference.posX && walkers.posY == reference.posY && walkers.clock == reference.clock && walkers.frame == reference.frame
+                    && memcmp(instances.data(), referenceInstances.data(), count * sizeof(SpriteInstance)) == 0;
+            }
+            passed = passed && same;
+            report += (report.empty() ? "" : ", ") + ofToString(threads) + (threads == 1 ? " thread " : " threads ") + ofToString(nsPerWalker, 2) + " ns" + (same ? "" : " (results DIFFER)");
+            if (threads == hardwareThreads) {
+                break;
+            }
+        }
+        ofLogNotice("bench") << "walkers: " << count << " walkers, " << iterations << " updates, update per walker: " << report;
+    }
+    return passed ? 0 : 1;
+}
+
+typedef int (*Benchmark)();
+
+const std::vector<std::pair<std::string, Benchmark>>& getBenchmarks() {
+    static const std::vector<std::pair<std::string, Benchmark>> benchmarks = {
+        { "transform", benchTransform },
+        { "hierarchy", benchHierarchy },
+        { "raster", benchRaster },
+        { "culling", benchCulling },
+        { "atlas", benchAtlas },
+        { "startup", benchStartup },
+        { "simulation", benchSimulation },
+        { "walkers", benchWalkers },
+        { "profiler", benchProfiler },
+        { "transparency", benchTransparency },
+        { "scene", benchScene },
+    };
+    return benchmarks;
+}
+
+}
+
+//--------------------------------------------------------------
+std::vector<std::string> getBenchmarkNames() {
+    std::vector<std::string> names;
+    for (const auto& benchmark : getBenchmarks()) {
+        names.push_back(benchmark.first);
+    }
+    return names;
+}
+
+int runBenchmark(const std::string& name) {
+    int result = 0;
+    bool found = false;
+    for (const auto& benchmark : getBenchmarks()) {
+        if (name == benchmark.first || name == "all") {
+            found = true;
+            if (benchmark.second() != 0) {
+                ofLogError("bench") << benchmark.first << ": FAILED";
+                result = 1;
+            }
+        }
+    }
+    if (!found) {
+        ofLogError("bench") << "unknown benchmark " << name << ", available: all, " << ofJoinString(getBenchmarkNames(), ", ");
+        return 1;
+    }
+    return result;
+}
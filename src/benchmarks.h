@@ -0,0 +1,19 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ --bench <이름> 으로 실행하는 벤치마크들. (main.cpp 참고)
+
+ 창과 GL 컨텍스트를 만들지 않고 바로 돌린 뒤, 결과를 로그로 출력하고 종료함.
+ 매번 같은 결과가 나오도록 입력 데이터는 고정 시드로 만들고, 같은 작업을 여러 번 돌려서 가장 빠른 시간을 기록함.
+ 결과 검증에 실패하면 (예: 배치 계산 결과가 기준 함수와 다르면) 0 이 아닌 값을 리턴하므로, 프로세스 종료 코드로 확인할 수 있음.
+
+ 예) matrix-transform --bench transform
+ */
+
+// 등록된 벤치마크 이름들 ("all" 은 전부 실행)
+std::vector<std::string> getBenchmarkNames();
+
+// 이름에 해당하는 벤치마크를 실행하고 종료 코드를 리턴함. (없는 이름이면 목록을 출력하고 1)
+int runBenchmark(const std::string& name);
@@ -0,0 +1,27 @@
+#include "fileTime.h"
+#include <sys/stat.h>
+
+//--------------------------------------------------------------
+bool getFileStat(const std::string& path, int64_t& modified, int64_t& size) {
+    struct ::stat info;
+    if (::stat(ofToDataPath(path).c_str(), &info) != 0) {
+        modified = 0;
+        size = -1;
+        return false;
+    }
+#ifdef __APPLE__
+    modified = (int64_t)info.st_mtimespec.tv_sec * 1000000000 + info.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    modified = (int64_t)info.st_mtime * 1000000000;
+#else
+    modified = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    size = (int64_t)info.st_size;
+    return true;
+}
+
+int64_t getModifiedTime(const std::string& path) {
+    int64_t modified, size;
+    getFileStat(path, modified, size);
+    return modified;
+}
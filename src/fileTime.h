@@ -0,0 +1,17 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ 파일의 수정 시각, 크기를 stat() 으로 읽는 함수들. (경로는 ofToDataPath() 기준)
+
+ 캐시 파일이 원본보다 새로운지 비교할 때 (아틀라스 디스크립터, 텍스쳐 캐시, 장면 바이너리 캐시)와
+ FileWatcher 가 바뀐 파일을 찾을 때 사용함.
+ 저장을 빠르게 두 번 하면 초 단위 수정 시각이 같을 수 있으므로, 나노초까지 읽음. (윈도우는 초 단위)
+ */
+
+// 파일이 없으면 false 를 리턴하고 modified 는 0, size 는 -1
+bool getFileStat(const std::string& path, int64_t& modified, int64_t& size);
+
+// 파일 수정 시각 (나노초). 파일이 없으면 0
+int64_t getModifiedTime(const std::string& path);
@@ -0,0 +1,32 @@
+#include "fileWatcher.h"
+
+//--------------------------------------------------------------
+void FileWatcher::watch(const std::string& path) {
+    for (const WatchedFile& file : files) {
+        if (file.path == path) {
+            return;
+        }
+    }
+    WatchedFile file;
+    file.path = path;
+    getFileStat(path, file.modified, file.size);
+    files.push_back(file);
+}
+
+std::vector<std::string> FileWatcher::poll() {
+    std::vector<std::string> changed;
+    for (WatchedFile& file : files) {
+        int64_t modified, size;
+        getFileStat(file.path, modified, size);
+        // 지워진 파일은 다시 만들어질 때까지 바뀐 걸로 치지 않음. (저장 도중에 지웠다가 다시 쓰는 에디터가 있음)
+        if (size < 0) {
+            continue;
+        }
+        if (modified != file.modified || size != file.size) {
+            file.modified = modified;
+            file.size = size;
+            changed.push_back(file.path);
+        }
+    }
+    return changed;
+}
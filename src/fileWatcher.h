@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ofMain.h"
+#include "fileTime.h"
+
+/**
+ 파일의 수정 시각을 주기적으로 확인해서 바뀐 파일을 알려주는 클래스. (핫 리로드용)
+
+ OS 별 파일 변경 알림(inotify, FSEvents 등) 대신 stat() 으로 수정 시각과 크기를 비교하므로 (fileTime.h),
+ 확인할 때마다 파일 수만큼 stat() 을 호출함. 파일 수가 많지 않으므로 0.5초에 한 번 정도 확인하면 충분함.
+ 에디터가 파일을 지웠다가 다시 만드는 경우에도, 다시 만들어진 뒤에 확인하면 바뀐 파일로 알려줌.
+ */
+class FileWatcher {
+    public:
+        // 경로는 ofToDataPath() 기준. 같은 파일을 다시 등록하면 무시함.
+        void watch(const std::string& path);
+        void clear() { files.clear(); }
+
+        // 마지막으로 확인한 뒤 수정 시각이나 크기가 바뀐 파일들의 경로를 (watch() 에 넘긴 그대로) 리턴함.
+        std::vector<std::string> poll();
+
+    private:
+        struct WatchedFile {
+            std::string path;
+            int64_t modified;
+            int64_t size;
+        };
+
+        std::vector<WatchedFile> files;
+};
@@ -0,0 +1,301 @@
+#include "frameProfiler.h"
+#include <fstream>
+#include <iomanip>
+
+//--------------------------------------------------------------
+FrameProfiler::FrameProfiler() : epoch(Clock::now()) {
+}
+
+FrameProfiler& FrameProfiler::get() {
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler::ThreadState::~ThreadState() {
+    if (ring) {
+        ring->retired = true;
+    }
+}
+
+/**
+ thread_local 은 스레드마다 따로 생기는 변수라서, 처음 기록할 때 그 스레드의 링 버퍼를 만들어서 등록함.
+ 프로파일러가 여러 개인 경우 (테스트 등) 다른 프로파일러에서 만든 상태를 쓰지 않도록 owner 를 확인함.
+ */
+FrameProfiler::ThreadState& FrameProfiler::getThreadState() {
+    thread_local ThreadState state;
+    if (state.owner != this) {
+        if (state.ring) {
+            state.ring->retired = true;
+        }
+        std::ostringstream name;
+        name << "thread " << std::this_thread::get_id();
+        state.owner = this;
+        state.ring = addRing(name.str());
+        state.depth = 0;
+    }
+    return state;
+}
+
+std::shared_ptr<FrameProfiler::Ring> FrameProfiler::addRing(const std::string& name) {
+    std::shared_ptr<Ring> ring = std::make_shared<Ring>();
+    ring->name = name;
+    ring->slots.reset(new Slot[RING_CAPACITY]);
+
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    ring->id = nextTrackId++;
+    rings.push_back(ring);
+    return ring;
+}
+
+void FrameProfiler::Slot::store(const ProfileEvent& event) {
+    uint64_t data[WORDS] = {};
+    memcpy(data, &event, sizeof(event));
+    for (size_t i = 0; i < WORDS; ++i) {
+        words[i].store(data[i], std::memory_order_relaxed);
+    }
+}
+
+ProfileEvent FrameProfiler::Slot::load() const {
+    uint64_t data[WORDS];
+    for (size_t i = 0; i < WORDS; ++i) {
+        data[i] = words[i].load(std::memory_order_relaxed);
+    }
+    ProfileEvent event;
+    memcpy(&event, data, sizeof(event));
+    return event;
+}
+
+/**
+ 링 버퍼의 주인 스레드만 호출함. 기록을 먼저 쓰고 written 을 올려서, collect() 가 written 까지 읽으면 다 쓴 기록만 보게 함.
+ 칸을 쓰기 전의 release 펜스는, collect() 가 이 기록의 일부라도 읽었다면 펜스 뒤에서 다시 읽는 written 이 n 이상이 되도록 해줌. (collect() 참고)
+ */
+void FrameProfiler::push(Ring& ring, const ProfileEvent& event) {
+    uint64_t n = ring.written.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ring.slots[n % RING_CAPACITY].store(event);
+    ring.written.store(n + 1, std::memory_order_release);
+}
+
+//--------------------------------------------------------------
+void FrameProfiler::begin(const char* name) {
+    ThreadState& state = getThreadState();
+    // 최대 깊이보다 깊게 중첩되면 깊이만 세고 기록하지 않음. (end() 와 짝을 맞추기 위해)
+    if (state.depth < MAX_DEPTH) {
+        state.names[state.depth] = name;
+        state.starts[state.depth] = now();
+    }
+    state.depth++;
+}
+
+void FrameProfiler::end() {
+    ThreadState& state = getThreadState();
+    if (state.depth == 0) {
+        return;
+    }
+    state.depth--;
+    if (state.depth >= MAX_DEPTH) {
+        return;
+    }
+
+    ProfileEvent event;
+    event.name = state.names[state.depth];
+    event.startNanos = state.starts[state.depth];
+    event.durationNanos = now() - event.startNanos;
+    event.frame = frame;
+    event.depth = (uint16_t)state.depth;
+    push(*state.ring, event);
+}
+
+void FrameProfiler::setThreadName(const std::string& name) {
+    ThreadState& state = getThreadState();
+    std::lock_guard<std::mutex> lock(state.ring->nameMutex);
+    state.ring->name = name;
+}
+
+int FrameProfiler::createTrack(const std::string& name) {
+    return addRing(name)->id;
+}
+
+void FrameProfiler::addEvent(int track, const ProfileEvent& event) {
+    if (!enabled) {
+        return;
+    }
+    std::shared_ptr<Ring> ring;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (const std::shared_ptr<Ring>& r : rings) {
+            if (r->id == track) {
+                ring = r;
+                break;
+            }
+        }
+    }
+    if (ring) {
+        push(*ring, event);
+    }
+}
+
+//--------------------------------------------------------------
+std::vector<ProfileTrack> FrameProfiler::collect() {
+    std::vector<ProfileTrack> tracks;
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (size_t i = 0; i < rings.size(); ) {
+        Ring& ring = *rings[i];
+        // retired 를 먼저 읽어야, 종료된 스레드라고 보고 지울 때 그 스레드의 마지막 기록까지 읽은 상태가 됨.
+        bool retired = ring.retired;
+
+        ProfileTrack track;
+        track.id = ring.id;
+        {
+            std::lock_guard<std::mutex> nameLock(ring.nameMutex);
+            track.name = ring.name;
+        }
+        uint64_t written = ring.written.load(std::memory_order_acquire);
+        uint64_t first = std::max(written > RING_CAPACITY ? written - RING_CAPACITY : 0, ring.clearedAt.load());
+        track.events.reserve((size_t)(written - std::min(first, written)));
+        for (uint64_t n = first; n < written; ++n) {
+            track.events.push_back(ring.slots[n % RING_CAPACITY].load());
+        }
+
+        // 복사하는 동안 기록하는 스레드가 링을 한 바퀴 돌아서 덮어쓴 칸과, 지금 쓰고 있을 수 있는 칸 (다음 written 위치) 의 기록은 버림.
+        // (종료된 스레드는 더 이상 쓰지 않으므로 전부 유효함)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = ring.written.load(std::memory_order_relaxed);
+        uint64_t valid = after + 1 > RING_CAPACITY ? after + 1 - RING_CAPACITY : 0;
+        if (!retired && valid > first) {
+            track.events.erase(track.events.begin(), track.events.begin() + (size_t)std::min(valid - first, (uint64_t)track.events.size()));
+        }
+        if (!track.events.empty()) {
+            tracks.push_back(std::move(track));
+        }
+
+        // 종료된 스레드의 링 버퍼는 기록을 한 번 넘겨준 뒤 지움. (프레임마다 스레드를 새로 만드는 경우에도 계속 쌓이지 않도록)
+        if (retired) {
+            rings.erase(rings.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+    return tracks;
+}
+
+void FrameProfiler::clear() {
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (const std::shared_ptr<Ring>& ring : rings) {
+        ring->clearedAt = ring->written.load();
+    }
+}
+
+//--------------------------------------------------------------
+// JSON 문자열 안에 들어갈 수 없는 문자들을 이스케이프함.
+static void writeJsonString(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+void writeChromeTrace(const std::vector<ProfileTrack>& tracks, std::ostream& out) {
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const ProfileTrack& track : tracks) {
+        // 트랙 이름을 스레드 이름으로 표시하기 위한 메타데이터 이벤트
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track.id << ",\"args\":{\"name\":";
+        writeJsonString(out, track.name);
+        out << "}}";
+        first = false;
+
+        for (const ProfileEvent& event : track.events) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << track.id
+                << ",\"ts\":" << ofToString(event.startNanos / 1000.0, 3) << ",\"dur\":" << ofToString(event.durationNanos / 1000.0, 3)
+                << ",\"args\":{\"frame\":" << event.frame << "}}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool saveChromeTrace(const std::vector<ProfileTrack>& tracks, const std::string& path) {
+    std::ofstream out(ofToDataPath(path, true), std::ios::binary);
+    if (!out) {
+        ofLogError("FrameProfiler") << "saveChromeTrace(): could not open " << path;
+        return false;
+    }
+    writeChromeTrace(tracks, out);
+    return (bool)out;
+}
+
+//--------------------------------------------------------------
+std::vector<ProfileSummary> summarizeFrames(const std::vector<ProfileTrack>& tracks, uint32_t firstFrame, uint32_t lastFrame) {
+    std::vector<ProfileSummary> summary;
+    if (lastFrame < firstFrame) {
+        return summary;
+    }
+    double frames = lastFrame - firstFrame + 1;
+
+    for (const ProfileTrack& track : tracks) {
+        size_t trackStart = summary.size();
+
+        // 구간은 끝난 순서대로 기록되므로 (안쪽 구간이 먼저), 시작 시각 순서로 다시 정렬해서 호출 순서대로 만듦.
+        std::vector<const ProfileEvent*> events;
+        for (const ProfileEvent& event : track.events) {
+            if (event.frame >= firstFrame && event.frame <= lastFrame) {
+                events.push_back(&event);
+            }
+        }
+        std::stable_sort(events.begin(), events.end(), [](const ProfileEvent* a, const ProfileEvent* b) {
+            return a->startNanos < b->startNanos;
+        });
+
+        // 한 프레임에 여러 번 불린 구간은 그 프레임의 합이 프레임당 시간이므로, max 도 구간 하나가 아니라 프레임별 합 중 가장 큰 값으로 구함.
+        // 시작 시각 순서이므로 구간마다 프레임 번호는 커지기만 함. 프레임이 바뀔 때 그 전 프레임의 합을 max 에 반영함.
+        std::vector<uint32_t> entryFrames; // summary[trackStart + i] 가 마지막으로 나온 프레임
+        std::vector<double> frameMillis; // 그 프레임에서의 합
+        for (const ProfileEvent* event : events) {
+            size_t index = summary.size();
+            for (size_t i = trackStart; i < summary.size(); ++i) {
+                if (summary[i].depth == event->depth && strcmp(summary[i].name, event->name) == 0) {
+                    index = i;
+                    break;
+                }
+            }
+            if (index == summary.size()) {
+                summary.push_back({ track.name, event->name, event->depth, 0.0, 0.0, 0 });
+                entryFrames.push_back(event->frame);
+                frameMillis.push_back(0.0);
+            }
+            ProfileSummary& entry = summary[index];
+            size_t local = index - trackStart;
+            if (entryFrames[local] != event->frame) {
+                entry.maxMillis = std::max(entry.maxMillis, frameMillis[local]);
+                entryFrames[local] = event->frame;
+                frameMillis[local] = 0.0;
+            }
+            double millis = event->durationNanos / 1000000.0;
+            frameMillis[local] += millis;
+            entry.meanMillis += millis; // 아래에서 프레임 수로 나눔
+            entry.count++;
+        }
+        for (size_t i = trackStart; i < summary.size(); ++i) {
+            summary[i].maxMillis = std::max(summary[i].maxMillis, frameMillis[i - trackStart]);
+        }
+    }
+
+    for (ProfileSummary& entry : summary) {
+        entry.meanMillis /= frames;
+    }
+    return summary;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+/**
+ update(), draw() 의 어느 구간에서 프레임 시간이 쓰이는지 확인하기 위한 계층형 구간(scope) 프로파일러.
+
+ - 측정하고 싶은 블록 맨 위에 PROFILE_SCOPE("이름") 을 적으면, 블록이 끝날 때 시작 시각, 걸린 시간, 중첩 깊이가 기록됨.
+ - 스레드마다 고정 크기 링 버퍼를 하나씩 가지고 있어서, 기록할 때 다른 스레드와 경쟁하지 않음.
+   링 버퍼는 그 스레드만 쓰는 단일 생산자 버퍼라서 기록할 때 락을 잡지 않고, 기록을 다 쓴 뒤 atomic 쓰기 인덱스만 올림.
+   collect() 는 쓰기 인덱스까지 복사한 뒤 인덱스를 다시 읽어서, 복사하는 동안 덮어써졌을 수 있는 기록은 버림.
+   버퍼가 가득 차면 가장 오래된 기록부터 덮어씀.
+ - GPU 시간처럼 스레드가 아닌 곳에서 측정한 값은 createTrack() 으로 만든 트랙에 addEvent() 로 직접 넣음. (gpuProfiler.h)
+ - collect() 로 모든 트랙의 기록을 모아서 writeChromeTrace() 로 크롬 trace-event JSON 파일로 저장하면,
+   크롬의 chrome://tracing 이나 Perfetto 에서 타임라인으로 볼 수 있음.
+
+ 이 파일에는 GL 호출이 없으므로 창 없이도 돌려볼 수 있음.
+ 이름 문자열은 포인터만 저장하므로, 문자열 리터럴처럼 프로그램이 끝날 때까지 살아있는 문자열을 넘겨야 함.
+ */
+
+struct ProfileEvent {
+    const char* name;
+    int64_t startNanos; // FrameProfiler 를 만든 시각 기준
+    int64_t durationNanos;
+    uint32_t frame; // 기록할 때의 프레임 번호 (beginFrame() 호출 횟수)
+    uint16_t depth; // 같은 트랙에서 몇 번째로 중첩된 구간인지 (가장 바깥 구간이 0)
+};
+
+// collect() 결과. 트랙(스레드 또는 GPU) 하나의 기록들
+struct ProfileTrack {
+    int id;
+    std::string name;
+    std::vector<ProfileEvent> events; // 기록된 순서 (= 구간이 끝난 순서)
+};
+
+class FrameProfiler {
+    public:
+        static const size_t RING_CAPACITY = 4096; // 트랙마다 보관하는 최대 기록 수
+        static const int MAX_DEPTH = 32;
+
+        FrameProfiler();
+
+        // 앱 전체에서 사용하는 프로파일러. PROFILE_SCOPE() 는 이 프로파일러에 기록함.
+        static FrameProfiler& get();
+
+        // false 면 begin(), end(), addEvent() 가 아무것도 하지 않음.
+        void setEnabled(bool enabled) { this->enabled = enabled; }
+        bool isEnabled() const { return enabled; }
+
+        void beginFrame() { frame++; }
+        uint32_t getFrame() const { return frame; }
+
+        // 현재 스레드의 트랙에 구간을 시작하고 끝냄. 보통 직접 부르지 않고 ProfileScope 를 사용함.
+        void begin(const char* name);
+        void end();
+
+        // 현재 스레드의 트랙 이름을 지정함. (chrome trace 에 스레드 이름으로 표시됨)
+        void setThreadName(const std::string& name);
+
+        // 스레드가 아닌 트랙을 만들고, 그 트랙에 이미 측정한 구간을 넣음. (링 버퍼가 단일 생산자용이므로 트랙 하나에는 한 스레드에서만 addEvent() 해야 함)
+        int createTrack(const std::string& name);
+        void addEvent(int track, const ProfileEvent& event);
+
+        // 프로파일러 기준 현재 시각
+        int64_t now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count(); }
+
+        // 모든 트랙에 남아있는 기록을 복사해서 리턴함. 종료된 스레드의 트랙은 한 번 읽어간 뒤 지워짐.
+        std::vector<ProfileTrack> collect();
+
+        // 모든 기록을 지움. (링 버퍼의 기록은 그대로 두고, collect() 가 지금까지의 기록을 건너뛰게 함)
+        void clear();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        /**
+         링 버퍼의 칸 하나. collect() 가 기록 중인 칸을 동시에 읽을 수 있으므로, ProfileEvent 를 8바이트 atomic 들에 나눠서 저장함.
+         (memory_order_relaxed 로 읽고 쓰면 일반 메모리 읽기, 쓰기와 같은 명령이 됨. 찢어진 값은 collect() 가 written 을 다시 읽어서 버림)
+         */
+        struct Slot {
+            static const size_t WORDS = (sizeof(ProfileEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+            std::atomic<uint64_t> words[WORDS];
+
+            void store(const ProfileEvent& event);
+            ProfileEvent load() const;
+        };
+
+        struct Ring {
+            int id;
+            std::mutex nameMutex; // name 만 보호함. (기록할 때는 잡지 않음)
+            std::string name;
+            std::unique_ptr<Slot[]> slots; // RING_CAPACITY 개를 미리 할당해 둠
+            std::atomic<uint64_t> written{0}; // 지금까지 기록한 수 (written % RING_CAPACITY 위치에 다음 기록을 씀). 기록하는 스레드만 올림
+            std::atomic<uint64_t> clearedAt{0}; // clear() 했을 때의 written. collect() 는 이 이후의 기록만 읽음
+            std::atomic<bool> retired{false}; // 스레드가 종료됨
+        };
+
+        // 스레드마다 하나씩 생기는 상태. 스레드가 끝나면 소멸자에서 링 버퍼를 retired 로 표시함.
+        struct ThreadState {
+            FrameProfiler* owner = nullptr;
+            std::shared_ptr<Ring> ring;
+            int64_t starts[MAX_DEPTH];
+            const char* names[MAX_DEPTH];
+            int depth = 0;
+
+            ~ThreadState();
+        };
+
+        ThreadState& getThreadState();
+        std::shared_ptr<Ring> addRing(const std::string& name);
+        static void push(Ring& ring, const ProfileEvent& event);
+
+        Clock::time_point epoch;
+        bool enabled = true;
+        std::atomic<uint32_t> frame{0};
+
+        std::mutex ringsMutex;
+        std::vector<std::shared_ptr<Ring>> rings;
+        int nextTrackId = 1;
+};
+
+// 생성될 때 구간을 시작하고, 소멸될 때 (블록을 벗어날 때) 구간을 끝냄.
+class ProfileScope {
+    public:
+        explicit ProfileScope(const char* name) : profiler(FrameProfiler::get()), active(profiler.isEnabled()) {
+            if (active) profiler.begin(name);
+        }
+        ~ProfileScope() {
+            if (active) profiler.end();
+        }
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        FrameProfiler& profiler;
+        bool active; // 구간 도중에 setEnabled() 가 바뀌어도 begin(), end() 짝이 맞도록 생성할 때 값을 기억함
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+/**
+ collect() 결과를 크롬 trace-event JSON 형식으로 씀.
+
+ 구간 하나가 "ph": "X" (complete event) 이벤트 하나가 되고, 트랙 하나가 스레드(tid) 하나로 표시됨.
+ 시간 단위는 마이크로초.
+ */
+void writeChromeTrace(const std::vector<ProfileTrack>& tracks, std::ostream& out);
+bool saveChromeTrace(const std::vector<ProfileTrack>& tracks, const std::string& path); // 경로는 ofToDataPath() 기준
+
+// 화면 오버레이에 표시할 구간별 통계
+struct ProfileSummary {
+    std::string track;
+    const char* name;
+    uint16_t depth;
+    double meanMillis; // 프레임당 합의 평균
+    double maxMillis; // 프레임당 합 중 가장 큰 값 (한 프레임에 여러 번 불리면 합한 값으로 비교함)
+    int count; // 통계에 포함된 구간 수
+};
+
+/**
+ tracks 에서 [firstFrame, lastFrame] 프레임에 기록된 구간들을 트랙, 이름별로 묶어서 프레임당 평균 시간을 구함.
+ 트랙 순서, 처음 나온 순서대로 정렬되어 있어서, 깊이만큼 들여쓰기하면 호출 계층처럼 보임.
+ */
+std::vector<ProfileSummary> summarizeFrames(const std::vector<ProfileTrack>& tracks, uint32_t firstFrame, uint32_t lastFrame);
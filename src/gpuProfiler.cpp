@@ -0,0 +1,112 @@
+#include "gpuProfiler.h"
+
+//--------------------------------------------------------------
+GpuProfiler::~GpuProfiler() {
+    if (!available) {
+        return;
+    }
+    for (FrameSlot& slot : slots) {
+        glDeleteQueries((GLsizei)slot.queries.size(), slot.queries.data());
+    }
+}
+
+bool GpuProfiler::setup(FrameProfiler& frameProfiler) {
+    profiler = &frameProfiler;
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    available = major > 3 || (major == 3 && minor >= 3);
+    if (!available) {
+        ofLogNotice("GpuProfiler") << "setup(): GL " << major << "." << minor << " has no timestamp queries, GPU timings disabled";
+        return false;
+    }
+
+    for (FrameSlot& slot : slots) {
+        slot.queries.resize(MAX_SCOPES * 2);
+        glGenQueries((GLsizei)slot.queries.size(), slot.queries.data());
+        slot.scopes.reserve(MAX_SCOPES);
+    }
+    track = profiler->createTrack("GPU");
+    calibrate();
+    return true;
+}
+
+// GPU 타임스탬프와 CPU 시각의 차이를 구해둠. (두 시계가 조금씩 어긋나므로 주기적으로 다시 구함)
+void GpuProfiler::calibrate() {
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    gpuToCpuNanos = profiler->now() - gpuNow;
+}
+
+//--------------------------------------------------------------
+void GpuProfiler::beginFrame() {
+    if (!available) {
+        return;
+    }
+    frames++;
+    current = (int)(frames % FRAMES_IN_FLIGHT);
+
+    // 이 슬롯을 다시 쓰기 전에, FRAMES_IN_FLIGHT 프레임 전에 넣어둔 쿼리 결과를 읽어감.
+    FrameSlot& slot = slots[current];
+    readResults(slot);
+    slot.scopes.clear();
+    slot.usedQueries = 0;
+    slot.frame = profiler->getFrame();
+    openScopes.clear();
+
+    if (frames % 60 == 0) {
+        calibrate();
+    }
+}
+
+void GpuProfiler::readResults(FrameSlot& slot) {
+    for (const Scope& scope : slot.scopes) {
+        if (scope.endQuery < 0) {
+            continue;
+        }
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(slot.queries[scope.beginQuery], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(slot.queries[scope.endQuery], GL_QUERY_RESULT, &end);
+
+        ProfileEvent event;
+        event.name = scope.name;
+        event.startNanos = (int64_t)start + gpuToCpuNanos;
+        event.durationNanos = (int64_t)(end - start);
+        event.frame = slot.frame;
+        event.depth = scope.depth;
+        profiler->addEvent(track, event);
+    }
+}
+
+void GpuProfiler::begin(const char* name) {
+    FrameSlot& slot = slots[current];
+    // 프로파일러가 꺼져 있거나 쿼리를 다 쓰면 구간을 기록하지 않음. (end() 와 짝을 맞추기 위해 -1 을 넣어둠)
+    if (!profiler->isEnabled() || slot.usedQueries + 2 > (int)slot.queries.size()) {
+        openScopes.push_back(-1);
+        return;
+    }
+    Scope scope;
+    scope.name = name;
+    scope.depth = (uint16_t)openScopes.size();
+    scope.beginQuery = slot.usedQueries++;
+    scope.endQuery = -1;
+    glQueryCounter(slot.queries[scope.beginQuery], GL_TIMESTAMP);
+    openScopes.push_back((int)slot.scopes.size());
+    slot.scopes.push_back(scope);
+}
+
+void GpuProfiler::end() {
+    if (openScopes.empty()) {
+        return;
+    }
+    int index = openScopes.back();
+    openScopes.pop_back();
+    if (index < 0) {
+        return;
+    }
+    FrameSlot& slot = slots[current];
+    Scope& scope = slot.scopes[index];
+    scope.endQuery = slot.usedQueries++;
+    glQueryCounter(slot.queries[scope.endQuery], GL_TIMESTAMP);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ofMain.h"
+#include "frameProfiler.h"
+
+/**
+ GL 타임스탬프 쿼리로 GPU 에서 실제로 걸린 시간을 재서 FrameProfiler 의 "GPU" 트랙에 넣어주는 프로파일러.
+
+ CPU 구간(PROFILE_SCOPE)은 드로우콜을 GL 에 넘기는 시간만 재므로, GPU 가 그 드로우콜을 처리하는 데 걸린 시간은 따로 재야 함.
+ 구간의 시작과 끝에 glQueryCounter(GL_TIMESTAMP) 를 하나씩 넣어두고, 결과는 GPU 가 따라잡은 뒤
+ (FRAMES_IN_FLIGHT 프레임 뒤) 에 읽어서 CPU 타임라인 시각으로 바꿔 기록함. 그래서 결과를 기다리느라 CPU 가 멈추지 않음.
+
+ 타임스탬프 쿼리는 GL 3.3 부터 지원하므로, 그보다 낮은 컨텍스트이거나 setup() 하지 않으면 (헤드리스 모드) 아무것도 하지 않음.
+ */
+class GpuProfiler {
+    public:
+        static const int FRAMES_IN_FLIGHT = 4; // 쿼리 결과를 읽기 전까지 기다리는 프레임 수
+        static const int MAX_SCOPES = 64; // 프레임당 최대 구간 수
+
+        ~GpuProfiler();
+
+        // GL 컨텍스트가 만들어진 뒤 호출해야 함. 타임스탬프 쿼리를 지원하면 true
+        bool setup(FrameProfiler& profiler = FrameProfiler::get());
+        bool isAvailable() const { return available; }
+
+        // 프레임을 시작할 때 호출함. FRAMES_IN_FLIGHT 프레임 전에 넣어둔 쿼리 결과를 읽어서 기록함.
+        void beginFrame();
+
+        void begin(const char* name);
+        void end();
+
+    private:
+        struct Scope {
+            const char* name;
+            uint16_t depth;
+            int beginQuery, endQuery; // queries 의 인덱스 (endQuery 가 -1 이면 아직 end() 를 안 함)
+        };
+
+        struct FrameSlot {
+            std::vector<GLuint> queries; // MAX_SCOPES * 2 개
+            std::vector<Scope> scopes;
+            int usedQueries = 0;
+            uint32_t frame = 0;
+        };
+
+        void readResults(FrameSlot& slot);
+        void calibrate();
+
+        FrameProfiler* profiler = nullptr;
+        bool available = false;
+        int track = -1;
+        FrameSlot slots[FRAMES_IN_FLIGHT];
+        int current = 0;
+        uint64_t frames = 0;
+        std::vector<int> openScopes; // 현재 프레임에서 아직 end() 하지 않은 scopes 인덱스
+        int64_t gpuToCpuNanos = 0; // GPU 타임스탬프 + 이 값 = FrameProfiler 시각
+};
+
+// 생성될 때 GPU 구간을 시작하고, 소멸될 때 끝냄. profiler 가 nullptr 이면 아무것도 하지 않음.
+class GpuProfileScope {
+    public:
+        GpuProfileScope(GpuProfiler* profiler, const char* name) : profiler(profiler && profiler->isAvailable() ? profiler : nullptr) {
+            if (this->profiler) this->profiler->begin(name);
+        }
+        ~GpuProfileScope() {
+            if (profiler) profiler->end();
+        }
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        GpuProfiler* profiler;
+};
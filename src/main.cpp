@@ -1,16 +1,108 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "ofAppNoWindow.h"
+#include "benchmarks.h"
 
 //========================================================================
-int main( ){
+int main(int argc, char* argv[]){
+    /**
+     --headless 인자를 주면 창과 GL 컨텍스트를 만들지 않고, 소프트웨어 래스터라이저로 장면을 이미지 파일로 렌더링함.
+     (GPU 가 없는 CI, 렌더팜 노드에서 변환 결과를 확인하거나 미리보기 이미지를 만들 때 사용)
+
+     예) matrix-transform --headless --output preview.png --size 1920x1440 --threads 8 --frames 100
+
+     --compare 인자로 기준 이미지(golden image)를 주면 렌더링 결과를 비교해서, 다르면 종료 코드 1 로 종료함.
+     bin/data/golden 의 기준 이미지들은 각각 아래 인자로 렌더링한 결과임. (렌더링 결과가 의도적으로 바뀌면 --output 으로 다시 만들어서 교체함)
+
+     예) matrix-transform --headless --compare golden/forest_1024x768.png
+         matrix-transform --headless --size 512x384 --frames 30 --compare golden/forest_512x384_30frames.png
+
+     헤드리스 모드에서는 프로파일러가 아무것도 기록하지 않고, --trace 인자를 주면 CPU 구간 기록을 크롬 트레이스 파일로 저장함.
+
+     예) matrix-transform --headless --frames 100 --trace headless_trace.json
+
+     --bench raster 는 두 기준 이미지를 위 설정으로 다시 렌더링해서 비교하고, 해상도, 스레드 수별 초당 프레임 수를 출력함. (CI 에서 사용)
+
+     --walkers 인자를 주면 (창 모드, 헤드리스 모드 모두) 배경에 지정한 수만큼 걸어다니는 군중을 추가함.
+     스레드 수별 워커 하나당 갱신 시간(ns)은 --bench walkers 로 측정함.
+
+     예) matrix-transform --walkers 100000 --walker-threads 4
+
+     --clouds 인자를 주면 하늘에 반투명 구름을 지정한 수만큼 더 띄움. 'o' 키로 반투명 패스 방식(깊이 정렬, OIT)을 바꿔가며
+     프로파일러 오버레이의 sort, cloud, oit resolve 구간 시간을 비교할 수 있음.
+
+     --scene 인자로 bin/data 의 다른 장면 파일(텍스트 .scene 또는 바이너리 .scnb)을 로드할 수 있음. (기본값 forest.scene)
+     --scene-stress 인자를 주면 장면 파일에 스프라이트를 지정한 수만큼 더한 장면 파일을 만들어서 로드함.
+     스프라이트를 읽는 대로 그리기 시작하고, 다 읽으면 파싱 속도(MB/s, entities/s)를 로그로 출력함.
+     (처음 실행은 텍스트 파일, 다음 실행부터는 바이너리 캐시를 읽으므로 두 형식의 속도를 비교할 수 있음)
+
+     예) matrix-transform --scene-stress 1000000
+
+     창 모드로 실행하고 종료하면 시뮬레이션 입력 기록을 bin/data/simulation.simlog 에 저장함.
+     --replay 인자로 기록 파일을 주면 창을 만들지 않고 기록을 다시 돌려서, 최종 상태가 기록과 비트 단위로 다르면 종료 코드 1 로 종료함.
+
+     예) matrix-transform --replay simulation.simlog
+
+     --bench 인자를 주면 창을 만들지 않고 지정한 벤치마크만 돌린 뒤 종료함. 결과 검증에 실패하면 종료 코드가 0 이 아님. (benchmarks.h 참고)
+
+     예) matrix-transform --bench transform
+     */
+    HeadlessSettings headless;
+    CrowdSettings crowd;
+    SceneSettings scene;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--headless") {
+            headless.enabled = true;
+        } else if (arg == "--output" && hasValue) {
+            headless.output = argv[++i];
+        } else if (arg == "--compare" && hasValue) {
+            headless.compare = argv[++i];
+        } else if (arg == "--trace" && hasValue) {
+            headless.trace = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            headless.threads = ofToInt(argv[++i]);
+        } else if (arg == "--frames" && hasValue) {
+            headless.frames = std::max(1, ofToInt(argv[++i]));
+        } else if (arg == "--walkers" && hasValue) {
+            crowd.walkers = std::max(0, ofToInt(argv[++i]));
+        } else if (arg == "--walker-threads" && hasValue) {
+            crowd.threads = ofToInt(argv[++i]);
+        } else if (arg == "--clouds" && hasValue) {
+            crowd.clouds = std::max(0, ofToInt(argv[++i]));
+        } else if (arg == "--scene" && hasValue) {
+            scene.file = argv[++i];
+        } else if (arg == "--scene-stress" && hasValue) {
+            scene.stressSprites = std::max(0, ofToInt(argv[++i]));
+        } else if (arg == "--bench" && hasValue) {
+            return runBenchmark(argv[++i]);
+        } else if (arg == "--replay" && hasValue) {
+            SimRecording recording;
+            return loadSimRecording(argv[++i], recording) && verifySimRecording(recording) ? 0 : 1;
+        } else if (arg == "--size" && hasValue) {
+            std::vector<std::string> size = ofSplitString(argv[++i], "x");
+            if (size.size() == 2) {
+                headless.width = ofToInt(size[0]);
+                headless.height = ofToInt(size[1]);
+            }
+        }
+    }
+
+    if (headless.enabled) {
+        auto window = std::make_shared<ofAppNoWindow>(); // 아무것도 화면에 띄우지 않는 윈도우. update(), draw() 루프만 돌려줌.
+        ofSetupOpenGL(window, headless.width, headless.height, OF_WINDOW);
+        return ofRunApp(new ofApp(headless, crowd, scene)); // --compare 로 비교한 결과가 다르면 1
+    }
+
     // 아래 5줄은 초기의 main() 함수에서 원하는 버전의 OpenGL 을 사용하기 위해 수정해줘야 하는 부분들
     ofGLWindowSettings glSettings;
     glSettings.setSize(1024, 768);
     glSettings.windowMode = OF_WINDOW;
     glSettings.setGLVersion(4, 1);
     ofCreateWindow(glSettings); // 설정이 변경된 윈도우 설정 of 객체를 ofCreateWindow() 함수에 전달해주면 실행창(윈도우)를 열어줌.
-    
+
     // ofApp 객체 실행
-    ofRunApp(new ofApp());
+    ofRunApp(new ofApp(HeadlessSettings(), crowd, scene));
 
 }
@@ -1,4 +1,5 @@
 #include "ofApp.h"
+#include "transformBatch.h"
 
 // 캐릭터 텍스쳐를 입힐 쿼드 메쉬 생성 함수를 따로 밖으로 빼서 정리함.
 void buildMesh(ofMesh& mesh, float w, float h, glm::vec3 pos) {
@@ -33,6 +34,7 @@ void buildMesh(ofMesh& mesh, float w, float h, glm::vec3 pos) {
 };
 
 // 이동, 회전 각도, 크기 벡터를 받아 세 개를 모두 합친 변환행렬을 리턴해주는 함수
+// (여러 오브젝트의 행렬을 한꺼번에 계산할 때는 transformBatch.h 의 buildMatrices() 를 사용함. 결과는 이 함수와 같음.)
 glm::mat4 buildMatrix(glm::vec3 trans, float rot, glm::vec3 scale) {
     using glm::mat4; // 이후 코드에서 등장하는 mat4 키워드는 glm 라이브러리의 mat4 타입이라고 선언하는 거겠지
     
@@ -62,47 +64,848 @@ glm::mat4 buildViewMatrix(CameraData cam) {
      
      그래서 inverse() 오픈프레임웍스 내장함수로
      리턴받은 모델행렬의 역행렬을 구해서 최종적인 뷰행렬을 리턴해주는 것.
+     
+     -> inverse(buildMatrix(...)) 는 범용 4*4 역행렬 계산이라 비싸므로,
+     TRS 행렬의 역행렬을 닫힌 형태로 바로 계산하는 inverseTRS() 로 대체함. (transformBatch.h 참고)
      */
-    return inverse(buildMatrix(cam.position, cam.rotation, vec3(1, 1, 1))); // 카메라 위치, 카메라 회전값, 카메라 크기(크기는 의미가 없으므로, (1, 1, 1)로 고정이랬지?)을 전달.
+    // return inverse(buildMatrix(cam.position, cam.rotation, vec3(1, 1, 1)));
+    return inverseTRS(cam.position, cam.rotation, vec3(1, 1, 1)); // 카메라 위치, 카메라 회전값, 카메라 크기(크기는 의미가 없으므로, (1, 1, 1)로 고정이랬지?)을 전달.
 }
 
 //--------------------------------------------------------------
 void ofApp::setup(){
+    uint64_t setupStart = ofGetElapsedTimeMicros(); // 시작 시간 측정 (아래에서 단계별 시간을 로그로 출력함)
+    FrameProfiler::get().setThreadName("main");
+    if (headless.enabled) {
+        FrameProfiler::get().setEnabled(!headless.trace.empty()); // 헤드리스 모드에는 오버레이가 없으므로 --trace 로 요청했을 때만 기록함.
+    }
     ofDisableArbTex(); // 스크린 픽셀 좌표를 사용하는 텍스쳐 관련 오픈프레임웍스 레거시 지원 설정 비활성화
     ofEnableDepthTest(); // 깊이테스트를 활성화하여 z좌표값을 깊이버퍼에 저장해서 z값을 기반으로 앞뒤를 구분하여 렌더링할 수 있도록 함.
     
-    buildMesh(charMesh, 0.1, 0.2, glm::vec3(0.0, -0.2, 0.0)); // 캐릭터메쉬 생성
-    // buildMesh(backgroundMesh, 1.0, 1.0, glm::vec3(0.0, 0.0, 0.5)); // 배경메쉬 생성
-    buildMesh(backgroundMesh, 1.0, 1.0, glm::vec3(0.0, 0.0, -0.5)); // 아래 draw() 에서 직교투영행렬의 near, far값에 의해 프러스텀의 z축 범위가 0 ~ -10 으로 설정됨에 따라, 배경메쉬의 z값이 0.5가 되면 프러스텀을 벗어나서 화면에 렌더가 안됨. 그러므로, 배경메쉬 생성 시 버텍스의 z값을 -0.5 로 바꿔서 하던지, 아니면 초기에 0으로 설정을 해놓고 draw() 함수에서 translate(0.0, 0.0, -0.5) 이런식으로 z값만 -0.5만큼 이동시키는 이동변환행렬을 만들어서 배경메쉬가 사용하는 버텍스 셰이더에 쏴줘서 적용할 수 있도록 하던지 해야 함.
-    buildMesh(cloudMesh, 0.25, 0.15, glm::vec3(0.0, 0.0, 0.0)); // 구름메쉬 생성
-    buildMesh(sunMesh, 1.0, 1.0, glm::vec3(0.0, 0.0, 0.4)); // 태양메쉬 생성
+    /**
+     장면 파일을 열고 헤더(카메라, 셰이더, 텍스쳐, 메쉬, 노드)만 먼저 읽음. 스프라이트는 아래에서 로더 스레드를 시작한 뒤 읽는 대로 추가함.
+     텍스트 파일을 끝까지 읽으면 같은 내용의 바이너리 캐시(.scnb)를 저장해두고, 캐시가 텍스트 파일보다 새로우면 캐시를 대신 읽음.
+     캐시가 깨졌으면 (SceneLoader::hasError()) 캐시를 지우고 텍스트 파일을 읽음. (헤더는 여기서, 스프라이트는 updateSceneStreaming() 에서 확인함)
+     */
+    if (sceneSettings.stressSprites > 0) {
+        sceneSettings.file = writeStressScene();
+    }
+    std::string scenePath = sceneSettings.file;
+    std::string sceneCache = ofFilePath::removeExt(sceneSettings.file) + ".scnb";
+    if (ofFilePath::getFileExt(sceneSettings.file) != "scnb" && getModifiedTime(sceneCache) > getModifiedTime(sceneSettings.file)) {
+        scenePath = sceneCache;
+    }
+    bool sceneOpened = sceneLoader.open(scenePath, scene);
+    if (!sceneOpened && sceneLoader.hasError() && scenePath != sceneSettings.file) {
+        ofLogWarning("ofApp") << "scene: cache " << sceneCache << " is broken, removed it and loading " << sceneSettings.file;
+        std::remove(ofToDataPath(sceneCache).c_str());
+        scene = SceneHeader();
+        scenePath = sceneSettings.file;
+        sceneOpened = sceneLoader.open(scenePath, scene);
+    }
+    if (!sceneOpened) {
+        ofLogError("ofApp") << "could not load scene " << scenePath << ", nothing to draw";
+    }
+    cam.position = scene.camera.position;
+    cam.rotation = scene.camera.rotation;
+    
+    // 이미지 4개를 따로 로드하는 대신 하나로 합쳐둔 텍스쳐 아틀라스를 로드함. (처음 실행할 때는 아틀라스를 만들어서 저장함)
+    // 페이지 텍스쳐는 assetLoader 의 워커 스레드에서 로드되므로, 기다리지 않고 셰이더, 메쉬 준비를 계속 진행함.
+    std::vector<std::shared_future<TextureDataPtr>> pageLoads = setupAtlas();
+    uint64_t atlasMicros = ofGetElapsedTimeMicros() - setupStart;
+    
+    if (headless.enabled) {
+        // 헤드리스 모드에서는 셰이더를 로드하는 대신, 각 셰이더가 하는 일을 소프트웨어 래스터라이저의 프로그램으로 등록함. (addSceneShader() 참고)
+        rasterizer.setup(headless.width, headless.height, headless.threads);
+        rasterizer.setClearColor(backgroundColor);
+    } else {
+        ofBackground(backgroundColor);
+        // 스프라이트 렌더러에 셰이더, 텍스쳐, 메쉬를 등록하고, 배치에 submit 할 때 사용할 id 를 받아둠.
+        spriteRenderer.setup();
+        oit.setup(ofGetWidth(), ofGetHeight());
+        
+        // GL 타임스탬프 쿼리를 지원하면 그룹마다 GPU 시간도 같이 기록함.
+        gpuProfiler.setup();
+        spriteRenderer.setGpuProfiler(&gpuProfiler);
+    }
+    for (const SceneShaderDesc& shader : scene.shaders) {
+        addSceneShader(shader);
+    }
+    for (const SceneMeshDesc& mesh : scene.meshes) {
+        addSceneMesh(mesh);
+    }
+    
+    // 셰이더, 메쉬 준비가 끝났으면 아틀라스 페이지 로드가 끝나기를 기다렸다가 텍스쳐로 등록함.
+    uint64_t waitStart = ofGetElapsedTimeMicros();
+    bool warmCache = !pageLoads.empty();
+    atlasTextures.resize(pageLoads.size()); // spriteRenderer 는 텍스쳐 포인터를 보관하므로, 텍스쳐 배열 크기를 먼저 정해두고 등록함.
+    for (size_t i = 0; i < pageLoads.size(); ++i) {
+        TextureDataPtr page = pageLoads[i].get();
+        ofPixels pixels;
+        if (page) {
+            warmCache = warmCache && page->fromCache;
+            pixels = page->wrapLevel(0);
+        } else {
+            // 로드에 실패한 페이지는 투명한 1x1 텍스쳐로 대신해서, 해당 페이지의 스프라이트만 안 보이도록 함.
+            pixels.allocate(1, 1, OF_PIXELS_RGBA);
+            pixels.set(0);
+            warmCache = false;
+        }
+        
+        if (headless.enabled) {
+            // GL 텍스쳐와 똑같이 샘플링하도록 밉맵 레벨들을 모두 넘김.
+            std::vector<ofPixels> levels;
+            for (size_t level = 0; page && level < page->levels.size(); ++level) {
+                levels.push_back(page->wrapLevel((int)level));
+            }
+            atlasPageTexIds.push_back(rasterizer.addTexture(page ? levels : std::vector<ofPixels>{ pixels }));
+        } else {
+            if (page) {
+                loadTextureData(atlasTextures[i], *page); // 메모리 맵된 캐시 데이터를 복사 없이 바로 업로드함.
+            } else {
+                atlasTextures[i].loadData(pixels);
+            }
+            atlasPageTexIds.push_back(spriteRenderer.addTexture(atlasTextures[i]));
+        }
+    }
+    uint64_t now = ofGetElapsedTimeMicros();
+    ofLogNotice("ofApp") << "startup: atlas " << (atlasMicros / 1000.0) << " ms, shaders + meshes " << ((waitStart - setupStart - atlasMicros) / 1000.0)
+        << " ms, waited " << ((now - waitStart) / 1000.0) << " ms for " << pageLoads.size() << " atlas pages (" << (warmCache ? "warm cache" : "decoded")
+        << ", " << assetLoader.getNumThreads() << " loader threads), total " << ((now - setupStart) / 1000.0) << " ms";
+    
+    /**
+     각 스프라이트의 모델행렬을 계산할 변환 노드들을 추가함.
+     
+     배경처럼 움직이지 않는 노드들은 처음 update() 에서 한 번만 계산되고 이후로는 다시 계산되지 않음.
+     장면 파일의 노드(sky)는 스프라이트들의 부모 노드이고, 스프라이트마다 자기 위치, 회전, 크기를 가진 노드가 하나씩 더 생김.
+     */
+    for (const SceneNodeDesc& node : scene.nodes) {
+        addSceneNode(node);
+    }
+    sceneGraph.update(); // 격자에 넣을 월드 공간 범위를 구하기 위해 월드행렬을 미리 계산해 둠.
+    
+    /**
+     스프라이트는 로더 스레드에서 읽기 시작하고, 읽은 묶음을 update() 에서 프레임마다 몇 개씩 추가함.
+     그래서 스프라이트가 아주 많은 장면도 다 읽기를 기다리지 않고 먼저 읽은 스프라이트부터 그리기 시작함.
+     헤드리스 모드는 출력 이미지가 항상 같아야 하므로 여기서 끝까지 읽고 시작함.
+     */
+    if (sceneOpened) {
+        sceneLoader.start();
+        sceneStreaming = true;
+        if (headless.enabled) {
+            updateSceneStreaming(true);
+        }
+    }
+    
+    // 반투명 구름이 많이 겹칠 때 깊이 정렬과 OIT 비용을 비교하기 위한 구름들. 깊이가 제각각이라 submit 순서로 그리면 앞뒤가 틀리게 보임.
+    int skyNode = scene.findNode("sky");
+    int cloudMesh = scene.findMesh("cloud");
+    int cloudShader = scene.findShader("cloud");
+    int cloudTexture = scene.findTexture("cloud");
+    if (crowd.clouds > 0 && skyNode >= 0 && cloudMesh >= 0 && cloudShader >= 0 && cloudTexture >= 0 && textureFrames[cloudTexture] >= 0) {
+        ofSeedRandom(5678);
+        std::vector<int> extraClouds;
+        for (int i = 0; i < crowd.clouds; ++i) {
+            glm::vec3 pos(ofRandom(-1.3, 1.3), ofRandom(0.0, 0.9), ofRandom(-0.45, 0.0));
+            float scale = ofRandom(0.3, 1.0);
+            extraClouds.push_back(sceneGraph.addNode(sceneNodes[skyNode], pos, ofRandom(TWO_PI), glm::vec3(scale, scale, 1)));
+        }
+        sceneGraph.update();
+        const SceneMeshDesc& mesh = scene.meshes[cloudMesh];
+        for (int node : extraClouds) {
+            addSprite(node, SPRITE_PASS_TRANSPARENT, shaderIds[cloudShader], textureFrames[cloudTexture], meshIds[cloudMesh], quadBounds(mesh.halfWidth, mesh.halfHeight, mesh.offset));
+        }
+    }
+    
+    if (crowd.walkers > 0) {
+        setupCrowd();
+    }
+    
+    /**
+     구간 하나를 기록하는 데 드는 시간을 재둠. 오버레이에서 프레임당 구간 수를 곱해서 프로파일러 오버헤드를 추정함.
+     (측정용 구간 기록은 바로 지워서 트레이스에 남지 않도록 함)
+     */
+    const int calibrationScopes = 10000;
+    uint64_t calibrationStart = ofGetElapsedTimeMicros();
+    for (int i = 0; i < calibrationScopes; ++i) {
+        PROFILE_SCOPE("calibration");
+    }
+    profileScopeNanos = (ofGetElapsedTimeMicros() - calibrationStart) * 1000.0 / calibrationScopes;
+    FrameProfiler::get().clear();
+    
+    // 캐릭터 이동, 걷기 애니메이션, 구름 회전은 렌더링과 상관없이 60Hz 고정 틱으로 도는 시뮬레이션 스레드에서 진행함. (헤드리스 모드는 update() 참고)
+    if (!headless.enabled) {
+        simulation.start(60.0);
+        simView = simulation.sample();
+    }
+}
+
+//--------------------------------------------------------------
+/**
+ 배경에 걸어다니는 군중을 만듦.
+ 
+ 워커들은 장면 파일의 캐릭터메쉬와 걷기 스프라이트시트(walk 텍스쳐) 프레임을 같이 사용하고, 작게 줄여서 배경과 캐릭터 사이 깊이(z = -0.25)에 그림.
+ 화면 아래쪽 범위 안에서 오른쪽으로 걸어가다가 화면 밖으로 나가면 반대편에서 다시 나오므로, 컬링 격자에는 넣지 않음.
+ 스레드 수별 갱신 비용은 시작할 때마다 재지 않고 --bench walkers 로 측정함. (benchmarks.cpp)
+ */
+void ofApp::setupCrowd(){
+    int walkTexture = scene.findTexture("walk");
+    int charMesh = scene.findMesh("character");
+    int alphaTestShader = scene.findShader("alphaTest");
+    if (walkTexture < 0 || charMesh < 0 || alphaTestShader < 0 || textureFrames[walkTexture] < 0) {
+        ofLogWarning("ofApp") << "crowd: scene has no walk texture (or it is not in the atlas), character mesh or alphaTest shader";
+        return;
+    }
+    crowdShaderId = shaderIds[alphaTestShader];
+    crowdMeshId = meshIds[charMesh];
+    
+    std::vector<AtlasFrame> walkFrames;
+    for (int i = 0; i < scene.textures[walkTexture].frameCount; ++i) {
+        walkFrames.push_back(atlas.getFrame(textureFrames[walkTexture] + i));
+    }
+    walkerAnimation.setup(walkFrames, 12.0f, glm::vec2(-1.45, -0.95), glm::vec2(1.45, -0.15), 0.35f, -0.25f);
+    
+    // 매번 같은 군중이 나오도록 시드를 고정함. 걷는 속도가 다르면 애니메이션 속도도 달라 보이도록 사이클 시작 시간도 흩어놓음.
+    ofSeedRandom(1234);
+    WalkerSoA& walkers = walkerAnimation.getWalkers();
+    for (int i = 0; i < crowd.walkers; ++i) {
+        glm::vec2 pos(ofRandom(-1.45, 1.45), ofRandom(-0.95, -0.15));
+        glm::vec2 vel(ofRandom(0.1, 0.35), 0.0);
+        walkers.add(pos, vel, ofRandom(walkerAnimation.getCycleSeconds()));
+    }
+    crowdInstances.resize(walkers.size());
+    walkerAnimation.update(0.0f, crowdInstances.data(), crowd.threads); // 시간은 진행하지 않고 첫 프레임의 인스턴스 데이터만 채움
+    ofLogNotice("ofApp") << "crowd: " << walkers.size() << " walkers";
+}
+
+//--------------------------------------------------------------
+/**
+ 아틀라스 디스크립터를 로드하고, 페이지 텍스쳐 로드를 assetLoader 에 요청한 뒤 바로 리턴함.
+ 디스크립터가 없거나 원본 이미지가 아틀라스보다 나중에 수정됐으면, 원본 이미지들을 병렬로 디코딩해서 아틀라스를 다시 만들어서 저장함.
+ 장면 파일에 아틀라스에 없는 텍스쳐가 있거나 스프라이트시트 프레임 수가 다를 때도 다시 만듦.
+ 
+ 페이지 텍스쳐는 캐시 파일(atlas_0.texc)이 최신이면 PNG 디코딩 없이 메모리 맵으로 로드됨.
+ */
+std::vector<std::shared_future<TextureDataPtr>> ofApp::setupAtlas(){
+    const std::string descriptor = "atlas.bin"; // 페이지 이미지는 atlas_0.png, atlas_1.png, ... 로 저장됨
+    std::vector<std::string> files;
+    for (const SceneTextureDesc& texture : scene.textures) {
+        files.push_back(texture.file);
+    }
+    
+    // 아틀라스 패딩이 2픽셀이므로, 1번 레벨(패딩 1픽셀)까지만 옆 이미지가 섞이지 않음.
+    const int mipLevels = 2;
+    
+    bool current = !isAtlasStale(descriptor, files) && atlas.load(descriptor);
+    for (size_t i = 0; i < scene.textures.size() && current; ++i) {
+        current = atlas.findFrame(scene.textures[i].file) >= 0 && atlas.getFrameCount(scene.textures[i].file) == scene.textures[i].frameCount;
+    }
+    
+    std::vector<std::shared_future<TextureDataPtr>> pageLoads;
+    if (current) {
+        for (size_t i = 0; i < atlas.getNumPages(); ++i) {
+            pageLoads.push_back(assetLoader.loadTexture(TextureAtlas::getPagePath(descriptor, i), mipLevels));
+        }
+    } else if (!files.empty()) {
+        std::vector<std::shared_future<ofPixels>> decodes;
+        for (const std::string& file : files) {
+            decodes.push_back(assetLoader.loadPixels(file)); // 헤드리스 모드에서도 쓸 수 있도록 텍스쳐 없이 픽셀 데이터만 로드함.
+        }
+        
+        // 스프라이트시트(캐릭터 걷기 텍스쳐 등)는 장면 파일에 적힌 프레임 크기, 개수대로 잘라서 넣음.
+        std::vector<AtlasSource> sources(files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            const SceneTextureDesc& texture = scene.textures[i];
+            sources[i].name = texture.file;
+            sources[i].pixels = decodes[i].get();
+            if (texture.frameCount > 1) {
+                sources[i].frameSize = texture.frameSize;
+                sources[i].columns = texture.columns;
+                sources[i].frameCount = texture.frameCount;
+            }
+        }
+        
+        atlas.build(sources);
+        atlas.save(descriptor);
+        ofLogNotice("ofApp") << "texture atlas rebuilt: " << atlas.getNumPages() << " pages, " << atlas.getNumFrames() << " frames, packing efficiency " << atlas.getPackingEfficiency();
+        
+        // 방금 만든 페이지는 이미 메모리에 있으므로 다시 디코딩하지 않고, 밉맵과 캐시 파일만 만들어 둠.
+        for (size_t i = 0; i < atlas.getNumPages(); ++i) {
+            pageLoads.push_back(assetLoader.storeTexture(TextureAtlas::getPagePath(descriptor, i), atlas.getPages()[i], mipLevels));
+        }
+    }
+    
+    // 디코딩에 실패했거나 페이지보다 커서 아틀라스에 못 넣은 텍스쳐는 -1 로 남겨두고, 그 텍스쳐를 쓰는 스프라이트는 그리지 않음. (addSprite() 참고)
+    for (const SceneTextureDesc& texture : scene.textures) {
+        int frame = atlas.findFrame(texture.file);
+        if (frame < 0) {
+            ofLogError("ofApp") << "atlas: " << texture.file << " is not in the texture atlas, sprites using it are not drawn";
+        }
+        textureFrames.push_back(frame);
+    }
+    return pageLoads;
+}
+
+//--------------------------------------------------------------
+/**
+ 장면 파일의 셰이더를 로드해서 spriteRenderer 에 등록함. OIT 용 프래그먼트 셰이더가 있으면 같이 로드해서 OIT 모드에서 대신 사용하도록 함.
+ 
+ 헤드리스 모드에서는 셰이더 대신 같은 일을 하는 소프트웨어 래스터라이저 프로그램을 등록함.
+ 래스터라이저에는 알파값으로 픽셀을 버리는 alphaTest.frag, 알파값을 그대로 블렌딩하는 cloud.frag 두 가지만 구현되어 있음.
+ */
+void ofApp::addSceneShader(const SceneShaderDesc& desc){
+    if (headless.enabled) {
+        shaderIds.push_back(rasterizer.addProgram(desc.frag == "cloud.frag" ? RASTER_FRAG_ALPHA_CLAMP : RASTER_FRAG_ALPHA_TEST));
+        oitShaderIds.push_back(-1);
+        sceneShaders.emplace_back();
+        sceneOITShaders.emplace_back();
+        return;
+    }
+    
+    std::unique_ptr<ofShader> shader(new ofShader());
+    shader->load(desc.vert, desc.frag);
+    shaderIds.push_back(spriteRenderer.addShader(*shader));
+    sceneShaders.push_back(std::move(shader));
+    
+    std::unique_ptr<ofShader> oitShader;
+    int oitShaderId = -1;
+    if (!desc.oitFrag.empty()) {
+        oitShader.reset(new ofShader());
+        oitShader->load(desc.vert, desc.oitFrag);
+        oitShaderId = spriteRenderer.addShader(*oitShader);
+        spriteRenderer.setOITVariant(shaderIds.back(), oitShaderId);
+    }
+    // OIT 용 셰이더가 없으면 OIT 모드에서도 이 셰이더의 반투명 스프라이트는 깊이 정렬해서 OIT 합성 뒤에 그림.
+    spriteBatch.setOrderDependentShader(shaderIds.back(), oitShaderId < 0);
+    oitShaderIds.push_back(oitShaderId);
+    sceneOITShaders.push_back(std::move(oitShader));
+}
+
+// 장면 파일의 메쉬 항목으로 쿼드 메쉬를 만들어서 등록함. 메쉬 이름은 그룹마다 기록하는 프로파일러 구간 이름이 됨.
+void ofApp::addSceneMesh(const SceneMeshDesc& desc){
+    ofMesh mesh;
+    buildMesh(mesh, desc.halfWidth, desc.halfHeight, desc.offset);
+    meshIds.push_back(headless.enabled ? rasterizer.addMesh(mesh) : spriteRenderer.addMesh(mesh, desc.name));
+}
+
+void ofApp::addSceneNode(const SceneNodeDesc& desc){
+    int parent = desc.parent >= 0 ? sceneNodes[desc.parent] : TransformHierarchy::NO_PARENT;
+    sceneNodes.push_back(sceneGraph.addNode(parent, desc.transform.position, desc.transform.rotation, desc.transform.scale));
+}
+
+//--------------------------------------------------------------
+/**
+ 로더 스레드가 읽은 스프라이트 묶음 하나를 장면에 추가함.
+ 
+ 스프라이트마다 노드를 하나씩 만들고, 월드행렬을 한꺼번에 계산한 뒤 격자에 넣음.
+ 코드에서 움직여야 하는 스프라이트(character, cloudA)는 이름으로 찾아서 노드와 인덱스를 기억해 둠.
+ */
+void ofApp::addSceneSprites(const std::vector<SceneSpriteDesc>& descs){
+    std::vector<int> nodes;
+    nodes.reserve(descs.size());
+    for (const SceneSpriteDesc& desc : descs) {
+        int parent = desc.parent >= 0 ? sceneNodes[desc.parent] : TransformHierarchy::NO_PARENT;
+        nodes.push_back(sceneGraph.addNode(parent, desc.transform.position, desc.transform.rotation, desc.transform.scale));
+    }
+    sceneGraph.update();
+    // 새 노드 말고도 다시 계산된 노드가 있으면 (핫 리로드로 옮긴 노드, 스트리밍 중에 움직인 캐릭터 등) 여기서 격자까지 갱신함.
+    // getUpdatedNodes() 는 마지막 update() 결과만 알려주므로, 다음 draw() 의 update() 에서는 이 노드들이 바뀐 것으로 나오지 않음.
+    if (sceneGraph.getLastUpdateCount() > nodes.size()) {
+        updateSpriteBounds();
+    }
+    
+    for (size_t i = 0; i < descs.size(); ++i) {
+        const SceneSpriteDesc& desc = descs[i];
+        const SceneMeshDesc& mesh = scene.meshes[desc.mesh];
+        int index = addSprite(nodes[i], desc.pass, shaderIds[desc.shader], getSpriteFrame(desc), meshIds[desc.mesh], quadBounds(mesh.halfWidth, mesh.halfHeight, mesh.offset));
+        sceneSpriteIndices.push_back(index);
+        sceneSprites.push_back(desc);
+        
+        if (desc.name == "character" && textureFrames[desc.texture] >= 0) {
+            charSprite = index;
+            charNode = nodes[i];
+            charFrame = textureFrames[desc.texture];
+            charFrameCount = scene.textures[desc.texture].frameCount;
+            charBasePos = desc.transform.position;
+        } else if (desc.name == "cloudA") {
+            cloudNodeA = nodes[i];
+        }
+    }
+}
+
+/**
+ 로더 스레드가 읽어둔 스프라이트 묶음들을 장면에 추가함. wait 가 true 면 끝까지 읽을 때까지 기다림.
+ 
+ 한 프레임에 너무 많이 추가하면 그 프레임이 길어지므로, 기다리지 않을 때는 프레임마다 몇 묶음까지만 추가함.
+ 다 읽었으면 파싱 속도(MB/s, 스프라이트/s)를 로그로 출력하고, 텍스트 파일이었으면 다음 실행에서 읽을 바이너리 캐시를 저장함.
+ */
+void ofApp::updateSceneStreaming(bool wait){
+    if (!sceneStreaming) {
+        return;
+    }
+    PROFILE_SCOPE("scene streaming");
+    const int maxChunksPerFrame = 4;
+    SceneChunk chunk;
+    for (int added = 0; wait || added < maxChunksPerFrame; ) {
+        if (sceneLoader.poll(chunk)) {
+            if (chunk.first < sceneSprites.size()) {
+                // 깨진 캐시 대신 텍스트 파일을 처음부터 다시 읽는 중이면, 캐시에서 이미 추가한 스프라이트는 건너뜀.
+                size_t skip = std::min(chunk.sprites.size(), sceneSprites.size() - chunk.first);
+                chunk.sprites.erase(chunk.sprites.begin(), chunk.sprites.begin() + skip);
+            }
+            addSceneSprites(chunk.sprites);
+            added++;
+        } else if (sceneLoader.isFinished()) {
+            break;
+        } else if (wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } else {
+            return;
+        }
+    }
+    if (!sceneLoader.isFinished()) {
+        return;
+    }
+    
+    // 캐시가 중간에 잘렸거나 깨졌으면 캐시를 지우고 나머지 스프라이트를 텍스트 파일에서 읽음. (텍스트 파일을 끝까지 읽으면 캐시를 다시 저장함)
+    bool complete = !sceneLoader.hasError();
+    if (!complete && sceneLoader.getPath() != sceneSettings.file) {
+        std::string cache = sceneLoader.getPath();
+        sceneLoader.close();
+        ofLogWarning("ofApp") << "scene: cache " << cache << " is broken after " << sceneSprites.size() << " sprites, removed it and loading the rest from " << sceneSettings.file;
+        std::remove(ofToDataPath(cache).c_str());
+        SceneHeader header;
+        if (sceneLoader.open(sceneSettings.file, header)) {
+            sceneLoader.start();
+            updateSceneStreaming(wait);
+            return;
+        }
+    }
+    
+    SceneLoadStats stats = sceneLoader.getStats();
+    bool binary = sceneLoader.isBinary();
+    sceneLoader.close();
+    sceneStreaming = false;
+    ofLogNotice("ofApp") << "scene: " << sceneSprites.size() << " sprites from " << sceneLoader.getPath()
+        << ", " << ofToString(stats.bytes / (1024.0 * 1024.0), 2) << " MB in " << ofToString(stats.seconds * 1000.0, 1) << " ms"
+        << " (" << ofToString(stats.getMegabytesPerSecond(), 1) << " MB/s, " << ofToString(stats.getEntitiesPerSecond() / 1000000.0, 2) << " M entities/s)";
+    
+    if (!binary && complete) {
+        // 스프라이트가 많으면 캐시를 쓰는 데 여러 프레임 분량의 시간이 걸리므로 assetLoader 의 워커 스레드에서 씀.
+        // 이후 핫 리로드가 sceneSprites 를 바꿀 수 있으므로 지금 내용을 복사해서 넘김. (종료할 때 assetLoader 가 남은 일을 끝까지 처리함)
+        std::string cache = ofFilePath::removeExt(sceneSettings.file) + ".scnb";
+        auto header = std::make_shared<const SceneHeader>(scene);
+        auto sprites = std::make_shared<const std::vector<SceneSpriteDesc>>(sceneSprites);
+        assetLoader.enqueue<bool>([cache, header, sprites]() { return saveSceneBinary(cache, *header, *sprites); });
+    }
+    
+    // 처음 로드가 끝나면 장면 파일과 장면이 사용하는 파일들의 변경을 확인하기 시작함.
+    if (!headless.enabled) {
+        fileWatcher.watch(sceneSettings.file);
+        for (const SceneShaderDesc& shader : scene.shaders) {
+            fileWatcher.watch(shader.vert);
+            fileWatcher.watch(shader.frag);
+            if (!shader.oitFrag.empty()) {
+                fileWatcher.watch(shader.oitFrag);
+            }
+        }
+        for (const SceneTextureDesc& texture : scene.textures) {
+            fileWatcher.watch(texture.file);
+        }
+    }
+}
+
+//--------------------------------------------------------------
+/**
+ 셰이더 파일이 바뀌었으면 프로그램을 새로 링크하고, spriteRenderer 가 카메라 블록과 유니폼 location 을 다시 연결하도록 함.
+ 컴파일에 실패하면 (ofShader 가 에러 로그를 남김) 파일을 고쳐서 다시 저장할 때까지 그 셰이더로 그리는 스프라이트가 보이지 않음.
+ */
+void ofApp::reloadSceneShader(size_t index){
+    const SceneShaderDesc& desc = scene.shaders[index];
+    sceneShaders[index]->unload();
+    bool loaded = sceneShaders[index]->load(desc.vert, desc.frag);
+    spriteRenderer.reloadShader(shaderIds[index]);
+    if (sceneOITShaders[index]) {
+        sceneOITShaders[index]->unload();
+        loaded = sceneOITShaders[index]->load(desc.vert, desc.oitFrag) && loaded;
+        spriteRenderer.reloadShader(oitShaderIds[index]);
+    }
+    ofLogNotice("ofApp") << "hot reload: shader " << desc.name << (loaded ? " reloaded" : " failed to compile");
+}
+
+/**
+ 장면 파일이 바뀌었으면 다시 읽어서, 지금 장면과 달라진 항목만 적용함.
+ 
+ - 카메라, 노드와 스프라이트의 위치, 회전, 크기, 메쉬 크기, 스프라이트의 메쉬, 셰이더, 텍스쳐 프레임, 패스는 바로 적용됨.
+ - 파일 이름이 바뀐 셰이더는 새 파일로 다시 로드함.
+ - 끝에 추가된 셰이더, 메쉬, 노드, 스프라이트는 새로 만들고, 끝에서 지워진 스프라이트는 격자에서 빼서 더 이상 그리지 않음.
+ - 텍스쳐는 아틀라스에 구워져 있으므로, 다음에 실행할 때 아틀라스를 다시 만들면서 적용됨.
+ 
+ 항목은 파일에 적힌 순서(인덱스)로 비교하므로, 중간에 스프라이트를 끼워넣거나 지우면 그 뒤의 스프라이트들이 모두 바뀐 것으로 처리됨.
+ 셰이더, 메쉬, 노드를 지우거나 텍스쳐를 추가하는 것처럼 지금 장면에 적용할 수 없는 변경은 경고만 남기고 건너뜀.
+ */
+void ofApp::reloadScene(){
+    SceneHeader header;
+    std::vector<SceneSpriteDesc> descs;
+    SceneLoadStats stats;
+    if (!SceneLoader::load(sceneSettings.file, header, descs, &stats)) {
+        return;
+    }
+    if (header.shaders.size() < scene.shaders.size() || header.meshes.size() < scene.meshes.size() || header.nodes.size() < scene.nodes.size()
+        || header.textures.size() != scene.textures.size()) {
+        ofLogWarning("ofApp") << "hot reload: shaders, meshes or nodes were removed or textures were added, restart to apply " << sceneSettings.file;
+        return;
+    }
+    int changes = 0;
+    
+    if (header.camera != scene.camera) {
+        scene.camera = header.camera;
+        cam.position = scene.camera.position;
+        cam.rotation = scene.camera.rotation;
+        changes++;
+    }
+    
+    for (size_t i = 0; i < header.shaders.size(); ++i) {
+        SceneShaderDesc& desc = header.shaders[i];
+        if (i >= scene.shaders.size()) {
+            scene.shaders.push_back(desc);
+            addSceneShader(desc);
+        } else if (!(desc == scene.shaders[i])) {
+            if (desc.oitFrag.empty() != scene.shaders[i].oitFrag.empty()) {
+                ofLogWarning("ofApp") << "hot reload: adding or removing the OIT shader of " << desc.name << " needs a restart";
+                desc.oitFrag = scene.shaders[i].oitFrag;
+            }
+            scene.shaders[i] = desc;
+            reloadSceneShader(i);
+        } else {
+            continue;
+        }
+        fileWatcher.watch(desc.vert);
+        fileWatcher.watch(desc.frag);
+        if (!desc.oitFrag.empty()) {
+            fileWatcher.watch(desc.oitFrag);
+        }
+        changes++;
+    }
+    
+    for (size_t i = 0; i < header.textures.size(); ++i) {
+        if (!(header.textures[i] == scene.textures[i])) {
+            ofLogWarning("ofApp") << "hot reload: texture " << header.textures[i].name << " changed, the atlas is rebuilt on the next start";
+        }
+    }
+    
+    // 크기가 바뀐 메쉬는 vbo 를 다시 업로드하고, 그 메쉬를 쓰는 스프라이트들의 컬링 범위도 아래에서 다시 구함.
+    std::vector<bool> meshChanged(header.meshes.size(), false);
+    for (size_t i = 0; i < header.meshes.size(); ++i) {
+        const SceneMeshDesc& desc = header.meshes[i];
+        if (i >= scene.meshes.size()) {
+            scene.meshes.push_back(desc);
+            addSceneMesh(desc);
+        } else if (!(desc == scene.meshes[i])) {
+            scene.meshes[i] = desc;
+            ofMesh mesh;
+            buildMesh(mesh, desc.halfWidth, desc.halfHeight, desc.offset);
+            spriteRenderer.updateMesh(meshIds[i], mesh);
+            meshChanged[i] = true;
+        } else {
+            continue;
+        }
+        changes++;
+    }
     
-    alienImg.load("walk_sheet.png"); // 캐릭터메쉬에 사용할 스프라이트시트 텍스쳐 로드
-    backgroundImg.load("forest.png"); // 배경메쉬에 사용할 텍스쳐 로드
-    cloudImg.load("cloud.png"); // 구름메쉬에 사용할 텍스쳐 로드
-    sunImg.load("sun.png"); // 태양메쉬에 사용할 텍스쳐 로드
+    for (size_t i = 0; i < header.nodes.size(); ++i) {
+        const SceneNodeDesc& desc = header.nodes[i];
+        if (i >= scene.nodes.size()) {
+            scene.nodes.push_back(desc);
+            addSceneNode(desc);
+            changes++;
+        } else if (desc.parent != scene.nodes[i].parent) {
+            ofLogWarning("ofApp") << "hot reload: changing the parent of node " << desc.name << " needs a restart";
+        } else if (desc.transform != scene.nodes[i].transform) {
+            scene.nodes[i].transform = desc.transform;
+            sceneGraph.setPosition(sceneNodes[i], desc.transform.position);
+            sceneGraph.setRotation(sceneNodes[i], desc.transform.rotation);
+            sceneGraph.setScale(sceneNodes[i], desc.transform.scale);
+            changes++;
+        }
+    }
     
-    // 모든 메쉬를 변환행렬로 처리하기 위해 passthrough.vert 를 cloud.vert 처럼 변환행렬로 곱해주는 로직으로 변경하고, 버텍스 셰이더를 통일함.
-    spritesheetShader.load("spritesheet.vert", "alphaTest.frag"); // 스프라이트시트 기법을 사용할 캐릭터메쉬에 적용할 셰이더 파일 로드
-    alphaTestShader.load("passthrough.vert", "alphaTest.frag"); // 알파테스트 셰이더를 사용할 메쉬들에 적용할 셰이더 파일 로드
-    cloudShader.load("passthrough.vert", "cloud.frag"); // 구름메쉬에 적용할 셰이더 파일 로드
+    // 위치, 회전, 크기가 바뀐 스프라이트는 노드만 갱신하면 draw() 에서 월드행렬과 격자가 갱신됨.
+    size_t common = std::min(sceneSprites.size(), descs.size());
+    for (size_t i = 0; i < common; ++i) {
+        const SceneSpriteDesc& desc = descs[i];
+        SceneSpriteDesc& current = sceneSprites[i];
+        SceneSprite& sprite = sprites[sceneSpriteIndices[i]];
+        if (desc.name != current.name || desc.parent != current.parent) {
+            ofLogWarning("ofApp") << "hot reload: sprite " << i << " changed its name or parent, restart to apply";
+            continue;
+        }
+        if (desc.transform != current.transform) {
+            sceneGraph.setPosition(sprite.node, desc.transform.position);
+            sceneGraph.setRotation(sprite.node, desc.transform.rotation);
+            sceneGraph.setScale(sprite.node, desc.transform.scale);
+            if (sceneSpriteIndices[i] == charSprite) {
+                charBasePos = desc.transform.position;
+            }
+            changes++;
+        }
+        if (!desc.sameBinding(current) || meshChanged[desc.mesh]) {
+            const SceneMeshDesc& mesh = scene.meshes[desc.mesh];
+            sprite.pass = desc.pass;
+            sprite.shader = shaderIds[desc.shader];
+            sprite.mesh = meshIds[desc.mesh];
+            sprite.frame = getSpriteFrame(desc);
+            sprite.localBounds = quadBounds(mesh.halfWidth, mesh.halfHeight, mesh.offset);
+            sprite.worldBounds = transformBounds(sprite.localBounds, sceneGraph.getWorldMatrix(sprite.node));
+            // 아틀라스에 없는 텍스쳐로 바뀌면 격자에서 빼서 그리지 않고, 있는 텍스쳐로 바뀌면 다시 넣음.
+            if (sprite.frame < 0 && sprite.gridHandle >= 0) {
+                spriteGrid.remove(sprite.gridHandle);
+                sprite.gridHandle = -1;
+            } else if (sprite.frame >= 0 && sprite.gridHandle < 0) {
+                sprite.gridHandle = spriteGrid.insert(sprite.worldBounds, sceneSpriteIndices[i]);
+            } else if (sprite.gridHandle >= 0) {
+                spriteGrid.update(sprite.gridHandle, sprite.worldBounds);
+            }
+            if (sceneSpriteIndices[i] == charSprite && sprite.frame >= 0) {
+                charFrame = textureFrames[desc.texture];
+                charFrameCount = scene.textures[desc.texture].frameCount;
+            }
+            changes++;
+        }
+        current = desc;
+    }
+    
+    // 파일에서 지워진 스프라이트는 sprites 에서 빼면 인덱스가 바뀌므로, 격자에서만 빼서 컬링 결과에 나오지 않도록 함.
+    for (size_t i = descs.size(); i < sceneSprites.size(); ++i) {
+        SceneSprite& sprite = sprites[sceneSpriteIndices[i]];
+        if (sprite.gridHandle >= 0) {
+            spriteGrid.remove(sprite.gridHandle);
+            sprite.gridHandle = -1;
+        }
+        if (sceneSpriteIndices[i] == charSprite) {
+            charSprite = -1;
+            charNode = -1;
+        } else if (sprite.node == cloudNodeA) {
+            cloudNodeA = -1;
+        }
+        changes++;
+    }
+    if (descs.size() < sceneSprites.size()) {
+        sceneSprites.resize(descs.size());
+        sceneSpriteIndices.resize(descs.size());
+    }
+    
+    if (descs.size() > common) {
+        changes += (int)(descs.size() - common);
+        addSceneSprites(std::vector<SceneSpriteDesc>(descs.begin() + common, descs.end()));
+    }
+    
+    ofLogNotice("ofApp") << "hot reload: " << sceneSettings.file << ", " << changes << " changed entries (parsed in " << ofToString(stats.seconds * 1000.0, 1) << " ms, "
+        << ofToString(stats.getMegabytesPerSecond(), 1) << " MB/s, " << ofToString(stats.getEntitiesPerSecond() / 1000000.0, 2) << " M entities/s)";
+}
+
+//--------------------------------------------------------------
+/**
+ --scene-stress N 으로 실행하면, 장면 파일에 스프라이트 N 개를 더한 장면 파일(forest_stress_N.scene)을 만들고 그 파일의 경로를 리턴함.
+ 스프라이트가 아주 많은 장면에서 스트리밍 로드와 파싱 속도를 확인하기 위한 것이고, 원본 장면 파일보다 새로운 파일이 이미 있으면 다시 만들지 않음.
+ 절반은 캐릭터(불투명, 걷기 프레임 무작위), 절반은 구름(반투명)이고 화면 안에 무작위로 흩어 놓음.
+ */
+std::string ofApp::writeStressScene(){
+    std::string path = ofFilePath::removeExt(sceneSettings.file) + "_stress_" + ofToString(sceneSettings.stressSprites) + ".scene";
+    if (getModifiedTime(path) > getModifiedTime(sceneSettings.file)) {
+        return path;
+    }
+    
+    SceneHeader header;
+    std::vector<SceneSpriteDesc> sprites;
+    if (!SceneLoader::load(sceneSettings.file, header, sprites)) {
+        return sceneSettings.file;
+    }
+    int sky = header.findNode("sky");
+    int charMesh = header.findMesh("character");
+    int cloudMesh = header.findMesh("cloud");
+    int alphaTestShader = header.findShader("alphaTest");
+    int cloudShader = header.findShader("cloud");
+    int walkTexture = header.findTexture("walk");
+    int cloudTexture = header.findTexture("cloud");
+    if (charMesh < 0 || cloudMesh < 0 || alphaTestShader < 0 || cloudShader < 0 || walkTexture < 0 || cloudTexture < 0) {
+        ofLogWarning("ofApp") << "stress scene: " << sceneSettings.file << " has no character / cloud mesh, shader or texture";
+        return sceneSettings.file;
+    }
+    
+    ofSeedRandom(4321);
+    sprites.reserve(sprites.size() + sceneSettings.stressSprites);
+    for (int i = 0; i < sceneSettings.stressSprites; ++i) {
+        SceneSpriteDesc sprite;
+        if (i % 2 == 0) {
+            sprite.mesh = charMesh;
+            sprite.shader = alphaTestShader;
+            sprite.texture = walkTexture;
+            sprite.frame = (int)ofRandom(header.textures[walkTexture].frameCount);
+            sprite.pass = SPRITE_PASS_OPAQUE;
+            sprite.transform.position = glm::vec3(ofRandom(-1.3, 1.3), ofRandom(-0.8, 1.1), ofRandom(-0.45, -0.05)); // 배경(z = -0.5)보다 앞
+            sprite.transform.scale = glm::vec3(0.3, 0.3, 1);
+        } else {
+            sprite.parent = sky;
+            sprite.mesh = cloudMesh;
+            sprite.shader = cloudShader;
+            sprite.texture = cloudTexture;
+            sprite.pass = SPRITE_PASS_TRANSPARENT;
+            sprite.transform.position = glm::vec3(ofRandom(-1.3, 1.3), ofRandom(-0.9, 0.9), ofRandom(-0.45, 0.0));
+            sprite.transform.rotation = ofRandom(TWO_PI);
+            float scale = ofRandom(0.2, 0.6);
+            sprite.transform.scale = glm::vec3(scale, scale, 1);
+        }
+        sprites.push_back(sprite);
+    }
+    if (!saveSceneText(path, header, sprites)) {
+        return sceneSettings.file;
+    }
+    ofLogNotice("ofApp") << "stress scene: " << sprites.size() << " sprites -> " << path;
+    return path;
+}
+
+//--------------------------------------------------------------
+// 스프라이트의 아틀라스 프레임 번호. 텍스쳐가 아틀라스에 없으면 -1
+int ofApp::getSpriteFrame(const SceneSpriteDesc& desc) const{
+    int first = textureFrames[desc.texture];
+    if (first < 0) {
+        return -1;
+    }
+    return first + std::max(0, std::min(desc.frame, scene.textures[desc.texture].frameCount - 1));
+}
+
+//--------------------------------------------------------------
+// 스프라이트를 등록하고, 현재 월드행렬로 구한 범위를 격자에 넣음. 등록한 스프라이트의 인덱스를 리턴함.
+// frame 이 -1 이면 (텍스쳐가 아틀라스에 없으면) 등록만 하고 격자에 넣지 않으므로 그려지지 않음.
+int ofApp::addSprite(int node, int pass, int shader, int frame, int mesh, SpriteBounds localBounds){
+    SceneSprite sprite;
+    sprite.node = node;
+    sprite.pass = pass;
+    sprite.shader = shader;
+    sprite.frame = frame;
+    sprite.mesh = mesh;
+    sprite.localBounds = localBounds;
+    sprite.worldBounds = transformBounds(localBounds, sceneGraph.getWorldMatrix(node));
+    
+    int index = (int)sprites.size();
+    sprite.gridHandle = frame >= 0 ? spriteGrid.insert(sprite.worldBounds, index) : -1;
+    sprites.push_back(sprite);
+    if (node >= (int)nodeSprites.size()) {
+        nodeSprites.resize(sceneGraph.size(), -1);
+    }
+    nodeSprites[node] = index;
+    return index;
+}
+
+/**
+ 마지막 sceneGraph.update() 에서 월드행렬이 바뀐 (노드 자신이나 조상이 움직인) 노드들의 스프라이트만 월드 공간 범위를 다시 구해서 격자를 갱신함.
+ 전체 스프라이트를 훑지 않으므로 캐릭터 하나만 움직이면 비용도 스프라이트 하나만큼만 듦. (걸치는 셀이 그대로면 격자는 아무것도 안 함)
+ 장면 파일에서 지워졌거나 텍스쳐가 아틀라스에 없는 스프라이트는 격자에 없으므로 (gridHandle 이 -1) 건너뜀.
+ sceneGraph.update() 를 부르는 곳마다 바로 뒤에 불러야 바뀐 노드를 놓치지 않음.
+ */
+void ofApp::updateSpriteBounds(){
+    for (int node : sceneGraph.getUpdatedNodes()) {
+        int index = node < (int)nodeSprites.size() ? nodeSprites[node] : -1; // 아직 스프라이트를 등록하지 않은 노드는 범위 밖
+        if (index < 0 || sprites[index].gridHandle < 0) {
+            continue;
+        }
+        SceneSprite& sprite = sprites[index];
+        sprite.worldBounds = transformBounds(sprite.localBounds, sceneGraph.getWorldMatrix(sprite.node));
+        spriteGrid.update(sprite.gridHandle, sprite.worldBounds);
+    }
 }
 
 //--------------------------------------------------------------
 void ofApp::update(){
-    if (walkRight) { // 오른쪽 화살표 키 입력을 감지하여 true 이면 조건문 블록을 수행함.
-        float speed = 0.5 * ofGetLastFrameTime(); // 이전 프레임과 현재 프레임의 시간 간격인 '델타타임'을 가져와서 속도값을 구함.
-        charPos += glm::vec3(speed, 0, 0); // 속도값 만큼을 x좌표에 더해서 charPos 값을 누적계산함.
+    // update() 가 프레임의 시작이므로 여기서 프레임 번호를 올리고, GPU 쿼리는 몇 프레임 전에 넣어둔 결과를 읽어감.
+    FrameProfiler::get().beginFrame();
+    gpuProfiler.beginFrame();
+    PROFILE_SCOPE("update");
+    
+    // if (walkRight) { // 오른쪽 화살표 키 입력을 감지하여 true 이면 조건문 블록을 수행함.
+    //     float speed = 0.5 * ofGetLastFrameTime(); // 이전 프레임과 현재 프레임의 시간 간격인 '델타타임'을 가져와서 속도값을 구함.
+    //     charPos += glm::vec3(speed, 0, 0); // 속도값 만큼을 x좌표에 더해서 charPos 값을 누적계산함.
+    // }
+    
+    // 델타타임으로 적분하면 fps 에 따라 결과가 달라지므로, 이동은 simulation 스레드가 고정 틱으로 계산하고
+    // 여기서는 현재 시각에 맞게 직전 틱과 최신 틱 사이를 보간한 상태만 받아옴.
+    // 헤드리스 모드는 실행할 때마다 같은 이미지가 나와야 하므로, 시뮬레이션 스레드 대신 렌더링한 프레임마다 한 틱씩 직접 진행함. (첫 프레임은 초기 상태)
+    {
+        PROFILE_SCOPE("simulation sample");
+        if (!headless.enabled) {
+            simView = simulation.sample();
+        } else if (headlessFrame > 0) {
+            stepSimulation(simView, SimInput(), simulation.getTickSeconds());
+        }
+        charPos = simView.charPos;
+    }
+    
+    // 로더 스레드가 읽어둔 장면 스프라이트들을 추가함. (다 읽을 때까지 프레임마다 몇 묶음씩)
+    updateSceneStreaming(false);
+    
+    // 장면을 다 읽은 뒤에는 0.5초마다 장면 파일, 셰이더 파일이 바뀌었는지 확인해서 바뀐 항목만 다시 로드함.
+    if (!sceneStreaming && !headless.enabled && ofGetElapsedTimef() >= nextWatchTime) {
+        PROFILE_SCOPE("hot reload");
+        nextWatchTime = ofGetElapsedTimef() + 0.5f;
+        for (const std::string& path : fileWatcher.poll()) {
+            if (path == sceneSettings.file) {
+                reloadScene();
+                continue;
+            }
+            for (size_t i = 0; i < scene.shaders.size(); ++i) {
+                const SceneShaderDesc& shader = scene.shaders[i];
+                if (path == shader.vert || path == shader.frag || path == shader.oitFrag) {
+                    reloadSceneShader(i);
+                }
+            }
+            for (const SceneTextureDesc& texture : scene.textures) {
+                if (path == texture.file) {
+                    ofLogNotice("ofApp") << "hot reload: " << path << " changed, the atlas is rebuilt on the next start";
+                }
+            }
+        }
+    }
+    
+    // 군중은 화면 연출용이라 시뮬레이션 상태(재현 대상)에 넣지 않고, 렌더 프레임마다 델타타임만큼 진행하면서 인스턴스 데이터를 채움.
+    if (!crowdInstances.empty()) {
+        PROFILE_SCOPE("crowd");
+        walkerAnimation.update(ofGetLastFrameTime(), crowdInstances.data(), crowd.threads);
     }
 }
 
+//--------------------------------------------------------------
+/**
+ 종료할 때 시뮬레이션의 초기 상태, 입력 기록, 최종 상태를 파일로 저장하고, 틱 지터와 보간 지연시간을 로그로 출력함.
+ 같은 프로세스에서 다시 돌려보는 것만으로는 전역 상태나 초기화 순서에 따른 차이를 잡을 수 없으므로,
+ 결정적 재현 여부는 저장한 파일을 새 프로세스에서 --replay 로 다시 돌려서 확인함. (main.cpp 참고)
+ */
+void ofApp::exit(){
+    simulation.stop();
+    if (headless.enabled) {
+        return; // 헤드리스 모드는 시뮬레이션 스레드를 쓰지 않음. (update() 참고)
+    }
+    
+    const std::string recordingPath = "simulation.simlog";
+    if (saveSimRecording(recordingPath, simulation.getRecording())) {
+        ofLogNotice("ofApp") << "simulation: input log -> " << recordingPath << " (check with --replay " << recordingPath << ")";
+    }
+    
+    SimTimingStats timing = simulation.getTimingStats();
+    ofLogNotice("ofApp") << "simulation: " << timing.ticks << " ticks, " << simulation.getInputLog().size() << " input changes"
+        << ", tick jitter mean " << timing.meanJitterMicros << " us / max " << timing.maxJitterMicros << " us, " << timing.lateTicks << " ticks late by more than " << Simulation::LATE_TICK_MICROS << " us"
+        << ", render latency mean " << timing.meanLatencyMicros << " us / max " << timing.maxLatencyMicros << " us over " << timing.samples << " frames";
+}
+
 //--------------------------------------------------------------
 void ofApp::draw(){
+    PROFILE_SCOPE("draw");
     using namespace glm; // 하단에서 buildMatrix() 함수로 변환행렬 계산 후 리턴받는 코드 작성 시, 'glm::' 을 안붙이고도 mat4, vec3 등의 변수타입을 사용할 수 있도록 한 것.
     
-    cam.position = vec3(-1, 0, 0); // 매 프레임마다 카메라 위치 데이터를 (-1, 0, 0) 으로 할당함. (x축 방향으로 -1이면, NDC 좌표계의 x축이 -1 ~ 1 사이니까 정확히 x축 방향으로 왼쪽으로 전체 좌표계의 절반만큼 움직이도록 한 것. )
-    // mat4 view = buildViewMatrix(cam); // 위치 데이터가 할당된 CameraData 타입의 변수를 인자로 넘겨서 뷰행렬을 리턴받음.
-    mat4 view = mat4(); // 투영행렬 적용결과를 관찰하기 위해, 뷰행렬을 단위행렬로 바꿔줌으로써 카메라를 움직이지 않도록 함. (glm::mat4() 를 그냥 호출하면 단위행렬이 나온다고 했었지?)
+    // cam.position = vec3(-1, 0, 0); // 매 프레임마다 카메라 위치 데이터를 (-1, 0, 0) 으로 할당함. (x축 방향으로 -1이면, NDC 좌표계의 x축이 -1 ~ 1 사이니까 정확히 x축 방향으로 왼쪽으로 전체 좌표계의 절반만큼 움직이도록 한 것. )
+    // mat4 view = mat4(); // 투영행렬 적용결과를 관찰하기 위해, 뷰행렬을 단위행렬로 바꿔줌으로써 카메라를 움직이지 않도록 함. (glm::mat4() 를 그냥 호출하면 단위행렬이 나온다고 했었지?)
+    // -> 카메라 위치, 회전값은 장면 파일의 camera 항목에서 읽어옴. forest.scene 의 카메라는 원점에 있으므로 위의 단위행렬과 같은 뷰행렬이 나옴.
+    mat4 view = buildViewMatrix(cam); // 위치 데이터가 할당된 CameraData 타입의 변수를 인자로 넘겨서 뷰행렬을 리턴받음.
     
     /**
      glm 라이브러리의 ortho() 함수를 이용해서 직교투영에 사용할 투영행렬을 리턴받음.
@@ -130,89 +933,226 @@ void ofApp::draw(){
      z축 상에서 0 에서 시작해서 -10에서 끝난다는 뜻이고,
      이 범위를 벗어나는 메쉬들은 렌더링되지 않을 거라는 의미임.
      */
-    mat4 proj = glm::ortho(-1.33f, 1.33f, -1.0f, 1.0f, 0.0f, 10.0f);
-    
-    ofDisableBlendMode(); // 이전 프레임에서 사용한 블렌딩 모드를 비활성화함.
-    ofEnableDepthTest(); // 구름메쉬의 투명픽셀에 의해 태양메쉬가 가리는 문제를 해결하고자 밑에서 비활성화했던 깊이테스트를 다시 활성화함. (캐릭터메쉬, 배경메쉬는 깊이를 구분해줘야 하니까)
-    
-    static float frame = 0.0; // 프레임 변수 초기화
-    frame = (frame > 10) ? 0.0 : frame += 0.2; // frame의 정수부분이 5번의 draw() 함수 호출 이후 바뀌도록 프레임 계산
-    glm::vec2 spriteSize = glm::vec2(0.28, 0.19); // 스프라이트시트 텍스쳐 사이즈를 프레임 하나 만큼의 사이즈로 조절할 때 필요한 값
-    glm::vec2 spriteFrame = glm::vec2((int)frame % 3, (int)frame / 3); // 스프라이트시트 텍스쳐 offset(각각 u, v 방향으로) 적용 시 사용할 vec2값
-    
-    // spritesheetShader 바인딩하여 사용 시작
-    spritesheetShader.begin();
-    
-    spritesheetShader.setUniform2f("size", spriteSize); // 텍스쳐 사이즈 조절값 유니폼 변수에 전송
-    spritesheetShader.setUniform2f("offset", spriteFrame); // 프레임 offset 값 유니폼 변수에 전송
-    spritesheetShader.setUniformTexture("tex", alienImg, 0); // 스프라이트시트 텍스쳐 이미지 유니폼 변수에 전송
-    spritesheetShader.setUniformMatrix4f("model", translate(charPos)); // 캐릭터메쉬의 이동도 변환행렬로 처리해야 하므로, 키 입력에 따라 갱신되는 vec3 charPos 벡터로 이동행렬을 만들어서 변환행렬(이제부터는 '모델행렬' 이라고 부를 것!) 유니폼 변수에 전송해 줌.
-    spritesheetShader.setUniformMatrix4f("view", view); // 카메라 움직임의 정반대 방향으로 캐릭터메쉬의 움직임을 조정하는 뷰행렬도 유니폼 변수에 전송해 줌.
-    spritesheetShader.setUniformMatrix4f("proj", proj); // 뷰 좌표(공간)에 곱해줘서 클립공간으로 변환하기 위해 필요한 투영행렬도 유니폼 변수에 전송해 줌.
-    charMesh.draw(); // 캐릭터메쉬 드로우콜 호출하여 그려줌
-    
-    spritesheetShader.end();
-    // spritesheetShader 사용 중단
+    // mat4 proj = glm::ortho(-1.33f, 1.33f, -1.0f, 1.0f, 0.0f, 10.0f);
+    // -> 위의 값들은 이제 장면 파일의 camera 항목에 적어두고 읽어옴.
+    const SceneCamera& sceneCam = scene.camera;
+    mat4 proj = glm::ortho(sceneCam.left, sceneCam.right, sceneCam.bottom, sceneCam.top, sceneCam.nearClip, sceneCam.farClip);
     
+    /**
+     이전에는 메쉬마다 셰이더를 바인딩하고 유니폼 변수를 보낸 뒤 draw() 를 호출했는데,
+     이제는 그릴 메쉬들을 spriteBatch 에 submit 해서 모아두고, 한꺼번에 정렬 및 그룹화해서
+     같은 셰이더, 텍스쳐, 메쉬를 쓰는 인스턴스들을 드로우콜 하나로 그려줌.
     
-    // alphaTestShader 바인딩하여 사용 시작
-    alphaTestShader.begin();
+     깊이테스트, 블렌딩 모드 전환도 패스(SPRITE_PASS_OPAQUE, SPRITE_PASS_TRANSPARENT, SPRITE_PASS_TRANSPARENT_SORTED) 단위로 spriteRenderer 가 처리함.
+     */
+    spriteBatch.clear();
     
-    alphaTestShader.setUniformTexture("tex", backgroundImg, 0); // 배경 텍스쳐 이미지 유니폼 변수에 전송
-    alphaTestShader.setUniformMatrix4f("model", glm::mat4()); // 배경메쉬도 변환행렬 (이제부터는 '모델행렬') 로 처리함. 배경메쉬는 아무런 변환이 필요 없으므로, glm::mat4() 호출을 통해 간단하게 '단위행렬'을 생성한 뒤 유니폼 변수에 전송함. 이처럼, 단위행렬은 별도의 변환이 필요없는 배경메쉬 등에 유용하게 사용됨.
-    alphaTestShader.setUniformMatrix4f("view", view); // 카메라 움직임의 정반대 방향으로 배경메쉬의 움직임을 조정하는 뷰행렬도 유니폼 변수에 전송해 줌.
-    alphaTestShader.setUniformMatrix4f("proj", proj); // 뷰 좌표(공간)에 곱해줘서 클립공간으로 변환하기 위해 필요한 투영행렬도 유니폼 변수에 전송해 줌.
-    backgroundMesh.draw(); // 배경메쉬 드로우콜 호춣여 그려줌
+    // static float frame = 0.0; // 프레임 변수 초기화
+    // frame = (frame > 10) ? 0.0 : frame += 0.2; // frame의 정수부분이 5번의 draw() 함수 호출 이후 바뀌도록 프레임 계산
+    // -> draw() 호출마다 0.2 씩 올리면 fps 에 따라 걷는 속도가 달라지므로, 시뮬레이션의 걷기 애니메이션 시간으로 프레임 번호를 구함.
+    // 이전에는 (frame % 3, frame / 3) 으로 스프라이트시트 offset 을 계산했는데, 아틀라스에 프레임 순서대로 uv 영역이 계산되어 있으므로 프레임 번호만 더해주면 됨.
+    if (charSprite >= 0) {
+        sprites[charSprite].frame = charFrame + simView.getWalkFrame(charFrameCount); // 다른 텍스쳐의 프레임을 읽지 않도록 캐릭터 텍스쳐의 프레임 수 안에서 반복함
+    }
     
-    alphaTestShader.end();
-    // alphaTestShader 사용 중단
+    // 구름의 회전 각도도 델타타임으로 누적하지 않고 시뮬레이션에서 보간된 값을 사용함.
+    float rotation = simView.cloudRotation;
     
+    /**
+     이전에는 첫 번째 구름메쉬의 모델행렬을
+     translationA * ourRotation * inverse(translationA) * (translationA * scaleA) 처럼 매 프레임 직접 곱해서 만들었는데,
+     가운데의 inverse(translationA) * translationA 가 상쇄되므로 결국 translationA * ourRotation * scaleA,
+     즉 buildMatrix(vec3(-0.55, 0.0, 0.0), rotation, vec3(1.5, 1, 1)) 와 같음.
+     
+     그래서 이제는 sceneGraph 노드의 회전값만 바꿔주고, 실제 행렬 계산은 sceneGraph.update() 에서
+     값이 바뀐 노드(캐릭터, 첫 번째 구름)에 대해서만 처리함.
+     (메쉬 중심이 아닌 다른 점을 기준으로 회전시키고 싶으면 setPivot() 으로 회전 중심을 지정하면 됨)
+     */
+    {
+        PROFILE_SCOPE("scene graph");
+        // 장면 파일의 character, cloudA 스프라이트가 아직 로드되지 않았으면 건너뜀.
+        if (charNode >= 0) {
+            sceneGraph.setPosition(charNode, charBasePos + charPos); // 키 입력에 따라 갱신되는 charPos 만큼 캐릭터메쉬를 이동시킴
+        }
+        if (cloudNodeA >= 0) {
+            sceneGraph.setRotation(cloudNodeA, rotation);
+        }
+        sceneGraph.update();
+        updateSpriteBounds();
+    }
     
-    ofDisableDepthTest(); // 투명 픽셀이 깊이버퍼값을 가져서 뒤에 있던 태양메쉬가 가려지지 않도록, 태양메쉬와 구름메쉬를 그리기 전 깊이테스트 비활성화
-    ofEnableBlendMode(ofBlendMode::OF_BLENDMODE_ALPHA); // 새로운 프래그먼트의 알파값을 이용해서 백 버퍼의 프래그먼트와 색상값을 섞어주는 알파 블렌딩 모드 활성화
+    /**
+     프러스텀 컬링
+     
+     1. 격자에서 프러스텀을 감싸는 영역의 셀에 걸친 스프라이트들만 가져오고
+     2. 가져온 스프라이트들의 범위를 프러스텀 평면 6개로 정확히 검사해서
+     3. 프러스텀과 겹치는 스프라이트만 spriteBatch 에 submit 함.
+     
+     그래서 setup() 주석에 적었던 것처럼 z값이 0.5 라서 프러스텀(z축 0 ~ -10)을 벗어나는 메쉬는 submit 조차 되지 않음.
+     */
+    int culled = (int)sprites.size();
+    {
+        PROFILE_SCOPE("culling");
+        ViewFrustum frustum = extractFrustum(proj * view);
+        visibleSprites.clear();
+        spriteGrid.query(frustum.bounds, visibleSprites);
+        std::sort(visibleSprites.begin(), visibleSprites.end()); // 반투명 패스가 등록 순서대로 그려지도록 인덱스 순으로 정렬
+        
+        for (int index : visibleSprites) {
+            const SceneSprite& sprite = sprites[index];
+            if (!intersects(frustum, sprite.worldBounds)) {
+                continue;
+            }
+            
+            // 텍스쳐는 프레임이 들어있는 아틀라스 페이지로 정해지므로, 페이지가 같은 스프라이트들은 텍스쳐를 바꾸지 않고 같이 그려짐.
+            const AtlasFrame& atlasFrame = atlas.getFrame(sprite.frame);
+            SpriteInstance instance;
+            instance.model = sceneGraph.getWorldMatrix(sprite.node);
+            instance.uvRect = atlasFrame.uvRect;
+            instance.layer = (float)atlasFrame.page;
+            spriteBatch.submit(sprite.pass, sprite.shader, atlasPageTexIds[atlasFrame.page], sprite.mesh, instance);
+            culled--;
+        }
+        
+        // 군중은 update() 에서 만들어둔 인스턴스 데이터를 한꺼번에 넘김. (모두 같은 셰이더, 아틀라스 페이지, 메쉬라서 드로우콜 하나로 그려짐)
+        if (!crowdInstances.empty()) {
+            spriteBatch.submit(SPRITE_PASS_OPAQUE, crowdShaderId, atlasPageTexIds[walkerAnimation.getPage()], crowdMeshId, crowdInstances.data(), crowdInstances.size());
+        }
+    }
     
-    // 변환행렬로 회전 애니메이션을 구현하기 위해 매 프레임마다 회전행렬 생성에 필요한 각도값을 갱신함.
-    static float rotation = 1.0f; // 매 프레임마다 갱신할 회전행렬의 각도값
-    rotation += 1.0f * ofGetLastFrameTime(); // 이전 프레임과 현재 프레임의 시간 간격인 '델타타임'만큼 매 프레임마다 각도값을 더해줌.
+    {
+        PROFILE_SCOPE("batch build");
+        // 깊이 정렬 모드에서는 반투명 스프라이트를 뷰 공간 깊이로 정렬하고, OIT 모드에서는 불투명 패스처럼 상태별로 묶음.
+        spriteBatch.setTransparentOrder(transparentOrder);
+        spriteRenderer.setOrderIndependent(transparentOrder == TRANSPARENT_ORDER_INDEPENDENT ? &oit : nullptr);
+        spriteBatch.build(view); // 정렬, 그룹화 및 인스턴스 데이터 채우기
+    }
     
-    // 위에 glm 네임스페이스를 지정해줬기 때문에 mat4, vec3 등의 타입을 바로 사용할 수 있음.
+    if (headless.enabled) {
+        drawHeadless(view, proj);
+        return;
+    }
+    {
+        PROFILE_SCOPE("render");
+        GpuProfileScope gpuScope(&gpuProfiler, "render");
+        spriteRenderer.draw(spriteBatch, view, proj); // 그룹마다 인스턴스 드로우콜 하나씩 호출해서 그려줌
+    }
     
-    // 변환행렬 A 는 회전행렬을 제외하고 연산하기 위해 buildMatrix() 를 거치지 않고 직접 만들어 줌.
-    mat4 translationA = translate(vec3(-0.55, 0.0, 0.0)); // 이동행렬
-    mat4 scaleA = scale(vec3(1.5, 1, 1)); // 크기행렬
-    mat4 transformA = translationA * scaleA; // 크기연산 -> 이동연산 순으로 처리하는 변환핸렬
+    if (showProfiler) {
+        drawProfilerOverlay();
+    }
     
-    // 위 변환행렬 A 에 원하는 회전행렬을 적용함
-    // 이 때, 정반대 이동행렬인 translationA 의 역행렬을 곱해줘서 transformA 에서의 이동연산을 상쇄시킴.
-    // 크기연산 -> 회전연산 -> 이동연산 순으로 처리해주려면 중간에 낀 이동연산을 정반대 이동연산으로 상쇄시켜줘야 함!
-    mat4 ourRotation = rotate(rotation, vec3(0.0, 0.0, 1.0)); // 원하는 회전행렬 (매 프레임마다 갱신됨)
-    mat4 newMatrix = translationA * ourRotation * inverse(translationA); // 정반대 이동연산(glm 내장함수 inverse() 로 역행렬을 구함) -> 원하는 회전연산 -> 이동연산 순으로 처리하는 변환행렬
-    mat4 finalMatrixA = newMatrix * transformA; // 첫번째 구름메쉬에 최종적으로 적용할 변환행렬 (크기연산 -> (이동연산 -> 정반대 이동연산 (상쇄됨)) -> 원하는 회전연산 -> 이동연산) 순으로 처리됨.
+    // 프레임 당 드로우콜 및 상태 변경 횟수, 유니폼 전송 횟수를 실행창 제목에 표시함.
+    const SpriteBatchStats& stats = spriteBatch.getStats();
+    const UniformStats& uniformStats = spriteRenderer.getUniformStats();
+    ofSetWindowTitle("draw calls: " + ofToString(stats.drawCalls) + ", state changes: " + ofToString(stats.stateChanges()) + ", instances: " + ofToString(stats.instances) + ", culled: " + ofToString(culled)
+        + ", uniforms sent: " + ofToString(uniformStats.uploads) + ", skipped: " + ofToString(uniformStats.skipped));
+}
+
+//--------------------------------------------------------------
+// GL 대신 소프트웨어 래스터라이저로 spriteBatch 를 그리고, 지정한 프레임 수를 다 그리면 이미지로 저장한 뒤 종료함.
+void ofApp::drawHeadless(const glm::mat4& view, const glm::mat4& proj){
+    uint64_t start = ofGetElapsedTimeMicros();
+    {
+        PROFILE_SCOPE("rasterize");
+        rasterizer.draw(spriteBatch, view, proj);
+    }
+    headlessRenderMicros += ofGetElapsedTimeMicros() - start;
+    headlessFrame++;
     
-    mat4 transformB = buildMatrix(vec3(0.4, 0.2, 0.0), 1.0f, vec3(1, 1, 1)); // 버텍스 셰이더로 직접 계산했던 두 번째 구름메쉬의 변환행렬을 계산하여 리턴받음.
+    if (headlessFrame < headless.frames) {
+        return;
+    }
     
+    ofSaveImage(rasterizer.getPixels(), headless.output);
+    double seconds = headlessRenderMicros / 1000000.0;
+    ofLogNotice("ofApp") << "headless: " << headlessFrame << " frames at " << rasterizer.getWidth() << "x" << rasterizer.getHeight()
+        << " with " << rasterizer.getNumThreads() << " threads, " << (headlessFrame / seconds) << " frames/s -> " << headless.output;
     
-    // cloudShader 바인딩하여 사용 시작
-    cloudShader.begin();
+    // --trace 로 요청했으면 CPU 구간 기록을 크롬 트레이스 파일로 남김. (GPU 트랙은 없음)
+    if (!headless.trace.empty() && saveChromeTrace(FrameProfiler::get().collect(), headless.trace)) {
+        ofLogNotice("ofApp") << "headless: profile trace -> " << headless.trace;
+    }
     
-    cloudShader.setUniformTexture("tex", cloudImg, 0); // 구름 텍스쳐 이미지 유니폼 변수에 전송
-    cloudShader.setUniformMatrix4f("view", view); // 카메라 움직임의 정반대 방향으로 구름메쉬들의 움직임을 조정하는 뷰행렬도 유니폼 변수에 전송해 줌.
-    cloudShader.setUniformMatrix4f("proj", proj); // 뷰 좌표(공간)에 곱해줘서 클립공간으로 변환하기 위해 필요한 투영행렬도 유니폼 변수에 전송해 줌.
+    // 기준 이미지(golden image)가 주어지면 렌더링 결과와 비교해서, 다르면 종료 코드 1 로 종료함. (GPU 없는 CI 에서 회귀 테스트로 사용)
+    if (!headless.compare.empty() && !compareWithGolden(rasterizer.getPixels(), headless.compare, ofFilePath::removeExt(headless.output) + "_diff.png")) {
+        ofExit(1);
+        return;
+    }
+    ofExit();
+}
+
+//--------------------------------------------------------------
+/**
+ 최근 프레임들의 구간별 평균 시간을 화면 왼쪽 위에 표시함.
+ 
+ 프로파일러 기록을 모으는 것도 비용이 있으므로, 30 프레임마다 한 번씩만 모아서 통계를 갱신하고 그 사이에는 이전 통계를 그대로 그림.
+ GPU 구간은 쿼리 결과를 몇 프레임 늦게 읽어오므로, 통계 구간의 마지막 몇 프레임은 GPU 트랙에 빠져있을 수 있음.
+ */
+void ofApp::drawProfilerOverlay(){
+    PROFILE_SCOPE("profiler overlay");
+    const uint32_t refreshFrames = 30;
+    uint32_t frame = FrameProfiler::get().getFrame();
+    if (frame >= profileWindowFrame + refreshFrames) {
+        uint32_t first = profileWindowFrame + 1;
+        uint32_t last = frame - 1; // 지금 프레임은 아직 기록이 다 안 끝났으므로 뺌
+        profileSummary = summarizeFrames(FrameProfiler::get().collect(), first, last);
+        
+        int mainScopes = 0;
+        for (const ProfileSummary& entry : profileSummary) {
+            if (entry.track == "main") {
+                mainScopes += entry.count;
+            }
+        }
+        profileScopesPerFrame = mainScopes / (double)(last - first + 1);
+        profileWindowFrame = last;
+    }
     
-    cloudShader.setUniformMatrix4f("model", finalMatrixA); // 버텍스 셰이더에 mat4 변환행렬을 받는 유니폼변수에 첫번째 구름메쉬 변환행렬(이제부터는 '모델행렬')을 전송함.
-    cloudMesh.draw(); // 구름메쉬 드로우콜 호출하여 그려줌
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(3);
+    const char* orderNames[] = { "submit order", "back to front", "order independent" };
+    text << "profiler (p: hide, t: save trace), ms per frame\n";
+    text << "transparency: " << orderNames[transparentOrder] << " (o: switch)\n";
+    std::string track;
+    for (const ProfileSummary& entry : profileSummary) {
+        if (entry.track != track) {
+            track = entry.track;
+            text << "[" << track << "]\n";
+        }
+        text << std::string(entry.depth * 2 + 1, ' ') << entry.name << "  " << entry.meanMillis << " (max " << entry.maxMillis << ")\n";
+    }
     
-    cloudShader.setUniformMatrix4f("model", transformB); // 버텍스 셰이더에 mat4 변환행렬을 받는 유니폼변수에 두번째 구름메쉬 변환행렬(이제부터는 '모델행렬')을 전송함.
-    cloudMesh.draw(); // 구름메쉬 드로우콜 호출하여 그려줌 -> 하나의 메쉬를 가지고 여러 번 드로우콜을 호출하여 화면 상에 여러 개의 메쉬를 복사하여 그려줄 수 있음.
+    // 메인 스레드의 구간 수 * 구간 하나 기록 비용 = 프로파일러가 프레임마다 쓰는 시간 (추정치)
+    double frameMillis = 1000.0 / std::max(1.0f, ofGetFrameRate());
+    double overheadMillis = profileScopesPerFrame * profileScopeNanos / 1000000.0;
+    text << std::setprecision(1) << "overhead: " << profileScopesPerFrame << " scopes x " << profileScopeNanos << " ns = "
+        << std::setprecision(4) << (overheadMillis / frameMillis * 100.0) << "% of " << std::setprecision(1) << frameMillis << " ms";
     
-    cloudShader.end();
-    // cloudShader 사용 중단
+    ofDisableDepthTest();
+    ofEnableBlendMode(ofBlendMode::OF_BLENDMODE_ALPHA);
+    ofDrawBitmapStringHighlight(text.str(), 10, 20);
 }
 
 //--------------------------------------------------------------
 void ofApp::keyPressed(int key){
     if (key == ofKey::OF_KEY_RIGHT) {
         walkRight = true; // 오른쪽 화살표 키 입력 감지 시 walkRight 을 활성화함.
+        SimInput input;
+        input.walkRight = walkRight;
+        simulation.setInput(input); // 시뮬레이션 스레드의 다음 틱부터 적용됨
+    } else if (key == 'o' && !headless.enabled) {
+        // 반투명 패스 방식을 submit 순서 -> 깊이 정렬 -> OIT 순서로 돌아가며 바꿈. (OIT 를 지원하지 않으면 건너뜀)
+        transparentOrder = (TransparentOrder)((transparentOrder + 1) % 3);
+        if (transparentOrder == TRANSPARENT_ORDER_INDEPENDENT && !oit.isAvailable()) {
+            transparentOrder = TRANSPARENT_SUBMIT_ORDER;
+        }
+    } else if (key == 'p') {
+        showProfiler = !showProfiler;
+    } else if (key == 't') {
+        // 지금까지 남아있는 프로파일러 기록을 크롬 트레이스 파일로 저장함. (chrome://tracing 또는 Perfetto 에서 열 수 있음)
+        if (saveChromeTrace(FrameProfiler::get().collect(), "profile_trace.json")) {
+            ofLogNotice("ofApp") << "profile trace -> " << ofToDataPath("profile_trace.json", true);
+        }
     }
 }
 
@@ -220,6 +1160,9 @@ void ofApp::keyPressed(int key){
 void ofApp::keyReleased(int key){
     if (key == ofKey::OF_KEY_RIGHT) {
         walkRight = false; // 오른쪽 화살표 키 입력을 뗏을 때 walkRight 을 비활성화함.
+        SimInput input;
+        input.walkRight = walkRight;
+        simulation.setInput(input);
     }
 }
 
@@ -255,7 +1198,9 @@ void ofApp::mouseExited(int x, int y){
 
 //--------------------------------------------------------------
 void ofApp::windowResized(int w, int h){
-
+    if (!headless.enabled) {
+        oit.resize(w, h); // OIT 누적 버퍼는 화면 크기와 같아야 함.
+    }
 }
 
 //--------------------------------------------------------------
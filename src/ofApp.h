@@ -1,6 +1,19 @@
 #pragma once
 
 #include "ofMain.h"
+#include "spriteBatch.h"
+#include "spriteRenderer.h"
+#include "transformHierarchy.h"
+#include "softwareRasterizer.h"
+#include "spriteCulling.h"
+#include "textureAtlas.h"
+#include "assetLoader.h"
+#include "simulation.h"
+#include "walkerAnimation.h"
+#include "frameProfiler.h"
+#include "gpuProfiler.h"
+#include "sceneFile.h"
+#include "fileWatcher.h"
 
 // 카메라의 현재 위치, 회전값을 받는 구조체 타입 지정. (카메라 뷰 행렬 연산에서 크기값은 의미가 없으므로, 항상 (1, 1, 1) 로 가정함.)
 struct CameraData {
@@ -8,12 +21,69 @@ struct CameraData {
     float rotation;
 };
 
+// ofApp.cpp 에 정의된 모델행렬, 뷰행렬 계산 함수 (benchmarks.cpp 에서 배치 계산 결과와 비교하는 기준으로도 사용함)
+glm::mat4 buildMatrix(glm::vec3 trans, float rot, glm::vec3 scale);
+glm::mat4 buildViewMatrix(CameraData cam);
+
+// 장면에 배치된 스프라이트 하나. sceneGraph 노드의 월드행렬을 모델행렬로 사용하고, 어떤 셰이더, 아틀라스 프레임, 메쉬로 그릴지를 가지고 있음.
+struct SceneSprite {
+    int node;
+    int pass, shader, mesh; // spriteBatch.submit() 에 넘길 값들 (텍스쳐 id 는 프레임이 들어있는 아틀라스 페이지로 정해짐)
+    int frame; // atlas 의 프레임 번호 (텍스쳐가 아틀라스에 없으면 -1)
+    SpriteBounds localBounds; // buildMesh() 로 만든 쿼드의 로컬 공간 범위
+    SpriteBounds worldBounds; // localBounds 를 노드의 월드행렬로 변환한 범위 (노드가 움직일 때만 갱신)
+    int gridHandle; // spriteGrid 핸들. 격자에 없으면 (그리지 않는 스프라이트면) -1
+};
+
+// GPU 없이 소프트웨어 래스터라이저로 장면을 이미지 파일로 렌더링하는 헤드리스 모드 설정값 (main.cpp 의 커맨드라인 인자로 지정함)
+struct HeadlessSettings {
+    bool enabled = false;
+    int width = 1024;
+    int height = 768;
+    int threads = 0; // 0 이면 하드웨어 스레드 개수만큼 사용
+    int frames = 1; // 렌더링할 프레임 수. 마지막 프레임을 output 에 저장하고, 평균 렌더링 속도(frames/s)를 로그로 출력함.
+    std::string output = "headless.png";
+    std::string compare; // 비어있지 않으면 렌더링 결과를 이 기준 이미지(golden image)와 비교해서, 다르면 종료 코드 1 로 종료함.
+    std::string trace; // 비어있지 않으면 CPU 구간을 기록해서 이 경로에 크롬 트레이스 파일로 저장함. (비어있으면 프로파일러를 끔)
+};
+
+// 배경에서 걸어다니는 군중(워커) 설정값 (main.cpp 의 커맨드라인 인자로 지정함)
+struct CrowdSettings {
+    int walkers = 0; // 0 이면 군중을 만들지 않음
+    int threads = 0; // 워커 애니메이션 갱신에 사용할 스레드 수. 0 이면 하드웨어 스레드 개수만큼 사용
+    int clouds = 0; // 하늘에 추가로 띄울 반투명 구름 수 (반투명 정렬과 OIT 비용을 비교할 때 사용)
+};
+
+// 로드할 장면 파일 설정값 (main.cpp 의 커맨드라인 인자로 지정함)
+struct SceneSettings {
+    std::string file = "forest.scene"; // bin/data 기준 경로. 텍스트(.scene) 또는 바이너리(.scnb) 형식
+    int stressSprites = 0; // 0 보다 크면 file 에 구름, 캐릭터 스프라이트를 이만큼 더한 장면을 만들어서 대신 로드함 (스트리밍 로드, 파싱 속도 확인용)
+};
+
 class ofApp : public ofBaseApp{
 
 	public:
+		ofApp(HeadlessSettings headless = HeadlessSettings(), CrowdSettings crowd = CrowdSettings(), SceneSettings sceneSettings = SceneSettings()) : sceneSettings(sceneSettings), crowd(crowd), headless(headless) {}
+		
 		void setup();
 		void update();
 		void draw();
+		void exit();
+		void drawHeadless(const glm::mat4& view, const glm::mat4& proj);
+		int addSprite(int node, int pass, int shader, int frame, int mesh, SpriteBounds localBounds);
+		void updateSpriteBounds();
+		int getSpriteFrame(const SceneSpriteDesc& desc) const;
+		std::vector<std::shared_future<TextureDataPtr>> setupAtlas();
+		void addSceneShader(const SceneShaderDesc& desc);
+		void addSceneMesh(const SceneMeshDesc& desc);
+		void addSceneNode(const SceneNodeDesc& desc);
+		void addSceneSprites(const std::vector<SceneSpriteDesc>& descs);
+		void updateSceneStreaming(bool wait);
+		void reloadSceneShader(size_t index);
+		void reloadScene();
+		std::string writeStressScene();
+		void setupCrowd();
+		void drawProfilerOverlay();
 
 		void keyPressed(int key);
 		void keyReleased(int key);
@@ -28,26 +98,86 @@ class ofApp : public ofBaseApp{
 		void gotMessage(ofMessage msg);
 		
     // ofApp.cpp 에서 사용할 멤버 변수들을 헤더파일에 선언해놓음.
-    ofShader alphaTestShader; // 캐릭터 및 배경 메쉬를 draw 할 때 바인딩해서 사용할 셰이더 객체 변수 선언
-
-    ofMesh charMesh; // 캐릭터 텍스쳐를 씌워서 사용할 메쉬 객체 변수 선언
-    ofImage alienImg; // 캐릭터 텍스쳐를 로드한 뒤 프래그먼트 셰이더로 전송할 때 사용할 이미지 객체 변수 선언
     
-    ofMesh backgroundMesh; // 배경 텍스쳐를 씌워서 사용할 메쉬 객체 변수 선언
-    ofImage backgroundImg; // 배경 텍스쳐를 로드한 뒤, 프래그먼트 셰이더로 전송할 때 사용할 이미지 객체 변수 선언
+    /**
+     장면 파일 (bin/data/forest.scene)
+     
+     이전에는 메쉬, 셰이더, 텍스쳐, 노드, 스프라이트를 setup() 에서 하나씩 코드로 만들었는데, 이제는 장면 파일에 적어둔 대로 만듦.
+     카메라, 셰이더, 텍스쳐, 메쉬, 노드는 setup() 에서 바로 만들고, 스프라이트는 로더 스레드가 읽는 대로 update() 에서 묶음 단위로 추가함.
+     */
+    SceneSettings sceneSettings;
+    SceneLoader sceneLoader;
+    bool sceneStreaming = false; // 로더 스레드가 아직 스프라이트를 읽는 중
+    SceneHeader scene; // 지금 적용되어 있는 장면 헤더 (핫 리로드할 때 바뀐 항목을 찾는 데 사용)
+    std::vector<SceneSpriteDesc> sceneSprites; // 지금까지 추가한 장면 파일의 스프라이트들
+    std::vector<int> sceneSpriteIndices; // sceneSprites 와 같은 인덱스. sprites 의 인덱스
+    std::vector<std::unique_ptr<ofShader>> sceneShaders, sceneOITShaders; // scene.shaders 와 같은 인덱스. spriteRenderer 는 포인터를 보관하므로 셰이더마다 따로 할당함 (OIT 용이 없으면 nullptr)
+    std::vector<int> shaderIds, oitShaderIds; // scene.shaders 인덱스 -> spriteRenderer(또는 rasterizer) 에 등록한 셰이더 id (OIT 용이 없으면 -1)
+    std::vector<int> meshIds; // scene.meshes 인덱스 -> spriteRenderer(또는 rasterizer) 에 등록한 메쉬 id
+    std::vector<int> textureFrames; // scene.textures 인덱스 -> 첫 번째 아틀라스 프레임 번호
+    std::vector<int> sceneNodes; // scene.nodes 인덱스 -> sceneGraph 노드
     
-    ofShader cloudShader; // 알파 블렌딩 기법을 사용하기 위한 셰이더를 따로 만들어 사용할 것이므로 해당 셰이더 객체 변수 선언
-    ofMesh cloudMesh; // 구름 텍스쳐를 씌워서 사용할 메쉬 객체 변수 선언
-    ofImage cloudImg; // 구름 텍스쳐를 로드한 뒤, 프래그먼트 셰이더로 전송할 때 사용할 이미지 객체 변수 선언
+    // 장면 파일, 셰이더 파일이 바뀌면 바뀐 항목만 다시 로드함. (창 모드에서만)
+    FileWatcher fileWatcher;
+    float nextWatchTime = 0.0f;
     
-    ofMesh sunMesh; // 태양 텍스쳐를 씌워서 사용할 메쉬 객체 변수 선언
-    ofImage sunImg; // 태양 텍스쳐를 로드한 뒤, 프래그먼트 셰이더로 전송할 때 사용할 이미지 객체 변수 선언
+    // 반투명 패스를 그리는 방식. 'o' 키로 submit 순서 -> 깊이 정렬 -> OIT 순서로 바꿀 수 있음.
+    TransparentOrder transparentOrder = TRANSPARENT_BACK_TO_FRONT;
+    WeightedBlendedOIT oit; // OIT 누적 버퍼 및 합성 셰이더
     
-    ofShader spritesheetShader; // 스프라이트 시트 텍스쳐의 uv 좌표값의 전체 사이즈 및 오프셋을 조절하기 위한 셰이더를 바인딩하기 위해 새로운 셰이더 객체 변수 선언
+    // 캐릭터, 배경, 구름, 태양 텍스쳐를 따로 로드하지 않고, 하나로 합친 아틀라스 페이지 텍스쳐를 사용함.
+    // 스프라이트시트 프레임들도 아틀라스에 프레임 단위로 들어있으므로, 별도의 스프라이트시트 셰이더가 필요 없음.
+    TextureAtlas atlas;
+    AssetLoader assetLoader; // 이미지 디코딩, 텍스쳐 캐시 파일 로드를 워커 스레드에서 처리함.
+    std::vector<ofTexture> atlasTextures; // 아틀라스 페이지마다 하나씩 만든 GL 텍스쳐 (헤드리스 모드에서는 비어있음)
+    std::vector<int> atlasPageTexIds; // 아틀라스 페이지 번호 -> spriteRenderer(또는 rasterizer) 에 등록한 텍스쳐 id
+    int charFrame = 0; // 캐릭터 스프라이트 텍스쳐의 첫 번째 아틀라스 프레임 번호
+    int charFrameCount = 1; // 캐릭터 스프라이트 텍스쳐의 프레임 수 (걷기 프레임은 charFrame ~ charFrame + charFrameCount - 1 안에서 반복함)
     
     // 버텍스 셰이더를 이용해 캐릭터 메쉬를 움직이기 위해 필요한 멤버변수들
-    bool walkRight;
-    glm::vec3 charPos;
+    bool walkRight = false;
+    glm::vec3 charPos; // simulation 에서 보간해온 캐릭터 위치 (장면 파일에 적힌 위치 charBasePos 에서 움직인 거리)
+    glm::vec3 charBasePos;
+    
+    // 캐릭터 이동, 걷기 애니메이션, 구름 회전을 고정 틱으로 진행하는 시뮬레이션 스레드
+    Simulation simulation;
+    SimState simView; // update() 에서 현재 시각에 맞게 보간해온 시뮬레이션 상태
+    
+    // 배경에서 걸어다니는 군중. 워커마다 노드, 스프라이트를 만들지 않고 SoA 배열로 한꺼번에 갱신해서 인스턴스 데이터를 만듦.
+    CrowdSettings crowd;
+    WalkerAnimation walkerAnimation;
+    std::vector<SpriteInstance> crowdInstances; // update() 에서 워커마다 채운 인스턴스 데이터 (draw() 에서 그대로 submit 함)
+    int crowdShaderId, crowdMeshId; // 군중을 submit 할 때 사용하는 셰이더, 메쉬 id (장면의 alphaTest 셰이더, character 메쉬)
+    
+    CameraData cam; // 카메라 위치 및 회전의 현재 상태값을 나타내는 구조체를 타입으로 갖는 멤버변수 cam 을 선언함. (장면 파일의 camera 항목)
+    
+    // 메쉬마다 드로우콜을 호출하지 않고, 인스턴스 드로우로 묶어서 그리기 위한 멤버변수들
+    SpriteBatch spriteBatch; // 매 프레임 그릴 스프라이트들을 모아서 정렬, 그룹화하는 배치
+    SpriteRenderer spriteRenderer; // 배치 결과를 인스턴스 드로우로 그려주는 렌더러
+    
+    // 매 프레임 모든 모델행렬을 새로 만들지 않고, 바뀐 노드만 다시 계산하기 위한 변환 계층구조
+    TransformHierarchy sceneGraph;
+    int charNode = -1, cloudNodeA = -1; // 매 프레임 움직이는 노드 (장면 파일의 character, cloudA 스프라이트가 로드되기 전에는 -1)
+    
+    // 프러스텀 밖의 스프라이트를 submit 전에 걸러내기 위한 멤버변수들
+    std::vector<SceneSprite> sprites; // 장면의 모든 스프라이트 (submit 순서 = 인덱스 순서)
+    std::vector<int> nodeSprites; // sceneGraph 노드 -> 그 노드를 쓰는 sprites 인덱스 (스프라이트 노드가 아니면 -1)
+    SpatialGrid spriteGrid; // 스프라이트들의 월드 공간 범위를 기록해두는 균일 격자
+    std::vector<int> visibleSprites; // 매 프레임 격자에서 조회한 스프라이트 인덱스
+    int charSprite = -1; // 매 프레임 스프라이트시트 프레임을 바꿔줘야 하는 캐릭터 스프라이트 인덱스
+    
+    // 헤드리스 모드에서는 spriteRenderer 대신 rasterizer 로 spriteBatch 를 그림.
+    HeadlessSettings headless;
+    SoftwareRasterizer rasterizer;
+    ofColor backgroundColor = ofColor(60, 60, 60); // 오픈프레임웍스 기본 배경색. GL 경로는 ofBackground() 로, 래스터라이저는 클리어 색으로 같은 색을 사용함.
+    int headlessFrame = 0; // 지금까지 렌더링한 프레임 수
+    uint64_t headlessRenderMicros = 0; // 래스터라이저에서 걸린 누적 시간
     
-    CameraData cam; // 카메라 위치 및 회전의 현재 상태값을 나타내는 구조체를 타입으로 갖는 멤버변수 cam 을 선언함.
+    // 프레임 시간이 어디에 쓰이는지 보기 위한 프로파일러 (CPU 구간은 FrameProfiler::get() 에 기록됨)
+    GpuProfiler gpuProfiler; // 헤드리스 모드에서는 setup() 하지 않으므로 아무것도 하지 않음
+    bool showProfiler = true; // 'p' 키로 오버레이를 켜고 끔
+    std::vector<ProfileSummary> profileSummary; // 오버레이에 표시하는 최근 프레임들의 구간별 통계
+    double profileScopesPerFrame = 0.0; // CPU 구간 수 (오버헤드 추정용)
+    double profileScopeNanos = 0.0; // setup() 에서 측정한 구간 하나를 기록하는 데 드는 시간
+    uint32_t profileWindowFrame = 0; // 통계를 모으기 시작한 프레임 번호
 };
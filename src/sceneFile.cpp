@@ -0,0 +1,836 @@
+#include "sceneFile.h"
+#include "frameProfiler.h"
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+
+namespace {
+
+enum ChunkType : uint32_t {
+    CHUNK_CAMERA = 1,
+    CHUNK_SHADER = 2,
+    CHUNK_TEXTURE = 3,
+    CHUNK_MESH = 4,
+    CHUNK_NODE = 5,
+    CHUNK_SPRITE = 6,
+};
+
+const char BINARY_MAGIC[4] = { 'S', 'C', 'N', '1' };
+const int MAX_TOKENS = 20; // sprite 줄의 최대 토큰 수 (16) 보다 넉넉하게
+
+//--------------------------------------------------------------
+// 줄을 공백으로 나눈 토큰들. 줄 문자열 안에 '\0' 을 넣어서 자르므로 토큰마다 문자열을 새로 만들지 않음.
+struct LineTokens {
+    char* tokens[MAX_TOKENS];
+    int count = 0;
+
+    // # 뒤는 주석이므로 무시함. 토큰이 MAX_TOKENS 개보다 많으면 나머지는 버림.
+    void split(std::string& line) {
+        count = 0;
+        char* c = &line[0];
+        while (*c && count < MAX_TOKENS) {
+            while (*c == ' ' || *c == '\t' || *c == '\r') {
+                ++c;
+            }
+            if (*c == '\0' || *c == '#') {
+                break;
+            }
+            tokens[count++] = c;
+            while (*c && *c != ' ' && *c != '\t' && *c != '\r' && *c != '#') {
+                ++c;
+            }
+            if (*c == '#') {
+                *c = '\0';
+                break;
+            }
+            if (*c) {
+                *c++ = '\0';
+            }
+        }
+    }
+};
+
+bool parseFloat(const char* token, float& out) {
+    char* end;
+    out = strtof(token, &end);
+    return end != token && *end == '\0';
+}
+
+bool parseInt(const char* token, int& out) {
+    char* end;
+    long value = strtol(token, &end, 10);
+    out = (int)value;
+    return end != token && *end == '\0';
+}
+
+// tokens[first] 부터 float 을 count 개 읽음.
+bool parseFloats(const LineTokens& line, int first, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        if (first + i >= line.count || !parseFloat(line.tokens[first + i], out[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ tokens[first] 부터 <tx> <ty> <tz> [<rotation> [<sx> <sy> [<sz>]]] 를 읽음.
+ rotation 이 없으면 0, 크기가 없으면 (1, 1, 1), sz 가 없으면 1.
+ */
+bool parseTransform(const LineTokens& line, int first, SceneTransform& out) {
+    float values[7] = { 0, 0, 0, 0, 1, 1, 1 };
+    int given = line.count - first;
+    if (given != 3 && given != 4 && given != 6 && given != 7) {
+        return false;
+    }
+    if (!parseFloats(line, first, values, given)) {
+        return false;
+    }
+    out.position = glm::vec3(values[0], values[1], values[2]);
+    out.rotation = values[3];
+    out.scale = glm::vec3(values[4], values[5], values[6]);
+    return true;
+}
+
+// 텍스트 형식에서 "-" 는 '없음' 을 뜻함.
+bool isNone(const char* token) {
+    return token[0] == '-' && token[1] == '\0';
+}
+
+/**
+ 이름으로 인덱스를 찾음. 없으면 -1
+ 스프라이트들은 보통 같은 메쉬, 셰이더, 텍스쳐를 연달아 참조하므로, 바로 전에 찾은 이름이면 해시 테이블을 보지 않음.
+ */
+struct NameLookup {
+    const std::unordered_map<std::string, int>* names = nullptr;
+    std::string last;
+    int lastIndex = -1;
+
+    int find(const char* name) {
+        if (lastIndex >= 0 && last == name) {
+            return lastIndex;
+        }
+        std::unordered_map<std::string, int>::const_iterator it = names->find(name);
+        if (it == names->end()) {
+            return -1;
+        }
+        last = name;
+        lastIndex = it->second;
+        return lastIndex;
+    }
+};
+
+//--------------------------------------------------------------
+// 바이너리 청크를 읽는 도우미. 범위를 벗어나면 ok 가 false 가 되고 이후로는 0 을 읽음.
+struct BinaryReader {
+    const char* p;
+    const char* end;
+    bool ok = true;
+
+    BinaryReader(const char* data, size_t size) : p(data), end(data + size) {}
+
+    template<typename T> T read() {
+        T value = T();
+        if (end - p < (ptrdiff_t)sizeof(T)) {
+            ok = false;
+            p = end;
+            return value;
+        }
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    void readString(std::string& out) {
+        uint16_t length = read<uint16_t>();
+        if (end - p < length) {
+            ok = false;
+            p = end;
+            out.clear();
+            return;
+        }
+        out.assign(p, length);
+        p += length;
+    }
+
+    void readTransform(SceneTransform& out) {
+        float values[7];
+        for (float& v : values) {
+            v = read<float>();
+        }
+        out.position = glm::vec3(values[0], values[1], values[2]);
+        out.rotation = values[3];
+        out.scale = glm::vec3(values[4], values[5], values[6]);
+    }
+};
+
+struct BinaryWriter {
+    std::vector<char> data;
+
+    template<typename T> void write(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void writeString(const std::string& s) {
+        uint16_t length = (uint16_t)std::min<size_t>(s.size(), 0xffff);
+        write(length);
+        data.insert(data.end(), s.begin(), s.begin() + length);
+    }
+
+    void writeTransform(const SceneTransform& t) {
+        const float values[7] = { t.position.x, t.position.y, t.position.z, t.rotation, t.scale.x, t.scale.y, t.scale.z };
+        for (float v : values) {
+            write(v);
+        }
+    }
+};
+
+void writeChunk(std::ostream& out, uint32_t type, uint32_t count, const BinaryWriter& payload) {
+    uint32_t bytes = (uint32_t)payload.data.size();
+    out.write(reinterpret_cast<const char*>(&type), sizeof(type));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+    out.write(payload.data.data(), payload.data.size());
+}
+
+template<typename T> int findByName(const std::vector<T>& entries, const std::string& name) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].name == name) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+uint64_t getFileSize(std::ifstream& file) {
+    std::streampos position = file.tellg();
+    file.seekg(0, std::ios::end);
+    uint64_t size = (uint64_t)file.tellg();
+    file.seekg(position);
+    return size;
+}
+
+} // namespace
+
+//--------------------------------------------------------------
+bool SceneCamera::operator==(const SceneCamera& o) const {
+    return position == o.position && rotation == o.rotation && left == o.left && right == o.right
+        && bottom == o.bottom && top == o.top && nearClip == o.nearClip && farClip == o.farClip;
+}
+
+bool SceneTextureDesc::operator==(const SceneTextureDesc& o) const {
+    return name == o.name && file == o.file && frameSize == o.frameSize && columns == o.columns && frameCount == o.frameCount;
+}
+
+int SceneHeader::findShader(const std::string& name) const { return findByName(shaders, name); }
+int SceneHeader::findTexture(const std::string& name) const { return findByName(textures, name); }
+int SceneHeader::findMesh(const std::string& name) const { return findByName(meshes, name); }
+int SceneHeader::findNode(const std::string& name) const { return findByName(nodes, name); }
+
+//--------------------------------------------------------------
+bool SceneLoader::open(const std::string& path, SceneHeader& header) {
+    close();
+    startTime = Clock::now();
+    this->path = path;
+    header = SceneHeader();
+    stats = SceneLoadStats();
+    lineNumber = 0;
+    pendingLine.clear();
+    chunkBuffer.clear();
+    chunkOffset = 0;
+    chunkRemaining = 0;
+    failed = false;
+    spritesRead = 0;
+    done = false;
+    chunks.clear();
+
+    file.open(ofToDataPath(path), std::ios::binary);
+    if (!file) {
+        ofLogError("SceneLoader") << "open(): could not open " << path;
+        return false;
+    }
+    stats.bytes = getFileSize(file);
+
+    char magic[4] = { 0, 0, 0, 0 };
+    file.read(magic, sizeof(magic));
+    binary = file.gcount() == sizeof(magic) && memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0;
+    if (!binary) {
+        file.clear();
+        file.seekg(0);
+    }
+
+    bool ok = binary ? openBinary(header) : openText(header);
+    headerEntities = 1 + header.shaders.size() + header.textures.size() + header.meshes.size() + header.nodes.size(); // 1 = camera
+    numShaders = (int)header.shaders.size();
+    numMeshes = (int)header.meshes.size();
+    numNodes = (int)header.nodes.size();
+    textureFrameCounts.clear();
+    for (const SceneTextureDesc& texture : header.textures) {
+        textureFrameCounts.push_back(texture.frameCount);
+    }
+    if (!ok) {
+        file.close();
+    }
+    return ok;
+}
+
+/**
+ 첫 번째 sprite 줄이 나올 때까지 헤더 항목들을 읽음.
+ 잘못된 줄은 경고를 남기고 건너뛰므로, 파일을 편집하다가 한 줄을 잘못 적어도 나머지 장면은 그대로 로드됨.
+ */
+bool SceneLoader::openText(SceneHeader& header) {
+    shaderNames.clear();
+    textureNames.clear();
+    meshNames.clear();
+    nodeNames.clear();
+
+    std::string line;
+    LineTokens tokens;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::string original = line;
+        tokens.split(line);
+        if (tokens.count == 0) {
+            continue;
+        }
+        const char* type = tokens.tokens[0];
+        bool valid = true;
+
+        if (strcmp(type, "sprite") == 0) {
+            pendingLine = original;
+            break;
+        } else if (strcmp(type, "camera") == 0) {
+            float v[10];
+            valid = tokens.count == 11 && parseFloats(tokens, 1, v, 10);
+            if (valid) {
+                SceneCamera& camera = header.camera;
+                camera.position = glm::vec3(v[0], v[1], v[2]);
+                camera.rotation = v[3];
+                camera.left = v[4];
+                camera.right = v[5];
+                camera.bottom = v[6];
+                camera.top = v[7];
+                camera.nearClip = v[8];
+                camera.farClip = v[9];
+            }
+        } else if (strcmp(type, "shader") == 0) {
+            valid = tokens.count == 4 || tokens.count == 5;
+            if (valid) {
+                SceneShaderDesc shader;
+                shader.name = tokens.tokens[1];
+                shader.vert = tokens.tokens[2];
+                shader.frag = tokens.tokens[3];
+                shader.oitFrag = tokens.count == 5 ? tokens.tokens[4] : "";
+                shaderNames[shader.name] = (int)header.shaders.size();
+                header.shaders.push_back(shader);
+            }
+        } else if (strcmp(type, "texture") == 0) {
+            SceneTextureDesc texture;
+            valid = tokens.count == 3 || (tokens.count == 7 && parseFloat(tokens.tokens[3], texture.frameSize.x) && parseFloat(tokens.tokens[4], texture.frameSize.y)
+                && parseInt(tokens.tokens[5], texture.columns) && parseInt(tokens.tokens[6], texture.frameCount) && texture.columns > 0 && texture.frameCount > 0);
+            if (valid) {
+                texture.name = tokens.tokens[1];
+                texture.file = tokens.tokens[2];
+                textureNames[texture.name] = (int)header.textures.size();
+                header.textures.push_back(texture);
+            }
+        } else if (strcmp(type, "mesh") == 0) {
+            float v[5];
+            valid = tokens.count == 7 && parseFloats(tokens, 2, v, 5);
+            if (valid) {
+                SceneMeshDesc mesh;
+                mesh.name = tokens.tokens[1];
+                mesh.halfWidth = v[0];
+                mesh.halfHeight = v[1];
+                mesh.offset = glm::vec3(v[2], v[3], v[4]);
+                meshNames[mesh.name] = (int)header.meshes.size();
+                header.meshes.push_back(mesh);
+            }
+        } else if (strcmp(type, "node") == 0) {
+            SceneNodeDesc node;
+            valid = tokens.count >= 3 && parseTransform(tokens, 3, node.transform);
+            if (valid && !isNone(tokens.tokens[2])) {
+                std::unordered_map<std::string, int>::const_iterator parent = nodeNames.find(tokens.tokens[2]);
+                node.parent = parent != nodeNames.end() ? parent->second : -1;
+                if (node.parent < 0) {
+                    ofLogWarning("SceneLoader") << path << ":" << lineNumber << ": unknown parent node " << tokens.tokens[2];
+                    continue;
+                }
+            }
+            if (valid) {
+                node.name = tokens.tokens[1];
+                nodeNames[node.name] = (int)header.nodes.size();
+                header.nodes.push_back(node);
+            }
+        } else {
+            ofLogWarning("SceneLoader") << path << ":" << lineNumber << ": unknown entry " << type;
+            continue;
+        }
+
+        if (!valid) {
+            ofLogWarning("SceneLoader") << path << ":" << lineNumber << ": malformed " << type << " entry, skipped";
+        }
+    }
+    return true;
+}
+
+// 첫 번째 스프라이트 청크가 나올 때까지 헤더 청크들을 읽음. 스프라이트 청크는 readBinarySprites() 에서 읽음.
+bool SceneLoader::openBinary(SceneHeader& header) {
+    std::vector<char> payload;
+    while (true) {
+        std::streampos chunkStart = file.tellg();
+        uint32_t info[3]; // 종류, 항목 수, 바이트 수
+        file.read(reinterpret_cast<char*>(info), sizeof(info));
+        if (file.gcount() != sizeof(info)) {
+            file.clear();
+            return true; // 스프라이트가 없는 장면
+        }
+        if (info[0] == CHUNK_SPRITE) {
+            file.seekg(chunkStart);
+            return true;
+        }
+
+        // 바이트 수가 깨졌으면 남은 파일 크기보다 큰 버퍼를 할당하지 않도록 먼저 확인함.
+        if (info[2] > stats.bytes - (uint64_t)file.tellg()) {
+            ofLogError("SceneLoader") << "open(): " << path << " is truncated";
+            failed = true;
+            return false;
+        }
+        payload.resize(info[2]);
+        file.read(payload.data(), payload.size());
+
+        BinaryReader reader(payload.data(), payload.size());
+        for (uint32_t i = 0; i < info[1] && reader.ok; ++i) {
+            switch (info[0]) {
+                case CHUNK_CAMERA: {
+                    SceneCamera& camera = header.camera;
+                    camera.position.x = reader.read<float>();
+                    camera.position.y = reader.read<float>();
+                    camera.position.z = reader.read<float>();
+                    camera.rotation = reader.read<float>();
+                    camera.left = reader.read<float>();
+                    camera.right = reader.read<float>();
+                    camera.bottom = reader.read<float>();
+                    camera.top = reader.read<float>();
+                    camera.nearClip = reader.read<float>();
+                    camera.farClip = reader.read<float>();
+                    break;
+                }
+                case CHUNK_SHADER: {
+                    SceneShaderDesc shader;
+                    reader.readString(shader.name);
+                    reader.readString(shader.vert);
+                    reader.readString(shader.frag);
+                    reader.readString(shader.oitFrag);
+                    header.shaders.push_back(shader);
+                    break;
+                }
+                case CHUNK_TEXTURE: {
+                    SceneTextureDesc texture;
+                    reader.readString(texture.name);
+                    reader.readString(texture.file);
+                    texture.frameSize.x = reader.read<float>();
+                    texture.frameSize.y = reader.read<float>();
+                    texture.columns = std::max(1, reader.read<int32_t>()); // 텍스트 형식처럼 1 이상이어야 함. (건너뛰면 뒤의 인덱스가 밀리므로 잘라줌)
+                    texture.frameCount = std::max(1, reader.read<int32_t>());
+                    header.textures.push_back(texture);
+                    break;
+                }
+                case CHUNK_MESH: {
+                    SceneMeshDesc mesh;
+                    reader.readString(mesh.name);
+                    mesh.halfWidth = reader.read<float>();
+                    mesh.halfHeight = reader.read<float>();
+                    mesh.offset.x = reader.read<float>();
+                    mesh.offset.y = reader.read<float>();
+                    mesh.offset.z = reader.read<float>();
+                    header.meshes.push_back(mesh);
+                    break;
+                }
+                case CHUNK_NODE: {
+                    SceneNodeDesc node;
+                    reader.readString(node.name);
+                    node.parent = reader.read<int32_t>();
+                    reader.readTransform(node.transform);
+                    if (node.parent >= (int)header.nodes.size()) {
+                        node.parent = -1; // 부모는 항상 먼저 나와야 함
+                    }
+                    header.nodes.push_back(node);
+                    break;
+                }
+                default:
+                    i = info[1]; // 모르는 청크는 통째로 건너뜀 (이후 버전에서 추가된 청크)
+                    break;
+            }
+        }
+        if (!reader.ok) {
+            ofLogError("SceneLoader") << "open(): " << path << " has a malformed chunk (type " << info[0] << ")";
+            failed = true;
+            return false;
+        }
+    }
+}
+
+//--------------------------------------------------------------
+bool SceneLoader::checkSprite(SceneSpriteDesc& sprite) const {
+    if (sprite.parent < -1 || sprite.parent >= numNodes || sprite.mesh < 0 || sprite.mesh >= numMeshes || sprite.shader < 0 || sprite.shader >= numShaders
+        || sprite.texture < 0 || sprite.texture >= (int)textureFrameCounts.size() || (sprite.pass != 0 && sprite.pass != 1)) {
+        return false;
+    }
+    sprite.frame = std::max(0, std::min(sprite.frame, textureFrameCounts[sprite.texture] - 1));
+    return true;
+}
+
+bool SceneLoader::readSprites(std::vector<SceneSpriteDesc>& out, size_t count) {
+    return binary ? readBinarySprites(out, count) : readTextSprites(out, count);
+}
+
+bool SceneLoader::readTextSprites(std::vector<SceneSpriteDesc>& out, size_t count) {
+    NameLookup meshes, shaders, textures, nodes;
+    meshes.names = &meshNames;
+    shaders.names = &shaderNames;
+    textures.names = &textureNames;
+    nodes.names = &nodeNames;
+
+    std::string line;
+    LineTokens tokens;
+    size_t read = 0;
+    while (read < count) {
+        if (!pendingLine.empty()) {
+            line.swap(pendingLine);
+            pendingLine.clear();
+        } else if (std::getline(file, line)) {
+            lineNumber++;
+        } else {
+            return false;
+        }
+        tokens.split(line);
+        if (tokens.count == 0) {
+            continue;
+        }
+        if (strcmp(tokens.tokens[0], "sprite") != 0) {
+            ofLogWarning("SceneLoader") << path << ":" << lineNumber << ": " << tokens.tokens[0] << " entry after the first sprite, skipped";
+            continue;
+        }
+
+        SceneSpriteDesc sprite;
+        const char* pass = tokens.count > 7 ? tokens.tokens[7] : "";
+        bool valid = tokens.count >= 8 && parseInt(tokens.tokens[6], sprite.frame) && parseTransform(tokens, 8, sprite.transform);
+        if (strcmp(pass, "opaque") == 0) {
+            sprite.pass = 0;
+        } else if (strcmp(pass, "transparent") == 0) {
+            sprite.pass = 1;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            ofLogWarning("SceneLoader") << path << ":" << lineNumber << ": malformed sprite entry, skipped";
+            continue;
+        }
+
+        sprite.parent = isNone(tokens.tokens[2]) ? -1 : nodes.find(tokens.tokens[2]);
+        sprite.mesh = meshes.find(tokens.tokens[3]);
+        sprite.shader = shaders.find(tokens.tokens[4]);
+        sprite.texture = textures.find(tokens.tokens[5]);
+        if ((sprite.parent < 0 && !isNone(tokens.tokens[2])) || !checkSprite(sprite)) {
+            ofLogWarning("SceneLoader") << path << ":" << lineNumber << ": sprite refers to an unknown node, mesh, shader or texture, skipped";
+            continue;
+        }
+        if (!isNone(tokens.tokens[1])) {
+            sprite.name = tokens.tokens[1];
+        }
+        out.push_back(std::move(sprite));
+        read++;
+    }
+    return true;
+}
+
+bool SceneLoader::readBinarySprites(std::vector<SceneSpriteDesc>& out, size_t count) {
+    size_t read = 0;
+    while (read < count) {
+        if (chunkRemaining == 0) {
+            uint32_t info[3];
+            file.read(reinterpret_cast<char*>(info), sizeof(info));
+            if (file.gcount() == 0) {
+                return false; // 파일 끝
+            }
+            if (file.gcount() != sizeof(info) || info[2] > stats.bytes - (uint64_t)file.tellg()) {
+                ofLogError("SceneLoader") << path << " is truncated";
+                failed = true;
+                return false;
+            }
+            chunkBuffer.resize(info[2]);
+            file.read(chunkBuffer.data(), chunkBuffer.size());
+            chunkOffset = 0;
+            chunkRemaining = info[0] == CHUNK_SPRITE ? info[1] : 0; // 스프라이트 뒤에 나온 다른 청크는 무시함
+            continue;
+        }
+
+        // 범위를 벗어난 인덱스를 참조하는 스프라이트는 텍스트 형식처럼 건너뜀. (스프라이트마다 로그를 남기지 않고 묶음마다 한 번만 남김)
+        BinaryReader reader(chunkBuffer.data() + chunkOffset, chunkBuffer.size() - chunkOffset);
+        size_t skipped = 0;
+        while (chunkRemaining > 0 && read < count) {
+            SceneSpriteDesc sprite;
+            reader.readString(sprite.name);
+            sprite.parent = reader.read<int32_t>();
+            sprite.mesh = reader.read<int32_t>();
+            sprite.shader = reader.read<int32_t>();
+            sprite.texture = reader.read<int32_t>();
+            sprite.frame = reader.read<int32_t>();
+            sprite.pass = reader.read<int32_t>();
+            reader.readTransform(sprite.transform);
+            if (!reader.ok) {
+                ofLogError("SceneLoader") << path << " has a malformed sprite chunk";
+                failed = true;
+                return false;
+            }
+            chunkRemaining--;
+            if (!checkSprite(sprite)) {
+                skipped++;
+                continue;
+            }
+            out.push_back(std::move(sprite));
+            read++;
+        }
+        chunkOffset = reader.p - chunkBuffer.data();
+        if (skipped > 0) {
+            ofLogWarning("SceneLoader") << path << ": " << skipped << " sprites refer to an unknown node, mesh, shader, texture or pass, skipped";
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+void SceneLoader::start(size_t chunkSize) {
+    if (!file.is_open() || thread.joinable()) {
+        return;
+    }
+    running = true;
+    thread = std::thread(&SceneLoader::run, this, std::max<size_t>(1, chunkSize));
+}
+
+/**
+ 스프라이트를 chunkSize 개씩 읽어서 큐에 넣음.
+ 메인 스레드가 프레임마다 꺼내가는 속도보다 읽는 속도가 훨씬 빠르므로, 큐가 가득 차면 자리가 날 때까지 기다려서
+ 아직 장면에 넣지 못한 스프라이트가 메모리에 계속 쌓이지 않도록 함.
+ */
+void SceneLoader::run(size_t chunkSize) {
+    FrameProfiler::get().setThreadName("scene loader");
+    bool more = true;
+    while (more && running) {
+        SceneChunk chunk;
+        chunk.first = spritesRead;
+        chunk.sprites.reserve(chunkSize);
+        {
+            PROFILE_SCOPE("scene chunk");
+            more = readSprites(chunk.sprites, chunkSize);
+        }
+        spritesRead += chunk.sprites.size();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        space.wait(lock, [this]() { return chunks.size() < MAX_QUEUED_CHUNKS || !running; });
+        if (!chunk.sprites.empty()) {
+            chunks.push_back(std::move(chunk));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.entities = headerEntities + spritesRead;
+    stats.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+    done = true;
+}
+
+bool SceneLoader::poll(SceneChunk& chunk) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (chunks.empty()) {
+        return false;
+    }
+    chunk = std::move(chunks.front());
+    chunks.pop_front();
+    space.notify_one();
+    return true;
+}
+
+bool SceneLoader::isFinished() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return done && chunks.empty();
+}
+
+SceneLoadStats SceneLoader::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void SceneLoader::close() {
+    if (thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        space.notify_all();
+        thread.join();
+    }
+    running = false;
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+bool SceneLoader::load(const std::string& path, SceneHeader& header, std::vector<SceneSpriteDesc>& sprites, SceneLoadStats* stats) {
+    SceneLoader loader;
+    if (!loader.open(path, header)) {
+        return false;
+    }
+    sprites.clear();
+    while (loader.readSprites(sprites, DEFAULT_CHUNK_SIZE)) {
+    }
+    if (loader.failed) {
+        return false;
+    }
+    if (stats) {
+        *stats = loader.stats;
+        stats->entities = loader.headerEntities + sprites.size();
+        stats->seconds = std::chrono::duration<double>(Clock::now() - loader.startTime).count();
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+static void writeTransformText(std::ostream& out, const SceneTransform& t) {
+    out << t.position.x << " " << t.position.y << " " << t.position.z;
+    if (t.rotation != 0.0f || t.scale != glm::vec3(1, 1, 1)) {
+        out << " " << t.rotation;
+    }
+    if (t.scale != glm::vec3(1, 1, 1)) {
+        out << " " << t.scale.x << " " << t.scale.y;
+        if (t.scale.z != 1.0f) {
+            out << " " << t.scale.z;
+        }
+    }
+}
+
+bool saveSceneText(const std::string& path, const SceneHeader& header, const std::vector<SceneSpriteDesc>& sprites) {
+    std::ofstream out(ofToDataPath(path, true), std::ios::binary);
+    if (!out) {
+        ofLogError("SceneLoader") << "saveSceneText(): could not open " << path;
+        return false;
+    }
+    out << std::setprecision(7);
+
+    const SceneCamera& c = header.camera;
+    out << "camera " << c.position.x << " " << c.position.y << " " << c.position.z << " " << c.rotation << " "
+        << c.left << " " << c.right << " " << c.bottom << " " << c.top << " " << c.nearClip << " " << c.farClip << "\n";
+    for (const SceneShaderDesc& s : header.shaders) {
+        out << "shader " << s.name << " " << s.vert << " " << s.frag << (s.oitFrag.empty() ? "" : " ") << s.oitFrag << "\n";
+    }
+    for (const SceneTextureDesc& t : header.textures) {
+        out << "texture " << t.name << " " << t.file;
+        if (t.frameCount > 1) {
+            out << " " << t.frameSize.x << " " << t.frameSize.y << " " << t.columns << " " << t.frameCount;
+        }
+        out << "\n";
+    }
+    for (const SceneMeshDesc& m : header.meshes) {
+        out << "mesh " << m.name << " " << m.halfWidth << " " << m.halfHeight << " " << m.offset.x << " " << m.offset.y << " " << m.offset.z << "\n";
+    }
+    for (const SceneNodeDesc& n : header.nodes) {
+        out << "node " << n.name << " " << (n.parent >= 0 ? header.nodes[n.parent].name : "-") << " ";
+        writeTransformText(out, n.transform);
+        out << "\n";
+    }
+    for (const SceneSpriteDesc& s : sprites) {
+        out << "sprite " << (s.name.empty() ? "-" : s.name) << " " << (s.parent >= 0 ? header.nodes[s.parent].name : "-") << " "
+            << header.meshes[s.mesh].name << " " << header.shaders[s.shader].name << " " << header.textures[s.texture].name << " "
+            << s.frame << " " << (s.pass == 0 ? "opaque" : "transparent") << " ";
+        writeTransformText(out, s.transform);
+        out << "\n";
+    }
+    return (bool)out;
+}
+
+static bool writeSceneBinary(std::ofstream& out, const SceneHeader& header, const std::vector<SceneSpriteDesc>& sprites) {
+    out.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+
+    BinaryWriter camera;
+    const SceneCamera& c = header.camera;
+    for (float v : { c.position.x, c.position.y, c.position.z, c.rotation, c.left, c.right, c.bottom, c.top, c.nearClip, c.farClip }) {
+        camera.write(v);
+    }
+    writeChunk(out, CHUNK_CAMERA, 1, camera);
+
+    BinaryWriter shaders;
+    for (const SceneShaderDesc& s : header.shaders) {
+        shaders.writeString(s.name);
+        shaders.writeString(s.vert);
+        shaders.writeString(s.frag);
+        shaders.writeString(s.oitFrag);
+    }
+    writeChunk(out, CHUNK_SHADER, (uint32_t)header.shaders.size(), shaders);
+
+    BinaryWriter textures;
+    for (const SceneTextureDesc& t : header.textures) {
+        textures.writeString(t.name);
+        textures.writeString(t.file);
+        textures.write(t.frameSize.x);
+        textures.write(t.frameSize.y);
+        textures.write((int32_t)t.columns);
+        textures.write((int32_t)t.frameCount);
+    }
+    writeChunk(out, CHUNK_TEXTURE, (uint32_t)header.textures.size(), textures);
+
+    BinaryWriter meshes;
+    for (const SceneMeshDesc& m : header.meshes) {
+        meshes.writeString(m.name);
+        for (float v : { m.halfWidth, m.halfHeight, m.offset.x, m.offset.y, m.offset.z }) {
+            meshes.write(v);
+        }
+    }
+    writeChunk(out, CHUNK_MESH, (uint32_t)header.meshes.size(), meshes);
+
+    BinaryWriter nodes;
+    for (const SceneNodeDesc& n : header.nodes) {
+        nodes.writeString(n.name);
+        nodes.write((int32_t)n.parent);
+        nodes.writeTransform(n.transform);
+    }
+    writeChunk(out, CHUNK_NODE, (uint32_t)header.nodes.size(), nodes);
+
+    // 스프라이트는 로더가 청크 단위로 읽으므로, 청크 하나가 너무 커지지 않도록 나눠서 씀.
+    for (size_t first = 0; first < sprites.size(); first += SceneLoader::BINARY_SPRITES_PER_CHUNK) {
+        size_t last = std::min(sprites.size(), first + SceneLoader::BINARY_SPRITES_PER_CHUNK);
+        BinaryWriter chunk;
+        chunk.data.reserve((last - first) * 54); // 이름 없는 스프라이트 하나의 크기
+        for (size_t i = first; i < last; ++i) {
+            const SceneSpriteDesc& s = sprites[i];
+            chunk.writeString(s.name);
+            for (int v : { s.parent, s.mesh, s.shader, s.texture, s.frame, s.pass }) {
+                chunk.write((int32_t)v);
+            }
+            chunk.writeTransform(s.transform);
+        }
+        writeChunk(out, CHUNK_SPRITE, (uint32_t)(last - first), chunk);
+    }
+    return (bool)out;
+}
+
+// assetLoader 의 .texc 캐시처럼 임시 파일에 다 쓴 뒤 이름을 바꿈.
+bool saveSceneBinary(const std::string& path, const SceneHeader& header, const std::vector<SceneSpriteDesc>& sprites) {
+    std::string fullPath = ofToDataPath(path, true);
+    std::string tempPath = fullPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary);
+        if (!out) {
+            ofLogError("SceneLoader") << "saveSceneBinary(): could not open " << path;
+            return false;
+        }
+        if (!writeSceneBinary(out, header, sprites)) {
+            ofLogError("SceneLoader") << "saveSceneBinary(): could not write " << path;
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    std::remove(fullPath.c_str());
+    return std::rename(tempPath.c_str(), fullPath.c_str()) == 0;
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ 장면(메쉬, 텍스쳐, 셰이더, 변환 노드, 스프라이트, 카메라)을 코드 대신 파일로 기술하기 위한 장면 파일 형식과 로더.
+
+ 텍스트 형식 (.scene) - 한 줄에 항목 하나, # 뒤는 주석. 이름으로 다른 항목을 참조하므로 참조할 항목이 먼저 나와야 함.
+   camera  <x> <y> <z> <rotation> <left> <right> <bottom> <top> <near> <far>      (위치, 회전은 CameraData, 나머지는 직교투영)
+   shader  <name> <vert> <frag> [<oit frag>]                                        (oit frag 는 OIT 모드에서 대신 사용할 프래그먼트 셰이더)
+   texture <name> <file> [<frame w> <frame h> <columns> <frame count>]              (스프라이트시트면 프레임 크기(uv 기준)와 개수)
+   mesh    <name> <half width> <half height> <x> <y> <z>                            (buildMesh() 의 인자와 같음)
+   node    <name> <parent|-> <tx> <ty> <tz> [<rotation> [<sx> <sy> [<sz>]]]         (스프라이트를 묶는 변환 노드)
+   sprite  <name|-> <parent|-> <mesh> <shader> <texture> <frame> <opaque|transparent> <tx> <ty> <tz> [<rotation> [<sx> <sy> [<sz>]]]
+
+ sprite 를 제외한 항목들을 '헤더' 라고 부르고, 헤더는 모두 첫 번째 sprite 보다 앞에 있어야 함.
+ 스프라이트는 수가 많을 수 있으므로, 헤더만 먼저 읽고 스프라이트는 워커 스레드에서 일정 개수씩 묶음(chunk)으로 읽어서 넘겨줌.
+ 그래서 스프라이트가 백만 개인 장면도 전부 읽기 전에 먼저 읽은 부분부터 그리기 시작할 수 있음.
+
+ 바이너리 형식 (.scnb, 리틀 엔디언) - 텍스트 형식과 내용은 같고, 이름 대신 인덱스로 참조함. (없으면 -1)
+   char[4]  "SCN1"
+   청크 반복: uint32 종류, uint32 항목 수, uint32 바이트 수, 항목들
+     1 camera   float * 10
+     2 shader   str name, str vert, str frag, str oit frag
+     3 texture  str name, str file, float frame w, frame h, int32 columns, frame count
+     4 mesh     str name, float half width, half height, x, y, z
+     5 node     str name, int32 parent, float tx, ty, tz, rotation, sx, sy, sz
+     6 sprite   str name, int32 parent, mesh, shader, texture, frame, pass, float tx, ty, tz, rotation, sx, sy, sz
+   str 는 uint16 길이 + 문자들. 스프라이트 청크는 최대 SceneLoader::BINARY_SPRITES_PER_CHUNK 개씩 나눠서 저장함.
+ */
+
+struct SceneCamera {
+    glm::vec3 position = glm::vec3(0, 0, 0);
+    float rotation = 0.0f;
+    float left = -1.33f, right = 1.33f, bottom = -1.0f, top = 1.0f, nearClip = 0.0f, farClip = 10.0f; // glm::ortho() 인자
+
+    bool operator==(const SceneCamera& o) const;
+    bool operator!=(const SceneCamera& o) const { return !(*this == o); }
+};
+
+struct SceneShaderDesc {
+    std::string name, vert, frag, oitFrag; // oitFrag 는 비어있을 수 있음
+
+    bool operator==(const SceneShaderDesc& o) const { return name == o.name && vert == o.vert && frag == o.frag && oitFrag == o.oitFrag; }
+};
+
+struct SceneTextureDesc {
+    std::string name, file;
+    glm::vec2 frameSize = glm::vec2(1, 1);
+    int columns = 1;
+    int frameCount = 1;
+
+    bool operator==(const SceneTextureDesc& o) const;
+};
+
+struct SceneMeshDesc {
+    std::string name;
+    float halfWidth = 0.5f, halfHeight = 0.5f;
+    glm::vec3 offset = glm::vec3(0, 0, 0);
+
+    bool operator==(const SceneMeshDesc& o) const { return name == o.name && halfWidth == o.halfWidth && halfHeight == o.halfHeight && offset == o.offset; }
+};
+
+struct SceneTransform {
+    glm::vec3 position = glm::vec3(0, 0, 0);
+    float rotation = 0.0f;
+    glm::vec3 scale = glm::vec3(1, 1, 1);
+
+    bool operator==(const SceneTransform& o) const { return position == o.position && rotation == o.rotation && scale == o.scale; }
+    bool operator!=(const SceneTransform& o) const { return !(*this == o); }
+};
+
+struct SceneNodeDesc {
+    std::string name;
+    int parent = -1; // nodes 인덱스
+    SceneTransform transform;
+};
+
+struct SceneSpriteDesc {
+    std::string name; // 코드에서 찾아야 하는 스프라이트만 이름을 붙임 (없으면 빈 문자열)
+    int parent = -1; // nodes 인덱스
+    int mesh = 0, shader = 0, texture = 0; // 각 목록의 인덱스
+    int frame = 0; // 텍스쳐 안에서의 프레임 번호 (스프라이트시트가 아니면 0)
+    int pass = 0; // SpritePass
+    SceneTransform transform;
+
+    // 변환값을 뺀 나머지가 같은지 (변환값만 바뀌었으면 노드만 갱신하면 됨)
+    bool sameBinding(const SceneSpriteDesc& o) const { return name == o.name && parent == o.parent && mesh == o.mesh && shader == o.shader && texture == o.texture && frame == o.frame && pass == o.pass; }
+};
+
+// 스프라이트를 제외한 장면 정보
+struct SceneHeader {
+    SceneCamera camera;
+    std::vector<SceneShaderDesc> shaders;
+    std::vector<SceneTextureDesc> textures;
+    std::vector<SceneMeshDesc> meshes;
+    std::vector<SceneNodeDesc> nodes;
+
+    // 이름으로 인덱스를 찾음. 없으면 -1
+    int findShader(const std::string& name) const;
+    int findTexture(const std::string& name) const;
+    int findMesh(const std::string& name) const;
+    int findNode(const std::string& name) const;
+};
+
+// 워커 스레드가 읽어서 넘겨주는 스프라이트 묶음
+struct SceneChunk {
+    size_t first; // 장면 전체에서 첫 번째 스프라이트의 인덱스
+    std::vector<SceneSpriteDesc> sprites;
+};
+
+// 장면 파일을 끝까지 읽는 데 걸린 시간 (파싱 속도 측정용)
+struct SceneLoadStats {
+    uint64_t bytes = 0;
+    uint64_t entities = 0; // 헤더 항목 + 스프라이트 수
+    double seconds = 0.0;
+
+    double getMegabytesPerSecond() const { return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0; }
+    double getEntitiesPerSecond() const { return seconds > 0.0 ? entities / seconds : 0.0; }
+};
+
+class SceneLoader {
+    public:
+        static const size_t DEFAULT_CHUNK_SIZE = 16384; // 워커 스레드가 한 번에 넘겨주는 스프라이트 수
+        static const size_t MAX_QUEUED_CHUNKS = 16; // 메인 스레드가 가져가지 않은 묶음이 이만큼 쌓이면 워커 스레드가 기다림
+        static const uint32_t BINARY_SPRITES_PER_CHUNK = 65536; // 바이너리 형식의 스프라이트 청크 하나에 저장하는 최대 수
+
+        ~SceneLoader() { close(); }
+
+        /**
+         장면 파일을 열고 헤더를 읽음. (경로는 ofToDataPath() 기준, 파일 앞부분의 "SCN1" 로 바이너리 형식을 구분함)
+         실패하면 false 를 리턴하고, 잘못된 줄이나 참조는 로그를 남기고 건너뜀.
+         */
+        bool open(const std::string& path, SceneHeader& header);
+
+        // 워커 스레드에서 나머지 스프라이트를 읽기 시작함.
+        void start(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+        // 읽어둔 스프라이트 묶음이 있으면 하나 꺼내서 true
+        bool poll(SceneChunk& chunk);
+
+        // 워커 스레드가 파일을 끝까지 읽었고, 꺼내가지 않은 묶음도 없으면 true
+        bool isFinished();
+
+        // 바이너리 파일이 잘렸거나 청크가 깨져서 끝까지 읽지 못했으면 true. (잘못된 스프라이트를 건너뛴 것은 오류가 아님)
+        // 파일 끝과 구분하기 위한 것으로, 캐시 파일이 깨졌으면 호출하는 쪽에서 캐시를 지우고 텍스트 파일을 대신 읽을 수 있음.
+        bool hasError() const { return failed; }
+
+        bool isBinary() const { return binary; }
+        const std::string& getPath() const { return path; }
+        SceneLoadStats getStats();
+
+        // 워커 스레드를 멈추고 파일을 닫음.
+        void close();
+
+        // 헤더와 스프라이트를 현재 스레드에서 한꺼번에 읽음. (핫 리로드, 형식 변환에 사용) 파일이 깨졌으면 (hasError()) false
+        static bool load(const std::string& path, SceneHeader& header, std::vector<SceneSpriteDesc>& sprites, SceneLoadStats* stats = nullptr);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        bool openText(SceneHeader& header);
+        bool openBinary(SceneHeader& header);
+
+        // 스프라이트를 최대 count 개 읽어서 out 에 추가함. 파일 끝이거나 파일이 깨졌으면 (failed 를 설정함) false
+        bool readSprites(std::vector<SceneSpriteDesc>& out, size_t count);
+        bool readTextSprites(std::vector<SceneSpriteDesc>& out, size_t count);
+        bool readBinarySprites(std::vector<SceneSpriteDesc>& out, size_t count);
+
+        // 스프라이트가 참조하는 노드, 메쉬, 셰이더, 텍스쳐, 패스가 헤더 범위 안에 있는지 확인하고, 프레임 번호를 [0, 프레임 수) 로 자름.
+        bool checkSprite(SceneSpriteDesc& sprite) const;
+
+        void run(size_t chunkSize);
+
+        std::string path;
+        std::ifstream file;
+        bool binary = false;
+        int lineNumber = 0;
+        std::string pendingLine; // 텍스트 형식에서 헤더를 읽다가 만난 첫 번째 sprite 줄
+        std::vector<char> chunkBuffer; // 바이너리 형식에서 읽고 있는 스프라이트 청크
+        size_t chunkOffset = 0;
+        uint32_t chunkRemaining = 0; // 현재 청크에서 아직 읽지 않은 스프라이트 수
+        std::atomic<bool> failed{false}; // 워커 스레드에서 설정하고 메인 스레드에서 hasError() 로 확인함
+
+        // 텍스트 형식의 이름 -> 인덱스 (헤더를 읽을 때 만듦)
+        std::unordered_map<std::string, int> shaderNames, textureNames, meshNames, nodeNames;
+        size_t headerEntities = 0;
+        int numShaders = 0, numMeshes = 0, numNodes = 0; // 헤더 항목 수 (checkSprite() 에서 사용)
+        std::vector<int> textureFrameCounts; // 헤더의 텍스쳐마다 프레임 수
+        size_t spritesRead = 0;
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+        std::mutex mutex;
+        std::condition_variable space; // 큐에 자리가 났을 때 워커 스레드를 깨움
+        std::deque<SceneChunk> chunks;
+        bool done = false;
+        Clock::time_point startTime;
+        SceneLoadStats stats;
+};
+
+// 장면을 텍스트 / 바이너리 형식으로 저장함. (경로는 ofToDataPath() 기준)
+// 바이너리 형식은 캐시로 쓰이므로 임시 파일에 쓴 뒤 이름을 바꿔서, 쓰는 도중에 종료돼도 깨진 캐시 파일이 남지 않도록 함.
+bool saveSceneText(const std::string& path, const SceneHeader& header, const std::vector<SceneSpriteDesc>& sprites);
+bool saveSceneBinary(const std::string& path, const SceneHeader& header, const std::vector<SceneSpriteDesc>& sprites);
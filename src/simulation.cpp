@@ -0,0 +1,267 @@
+#include "simulation.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+static const double WALK_FPS = 12.0;
+static const double WALK_SPEED = 0.5; // 초당 이동 거리 (예전 update() 와 같음)
+static const double CLOUD_SPEED = 1.0; // 초당 회전 각도 (라디안)
+
+//--------------------------------------------------------------
+int SimState::getWalkFrame(int frameCount) const {
+    if (frameCount < 1) {
+        return 0;
+    }
+    return std::min((int)std::fmod(walkClock * WALK_FPS, (double)frameCount), frameCount - 1);
+}
+
+void stepSimulation(SimState& state, const SimInput& input, double dt) {
+    if (input.walkRight) {
+        state.charPos.x += (float)(WALK_SPEED * dt);
+    }
+    state.walkClock += dt;
+    state.cloudRotation = (float)std::fmod(state.cloudRotation + CLOUD_SPEED * dt, (double)TWO_PI);
+    state.tick++;
+}
+
+SimState interpolate(const SimState& a, const SimState& b, float alpha) {
+    SimState out = b;
+    out.charPos = a.charPos + (b.charPos - a.charPos) * alpha;
+    out.walkClock = a.walkClock + (b.walkClock - a.walkClock) * alpha;
+
+    float delta = b.cloudRotation - a.cloudRotation;
+    if (delta > PI) {
+        delta -= TWO_PI;
+    } else if (delta < -PI) {
+        delta += TWO_PI;
+    }
+    out.cloudRotation = a.cloudRotation + delta * alpha;
+    return out;
+}
+
+//--------------------------------------------------------------
+void Simulation::start(double tickRate, const SimState& initial) {
+    stop();
+    tickSeconds = 1.0 / tickRate;
+    initialState = initial;
+    state = initial;
+    appliedInput = SimInput();
+    inputLog.clear();
+    jitterSum = jitterMax = 0.0;
+    lateTicks = 0;
+    latencySum = latencyMax = 0.0;
+    latencySamples = 0;
+
+    // 시뮬레이션 스레드가 첫 틱을 publish() 하기 전에도 sample() 이 초기 상태를 리턴하도록 채워둠.
+    for (int i = 0; i < 2; ++i) {
+        frames.getWriteBuffer().previous = initial;
+        frames.getWriteBuffer().current = initial;
+        frames.getWriteBuffer().publishTime = 0.0;
+        frames.publish();
+        frames.update();
+    }
+
+    startTime = Clock::now();
+    running = true;
+    thread = std::thread(&Simulation::run, this);
+}
+
+void Simulation::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void Simulation::setInput(const SimInput& input) {
+    std::lock_guard<std::mutex> lock(inputMutex);
+    pendingInput = input;
+}
+
+void Simulation::run() {
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(tickSeconds));
+    Clock::time_point next = startTime;
+    FrameProfiler::get().setThreadName("simulation");
+
+    while (running) {
+        next += tickDuration;
+        std::this_thread::sleep_until(next);
+
+        Clock::time_point now = Clock::now();
+        double jitter = std::chrono::duration<double, std::micro>(now - next).count();
+        jitterSum += jitter;
+        jitterMax = std::max(jitterMax, jitter);
+        lateTicks += jitter > LATE_TICK_MICROS ? 1 : 0;
+
+        PROFILE_SCOPE("simulation tick");
+        SimInput input;
+        {
+            std::lock_guard<std::mutex> lock(inputMutex);
+            input = pendingInput;
+        }
+        if (input != appliedInput) {
+            inputLog.push_back({ state.tick, input });
+            appliedInput = input;
+        }
+
+        Frame& frame = frames.getWriteBuffer();
+        frame.previous = state;
+        stepSimulation(state, appliedInput, tickSeconds);
+        frame.current = state;
+        frame.publishTime = std::chrono::duration<double>(Clock::now() - startTime).count();
+        frames.publish();
+
+        // 창을 드래그하는 등으로 스레드가 오래 멈췄다가 돌아오면, 밀린 틱을 한꺼번에 따라잡지 않고 지금부터 다시 시작함.
+        // (보간은 틱을 publish() 한 시각을 기준으로 하고, 시뮬레이션 결과는 틱 수로만 정해지므로 replay() 에도 영향이 없음)
+        if (now - next > tickDuration * 15) {
+            next = now;
+        }
+    }
+}
+
+SimState Simulation::sample() {
+    frames.update();
+    const Frame& frame = frames.getReadBuffer();
+
+    // 최신 틱을 publish() 한 뒤로 지난 시간만큼 직전 틱 -> 최신 틱 사이를 보간함. (한 틱 이상 지났으면 최신 틱에 멈춤)
+    double now = std::chrono::duration<double>(Clock::now() - startTime).count();
+    float alpha = (float)ofClamp((now - frame.publishTime) / tickSeconds, 0.0, 1.0);
+    if (frame.current.tick == frame.previous.tick) {
+        alpha = 1.0f;
+    }
+    SimState out = interpolate(frame.previous, frame.current, alpha);
+
+    // 화면에 보이는 상태가 '가장 최신 상태' 였던 시각부터 지난 시간. 시뮬레이션이 제때 돌면 한 틱 정도가 나옴.
+    double latency = (now - frame.publishTime + (1.0f - alpha) * tickSeconds) * 1000000.0;
+    latencySum += latency;
+    latencyMax = std::max(latencyMax, latency);
+    latencySamples++;
+    return out;
+}
+
+SimTimingStats Simulation::getTimingStats() const {
+    SimTimingStats stats;
+    stats.ticks = state.tick - initialState.tick;
+    stats.meanJitterMicros = stats.ticks ? jitterSum / stats.ticks : 0.0;
+    stats.maxJitterMicros = jitterMax;
+    stats.lateTicks = lateTicks;
+    stats.samples = latencySamples;
+    stats.meanLatencyMicros = latencySamples ? latencySum / latencySamples : 0.0;
+    stats.maxLatencyMicros = latencyMax;
+    return stats;
+}
+
+//--------------------------------------------------------------
+SimState Simulation::replay(const SimState& initial, const std::vector<SimInputEvent>& log, uint64_t ticks, double tickSeconds) {
+    SimState s = initial;
+    SimInput input;
+    size_t next = 0;
+    while (s.tick < ticks) {
+        while (next < log.size() && log[next].tick == s.tick) {
+            input = log[next].input;
+            next++;
+        }
+        stepSimulation(s, input, tickSeconds);
+    }
+    return s;
+}
+
+SimRecording Simulation::getRecording() const {
+    SimRecording recording;
+    recording.tickSeconds = tickSeconds;
+    recording.initial = initialState;
+    recording.final = state;
+    recording.inputs = inputLog;
+    return recording;
+}
+
+//--------------------------------------------------------------
+bool saveSimRecording(const std::string& path, const SimRecording& recording) {
+    std::ofstream out(ofToDataPath(path));
+    if (!out) {
+        ofLogError("Simulation") << "saveSimRecording(): could not open " << path;
+        return false;
+    }
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    auto writeState = [&](const char* key, const SimState& state) {
+        out << key << " " << state.tick << " " << state.charPos.x << " " << state.charPos.y << " " << state.charPos.z
+            << " " << state.walkClock << " " << state.cloudRotation << "\n";
+    };
+    out << "tick " << recording.tickSeconds << "\n";
+    writeState("initial", recording.initial);
+    writeState("final", recording.final);
+    for (const SimInputEvent& event : recording.inputs) {
+        out << "input " << event.tick << " " << (event.input.walkRight ? 1 : 0) << "\n";
+    }
+    return (bool)out;
+}
+
+bool loadSimRecording(const std::string& path, SimRecording& recording) {
+    std::ifstream in(ofToDataPath(path));
+    if (!in) {
+        ofLogError("Simulation") << "loadSimRecording(): could not open " << path;
+        return false;
+    }
+    recording = SimRecording();
+    bool hasInitial = false, hasFinal = false;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key)) {
+            continue;
+        }
+        bool ok = true;
+        if (key == "tick") {
+            ok = (bool)(fields >> recording.tickSeconds) && recording.tickSeconds > 0.0;
+        } else if (key == "initial" || key == "final") {
+            SimState& state = key == "initial" ? recording.initial : recording.final;
+            ok = (bool)(fields >> state.tick >> state.charPos.x >> state.charPos.y >> state.charPos.z >> state.walkClock >> state.cloudRotation);
+            if (key == "initial") {
+                hasInitial = ok;
+            } else {
+                hasFinal = ok;
+            }
+        } else if (key == "input") {
+            SimInputEvent event;
+            int walkRight = 0;
+            ok = (bool)(fields >> event.tick >> walkRight);
+            event.input.walkRight = walkRight != 0;
+            recording.inputs.push_back(event);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            ofLogError("Simulation") << "loadSimRecording(): " << path << ":" << lineNumber << ": malformed line";
+            return false;
+        }
+    }
+    if (!hasInitial || !hasFinal || recording.final.tick < recording.initial.tick) {
+        ofLogError("Simulation") << "loadSimRecording(): " << path << " has no initial / final state";
+        return false;
+    }
+    return true;
+}
+
+bool verifySimRecording(const SimRecording& recording) {
+    SimState replayed = Simulation::replay(recording.initial, recording.inputs, recording.final.tick, recording.tickSeconds);
+    // == 로 비교하면 0.0 과 -0.0 을 같다고 보므로, 값의 비트를 그대로 비교함.
+    auto same = [](const void* a, const void* b, size_t size) { return memcmp(a, b, size) == 0; };
+    bool matches = replayed.tick == recording.final.tick
+        && same(&replayed.charPos, &recording.final.charPos, sizeof(replayed.charPos))
+        && same(&replayed.walkClock, &recording.final.walkClock, sizeof(replayed.walkClock))
+        && same(&replayed.cloudRotation, &recording.final.cloudRotation, sizeof(replayed.cloudRotation));
+    if (matches) {
+        ofLogNotice("Simulation") << "replay: " << recording.final.tick - recording.initial.tick << " ticks, " << recording.inputs.size() << " input changes, final state matches";
+    } else {
+        ofLogError("Simulation") << std::setprecision(std::numeric_limits<double>::max_digits10) << "replay DIVERGED after "
+            << recording.final.tick - recording.initial.tick << " ticks: charPos.x " << replayed.charPos.x << " (recorded " << recording.final.charPos.x << ")"
+            << ", walkClock " << replayed.walkClock << " (recorded " << recording.final.walkClock << ")"
+            << ", cloudRotation " << replayed.cloudRotation << " (recorded " << recording.final.cloudRotation << ")";
+    }
+    return matches;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "ofMain.h"
+#include "frameProfiler.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+/**
+ 렌더링과 분리된 고정 틱(fixed timestep) 시뮬레이션.
+
+ 이전에는 update() 에서 ofGetLastFrameTime() 으로 캐릭터를 움직이고, draw() 에서 프레임 번호를 호출마다 0.2 씩 올려서
+ 애니메이션 속도가 렌더링 속도(fps)에 따라 달라졌음.
+ 이제는 시뮬레이션 스레드가 정해진 간격(기본 60Hz)마다 stepSimulation() 을 한 번씩 호출하고,
+ 직전 틱과 최신 틱의 상태를 TripleBuffer 로 렌더 스레드에 넘겨줌.
+ 렌더 스레드는 sample() 로 현재 시각에 맞게 두 상태를 보간해서 그리므로, fps 와 상관없이 움직임이 부드럽고 속도가 일정함.
+
+ - 입력(키 상태)은 시뮬레이션 스레드가 틱을 시작할 때 가져가고, 적용한 틱 번호와 함께 기록해둠.
+   같은 초기 상태와 입력 기록으로 replay() 하면 똑같은 상태가 나옴. (결정적 재현)
+   종료할 때 초기 상태, 입력 기록, 최종 상태를 SimRecording 파일로 저장해두고, 새 프로세스에서
+   --replay 로 다시 돌려서 최종 상태가 비트 단위로 같은지 확인함. (다르면 종료 코드 1)
+ - 보간 때문에 화면에 보이는 상태는 최신 틱보다 최대 한 틱 늦음. (SimTimingStats 의 latency)
+ */
+
+// 시뮬레이션 입력. 틱 단위로 적용됨.
+struct SimInput {
+    bool walkRight = false;
+
+    bool operator==(const SimInput& o) const { return walkRight == o.walkRight; }
+    bool operator!=(const SimInput& o) const { return !(*this == o); }
+};
+
+struct SimState {
+    uint64_t tick = 0;
+    glm::vec3 charPos = glm::vec3(0, 0, 0);
+    double walkClock = 0.0; // 걷기 애니메이션 시간(초). 프레임 번호는 getWalkFrame() 으로 계산함.
+    float cloudRotation = 1.0f; // 0 ~ 2파이 범위로 유지함
+
+    // 초당 12 프레임으로 0 ~ frameCount - 1 번 프레임을 반복함. (예전 draw() 에서 60fps 기준 호출마다 0.2 씩 올리던 것과 같은 속도)
+    // frameCount 는 캐릭터 스프라이트시트의 프레임 수 (장면 파일마다 다를 수 있으므로 고정값을 쓰지 않음). 1 보다 작으면 0 을 리턴함.
+    int getWalkFrame(int frameCount) const;
+};
+
+// 상태를 dt 초만큼 진행함. 시뮬레이션 스레드와 replay() 가 같은 함수를 사용함.
+void stepSimulation(SimState& state, const SimInput& input, double dt);
+
+// 두 상태를 alpha (0 ~ 1) 비율로 보간함. 회전값은 0 ~ 2파이 경계를 넘어갈 때 짧은 쪽으로 보간함.
+SimState interpolate(const SimState& a, const SimState& b, float alpha);
+
+struct SimInputEvent {
+    uint64_t tick; // 이 틱을 진행하기 직전에 적용됨
+    SimInput input;
+};
+
+struct SimTimingStats {
+    uint64_t ticks = 0;
+    double meanJitterMicros = 0.0; // 틱이 예정된 시각보다 늦게 시작한 시간
+    double maxJitterMicros = 0.0;
+    uint64_t lateTicks = 0; // LATE_TICK_MICROS 보다 늦게 시작한 틱 수
+    uint64_t samples = 0;
+    double meanLatencyMicros = 0.0; // 화면에 보이는 (보간된) 상태가 최신 상태였던 시각부터 sample() 까지 지난 시간
+    double maxLatencyMicros = 0.0;
+};
+
+/**
+ 쓰기 스레드 하나, 읽기 스레드 하나가 락 없이 값을 주고받는 트리플 버퍼.
+
+ 버퍼 3개 중 하나는 쓰는 쪽, 하나는 읽는 쪽이 가지고 있고, 나머지 하나를 atomic 으로 서로 맞바꿈.
+ 쓰는 쪽은 읽는 쪽을 기다리지 않고 계속 최신 값을 publish() 할 수 있고,
+ 읽는 쪽은 update() 로 가장 최근에 publish() 된 값을 받음. (중간 값은 건너뛸 수 있음)
+ */
+template <class T>
+class TripleBuffer {
+    public:
+        T& getWriteBuffer() { return buffers[writeIndex]; }
+        void publish() { writeIndex = shared.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK; }
+
+        // 새로 publish() 된 값이 있으면 읽기 버퍼를 바꾸고 true
+        bool update() {
+            if (!(shared.load(std::memory_order_relaxed) & FRESH)) {
+                return false;
+            }
+            readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+            return true;
+        }
+        const T& getReadBuffer() const { return buffers[readIndex]; }
+
+    private:
+        static const int INDEX_MASK = 3;
+        static const int FRESH = 4; // 가운데 버퍼에 아직 읽지 않은 값이 있음
+
+        T buffers[3];
+        int writeIndex = 0;
+        int readIndex = 1;
+        std::atomic<int> shared{2};
+};
+
+// 시뮬레이션 한 번의 재현 기록. 같은 initial, inputs 로 replay() 해서 final 과 같은 상태가 나와야 함.
+struct SimRecording {
+    double tickSeconds = 1.0 / 60.0;
+    SimState initial;
+    SimState final;
+    std::vector<SimInputEvent> inputs;
+};
+
+/**
+ 텍스트 파일로 저장하고 읽음. (경로는 ofToDataPath() 기준) float, double 은 다시 읽었을 때 비트까지 같도록 유효 자릿수를 모두 적음.
+
+   tick <틱 간격(초)>
+   initial <틱 번호> <charPos x y z> <walkClock> <cloudRotation>
+   final   <틱 번호> <charPos x y z> <walkClock> <cloudRotation>
+   input   <틱 번호> <walkRight 0 / 1>        (입력이 바뀔 때마다 한 줄)
+ */
+bool saveSimRecording(const std::string& path, const SimRecording& recording);
+bool loadSimRecording(const std::string& path, SimRecording& recording);
+
+// 기록을 replay() 해서 최종 상태가 비트 단위로 같으면 true. 결과는 로그로 출력함.
+bool verifySimRecording(const SimRecording& recording);
+
+class Simulation {
+    public:
+        static constexpr double LATE_TICK_MICROS = 1000.0;
+
+        ~Simulation() { stop(); }
+
+        void start(double tickRate = 60.0, const SimState& initial = SimState());
+        void stop();
+
+        // 메인 스레드에서 입력 상태를 바꿈. 다음 틱부터 적용됨.
+        void setInput(const SimInput& input);
+
+        // 현재 시각에 맞게 직전 틱과 최신 틱의 상태를 보간해서 리턴함. (렌더 스레드 하나에서만 호출)
+        SimState sample();
+
+        double getTickSeconds() const { return tickSeconds; }
+
+        // 아래 값들은 stop() 한 뒤에 읽어야 함.
+        const SimState& getInitialState() const { return initialState; }
+        const SimState& getFinalState() const { return state; }
+        const std::vector<SimInputEvent>& getInputLog() const { return inputLog; }
+        SimTimingStats getTimingStats() const;
+        SimRecording getRecording() const;
+
+        // initial 상태에서 입력 기록을 적용하면서 ticks 번째 틱까지 진행한 상태를 리턴함.
+        static SimState replay(const SimState& initial, const std::vector<SimInputEvent>& log, uint64_t ticks, double tickSeconds);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Frame {
+            SimState previous;
+            SimState current;
+            double publishTime; // start() 부터 current 를 publish() 한 시각까지의 시간(초)
+        };
+
+        void run();
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+        Clock::time_point startTime;
+        double tickSeconds = 1.0 / 60.0;
+
+        // 시뮬레이션 스레드 전용
+        SimState initialState;
+        SimState state;
+        SimInput appliedInput;
+        std::vector<SimInputEvent> inputLog;
+        double jitterSum = 0.0;
+        double jitterMax = 0.0;
+        uint64_t lateTicks = 0;
+
+        // 렌더 스레드 전용
+        double latencySum = 0.0;
+        double latencyMax = 0.0;
+        uint64_t latencySamples = 0;
+
+        std::mutex inputMutex; // 입력은 드물게 바뀌므로 간단히 뮤텍스로 넘김. (매 틱 주고받는 상태는 TripleBuffer)
+        SimInput pendingInput;
+
+        TripleBuffer<Frame> frames;
+};
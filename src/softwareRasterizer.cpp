@@ -0,0 +1,398 @@
+#include "softwareRasterizer.h"
+#include <thread>
+
+//--------------------------------------------------------------
+void SoftwareRasterizer::setup(int w, int h, int threads) {
+    width = w;
+    height = h;
+    numThreads = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    colorBuffer.assign(width * height, glm::vec4(0, 0, 0, 0));
+    depthBuffer.assign(width * height, 1.0f);
+    tileBins.assign(tilesX * tilesY, std::vector<uint32_t>());
+    pixels.allocate(width, height, OF_PIXELS_RGBA);
+    pixelsDirty = true;
+}
+
+//--------------------------------------------------------------
+int SoftwareRasterizer::addProgram(RasterFragmentMode fragMode) {
+    Program program;
+    program.fragMode = fragMode;
+    programs.push_back(program);
+    return (int)programs.size() - 1;
+}
+
+int SoftwareRasterizer::addTexture(const ofPixels& pixels) {
+    return addTexture(std::vector<ofPixels>{ pixels });
+}
+
+int SoftwareRasterizer::addTexture(const std::vector<ofPixels>& levels) {
+    // RGB (배경 텍스쳐처럼 알파채널이 없는 이미지) 도 샘플링할 때 분기하지 않도록 미리 RGBA float 로 바꿔둠.
+    Texture tex;
+    for (const ofPixels& src : levels) {
+        TextureLevel level;
+        level.width = (int)src.getWidth();
+        level.height = (int)src.getHeight();
+        level.rgba.resize(level.width * level.height * 4);
+
+        size_t channels = src.getNumChannels();
+        const unsigned char* data = src.getData();
+        for (int i = 0; i < level.width * level.height; ++i) {
+            const unsigned char* p = data + i * channels;
+            float* dst = &level.rgba[i * 4];
+            if (channels >= 3) {
+                dst[0] = p[0] / 255.0f;
+                dst[1] = p[1] / 255.0f;
+                dst[2] = p[2] / 255.0f;
+            } else {
+                dst[0] = dst[1] = dst[2] = p[0] / 255.0f;
+            }
+            dst[3] = (channels == 4 || channels == 2) ? p[channels - 1] / 255.0f : 1.0f;
+        }
+        tex.levels.push_back(std::move(level));
+    }
+
+    textures.push_back(std::move(tex));
+    return (int)textures.size() - 1;
+}
+
+int SoftwareRasterizer::addMesh(const ofMesh& mesh) {
+    Mesh m;
+    m.positions = mesh.getVertices();
+    m.texCoords = mesh.getTexCoords();
+    m.indices = mesh.getIndices();
+    meshes.push_back(std::move(m));
+    return (int)meshes.size() - 1;
+}
+
+//--------------------------------------------------------------
+void SoftwareRasterizer::draw(const SpriteBatch& batch, const glm::mat4& view, const glm::mat4& proj) {
+    std::fill(colorBuffer.begin(), colorBuffer.end(), glm::vec4(clearColor.r, clearColor.g, clearColor.b, clearColor.a));
+    std::fill(depthBuffer.begin(), depthBuffer.end(), 1.0f);
+    pixelsDirty = true;
+
+    setupTriangles(batch, proj * view);
+    binTriangles();
+
+    // 스레드들이 아직 아무도 안 가져간 타일을 하나씩 가져가서 그림. (타일끼리는 픽셀이 겹치지 않으므로 동기화가 필요 없음)
+    // 스레드는 프레임마다 만들지 않고 pool 의 스레드를 계속 사용함.
+    pool.parallelFor((size_t)(tilesX * tilesY), numThreads, [&](size_t tile) {
+        rasterizeTile((int)tile);
+    });
+}
+
+//--------------------------------------------------------------
+/**
+ 버텍스 셰이더 단계.
+
+ 인스턴스마다 메쉬 버텍스들을 proj * view * model 로 변환한 뒤,
+ NDC 좌표를 뷰포트(픽셀) 좌표로 바꾸고 uv 좌표도 셰이더와 같은 방식으로 계산해서 삼각형 목록을 만듦.
+ */
+void SoftwareRasterizer::setupTriangles(const SpriteBatch& batch, const glm::mat4& viewProj) {
+    triangles.clear();
+    const std::vector<float>& data = batch.getInstanceData();
+
+    std::vector<glm::vec3> screen;
+    std::vector<glm::vec2> uvs;
+
+    for (const SpriteDrawGroup& group : batch.getGroups()) {
+        const Program& program = programs[group.shader];
+        const Mesh& mesh = meshes[group.mesh];
+
+        for (size_t inst = group.first; inst < group.first + group.count; ++inst) {
+            const float* src = &data[inst * SpriteBatch::FLOATS_PER_INSTANCE];
+            glm::mat4 model;
+            for (int col = 0; col < 4; ++col) {
+                const float* c = src + SpriteBatch::MODEL_OFFSET + col * 4;
+                model[col] = glm::vec4(c[0], c[1], c[2], c[3]);
+            }
+            glm::vec2 rectOrigin(src[SpriteBatch::RECT_OFFSET + 0], src[SpriteBatch::RECT_OFFSET + 1]);
+            glm::vec2 rectSize(src[SpriteBatch::RECT_OFFSET + 2], src[SpriteBatch::RECT_OFFSET + 3]);
+            glm::mat4 mvp = viewProj * model;
+
+            screen.resize(mesh.positions.size());
+            uvs.resize(mesh.positions.size());
+            for (size_t v = 0; v < mesh.positions.size(); ++v) {
+                glm::vec4 clip = mvp * glm::vec4(mesh.positions[v], 1.0f);
+                glm::vec3 ndc(clip.x / clip.w, clip.y / clip.w, clip.z / clip.w);
+                // 뷰포트 변환. 이미지는 첫 번째 행이 화면 맨 위이므로 y 는 뒤집어줌.
+                screen[v] = glm::vec3((ndc.x * 0.5f + 0.5f) * width, (0.5f - ndc.y * 0.5f) * height, ndc.z * 0.5f + 0.5f);
+
+                glm::vec2 uv = v < mesh.texCoords.size() ? mesh.texCoords[v] : glm::vec2(0, 0);
+                uvs[v] = rectOrigin + glm::vec2(uv.x, 1.0f - uv.y) * rectSize;
+            }
+
+            for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+                Triangle tri;
+                int idx[3] = { (int)mesh.indices[i], (int)mesh.indices[i + 1], (int)mesh.indices[i + 2] };
+
+                // 2배 넓이가 양수가 되도록 버텍스 순서를 맞춤. (GL 기본값처럼 뒷면 컬링은 하지 않음)
+                glm::vec3 a = screen[idx[0]], b = screen[idx[1]], c = screen[idx[2]];
+                float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+                if (area == 0.0f) {
+                    continue;
+                }
+                if (area < 0.0f) {
+                    std::swap(idx[1], idx[2]);
+                    area = -area;
+                }
+
+                for (int k = 0; k < 3; ++k) {
+                    tri.screen[k] = screen[idx[k]];
+                    tri.uv[k] = uvs[idx[k]];
+                }
+                tri.area = area;
+
+                // uv = (w0 * uv0 + w1 * uv1 + w2 * uv2) / area 이고 엣지 함수 w 는 x, y 에 대해 선형이므로 미분값이 삼각형 안에서 일정함. (rasterizeTile() 의 엣지 함수 참고)
+                const glm::vec3& s0 = tri.screen[0];
+                const glm::vec3& s1 = tri.screen[1];
+                const glm::vec3& s2 = tri.screen[2];
+                tri.uvDx = (tri.uv[0] * (s1.y - s2.y) + tri.uv[1] * (s2.y - s0.y) + tri.uv[2] * (s0.y - s1.y)) * (1.0f / area);
+                tri.uvDy = (tri.uv[0] * (s2.x - s1.x) + tri.uv[1] * (s0.x - s2.x) + tri.uv[2] * (s1.x - s0.x)) * (1.0f / area);
+                tri.texture = group.texture;
+                tri.fragMode = program.fragMode;
+                tri.pass = group.pass;
+
+                float minX = std::min(tri.screen[0].x, std::min(tri.screen[1].x, tri.screen[2].x));
+                float maxX = std::max(tri.screen[0].x, std::max(tri.screen[1].x, tri.screen[2].x));
+                float minY = std::min(tri.screen[0].y, std::min(tri.screen[1].y, tri.screen[2].y));
+                float maxY = std::max(tri.screen[0].y, std::max(tri.screen[1].y, tri.screen[2].y));
+                tri.minX = std::max(0, (int)std::floor(minX));
+                tri.minY = std::max(0, (int)std::floor(minY));
+                tri.maxX = std::min(width - 1, (int)std::ceil(maxX));
+                tri.maxY = std::min(height - 1, (int)std::ceil(maxY));
+                if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+                    continue; // 화면 밖의 삼각형
+                }
+                triangles.push_back(tri);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------
+void SoftwareRasterizer::binTriangles() {
+    for (std::vector<uint32_t>& bin : tileBins) {
+        bin.clear();
+    }
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const Triangle& tri = triangles[i];
+        int tx0 = tri.minX / TILE_SIZE, tx1 = tri.maxX / TILE_SIZE;
+        int ty0 = tri.minY / TILE_SIZE, ty1 = tri.maxY / TILE_SIZE;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                tileBins[ty * tilesX + tx].push_back((uint32_t)i);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------
+// 엣지 함수. p 가 a -> b 엣지의 어느 쪽에 있는지와 그 거리(에 비례하는 값)를 리턴함.
+static inline float edgeFunction(const glm::vec3& a, const glm::vec3& b, float px, float py) {
+    return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+}
+
+/**
+ 두 삼각형이 공유하는 엣지 위에 정확히 놓인 픽셀이 두 번 그려지지 않도록 하는 규칙 (GL 의 top-left rule 과 같은 목적).
+ 공유하는 엣지는 두 삼각형에서 서로 반대 방향이므로, 아래 조건은 둘 중 한 쪽에서만 참이 됨.
+ */
+static inline bool ownsEdge(const glm::vec3& a, const glm::vec3& b) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    return dy > 0.0f || (dy == 0.0f && dx < 0.0f);
+}
+
+void SoftwareRasterizer::rasterizeTile(int tile) {
+    int tileX0 = (tile % tilesX) * TILE_SIZE;
+    int tileY0 = (tile / tilesX) * TILE_SIZE;
+    int tileX1 = std::min(tileX0 + TILE_SIZE, width) - 1;
+    int tileY1 = std::min(tileY0 + TILE_SIZE, height) - 1;
+
+    for (uint32_t triIndex : tileBins[tile]) {
+        const Triangle& tri = triangles[triIndex];
+        const Texture& tex = textures[tri.texture];
+        const glm::vec3& v0 = tri.screen[0];
+        const glm::vec3& v1 = tri.screen[1];
+        const glm::vec3& v2 = tri.screen[2];
+        bool own0 = ownsEdge(v1, v2), own1 = ownsEdge(v2, v0), own2 = ownsEdge(v0, v1);
+        float invArea = 1.0f / tri.area;
+        bool depthTest = tri.pass == SPRITE_PASS_OPAQUE;
+        float lod = computeLod(tex, tri);
+
+        int x0 = std::max(tri.minX, tileX0), x1 = std::min(tri.maxX, tileX1);
+        int y0 = std::max(tri.minY, tileY0), y1 = std::min(tri.maxY, tileY1);
+
+        for (int y = y0; y <= y1; ++y) {
+            float py = y + 0.5f; // 픽셀 중심
+            for (int x = x0; x <= x1; ++x) {
+                float px = x + 0.5f;
+                float w0 = edgeFunction(v1, v2, px, py);
+                float w1 = edgeFunction(v2, v0, px, py);
+                float w2 = edgeFunction(v0, v1, px, py);
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                if ((w0 == 0.0f && !own0) || (w1 == 0.0f && !own1) || (w2 == 0.0f && !own2)) continue;
+
+                float b0 = w0 * invArea, b1 = w1 * invArea, b2 = w2 * invArea;
+                float z = b0 * v0.z + b1 * v1.z + b2 * v2.z;
+                if (z < 0.0f || z > 1.0f) continue; // 프러스텀의 near, far 범위를 벗어난 프래그먼트는 클리핑됨.
+
+                int idx = y * width + x;
+                if (depthTest && z >= depthBuffer[idx]) continue; // GL_LESS 깊이테스트
+
+                glm::vec2 uv = tri.uv[0] * b0 + tri.uv[1] * b1 + tri.uv[2] * b2;
+                glm::vec4 col = sample(tex, uv, lod);
+
+                if (tri.fragMode == RASTER_FRAG_ALPHA_TEST) {
+                    if (col.w < 0.7f) continue; // alphaTest.frag 의 discard. 버려진 프래그먼트는 깊이값도 기록하지 않음.
+                } else {
+                    col.w = std::min(col.w, 0.8f); // cloud.frag 의 min(outCol.a, 0.8)
+                }
+
+                if (depthTest) {
+                    colorBuffer[idx] = col;
+                    depthBuffer[idx] = z; // 깊이테스트가 꺼져 있으면 깊이버퍼에도 기록하지 않음. (GL 과 동일)
+                } else {
+                    // OF_BLENDMODE_ALPHA: glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) 를 알파채널까지 똑같이 적용함.
+                    glm::vec4& dst = colorBuffer[idx];
+                    dst = col * col.w + dst * (1.0f - col.w);
+                }
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------
+/**
+ GL 명세의 LOD 계산과 같음. 화면 한 픽셀당 0 번 레벨의 텍셀이 몇 개 지나가는지(rho)를 구해서 log2(rho) 를 리턴함.
+ 0 이하면 텍스쳐가 확대되어 그려지는 것이므로 GL_LINEAR 로 0 번 레벨만 샘플링함.
+ */
+float SoftwareRasterizer::computeLod(const Texture& tex, const Triangle& tri) const {
+    const TextureLevel& base = tex.levels[0];
+    glm::vec2 size((float)base.width, (float)base.height);
+    glm::vec2 dx = tri.uvDx * size;
+    glm::vec2 dy = tri.uvDy * size;
+    float rho = std::max(std::sqrt(dx.x * dx.x + dx.y * dx.y), std::sqrt(dy.x * dy.x + dy.y * dy.y));
+    return rho > 0.0f ? std::log2(rho) : 0.0f;
+}
+
+// GL_LINEAR_MIPMAP_LINEAR: LOD 가 걸치는 두 레벨을 각각 바이리니어 샘플링해서 LOD 의 소수 부분으로 섞음. (마지막 레벨을 넘으면 마지막 레벨만)
+glm::vec4 SoftwareRasterizer::sample(const Texture& tex, glm::vec2 uv, float lod) const {
+    int maxLevel = (int)tex.levels.size() - 1;
+    if (lod <= 0.0f || maxLevel == 0) {
+        return sampleLevel(tex.levels[0], uv);
+    }
+    float d = std::min(lod, (float)maxLevel);
+    int level = (int)d;
+    float t = d - level;
+    glm::vec4 col = sampleLevel(tex.levels[level], uv);
+    if (t > 0.0f && level < maxLevel) {
+        col = col * (1.0f - t) + sampleLevel(tex.levels[level + 1], uv) * t;
+    }
+    return col;
+}
+
+// GL_LINEAR + GL_CLAMP_TO_EDGE 와 같은 바이리니어 샘플링. 텍셀 중심은 (i + 0.5) / size 위치에 있음.
+glm::vec4 SoftwareRasterizer::sampleLevel(const TextureLevel& tex, glm::vec2 uv) const {
+    float fx = uv.x * tex.width - 0.5f;
+    float fy = uv.y * tex.height - 0.5f;
+    float flx = std::floor(fx), fly = std::floor(fy);
+    float tx = fx - flx, ty = fy - fly;
+    int x0 = std::min(std::max((int)flx, 0), tex.width - 1), x1 = std::min(std::max((int)flx + 1, 0), tex.width - 1);
+    int y0 = std::min(std::max((int)fly, 0), tex.height - 1), y1 = std::min(std::max((int)fly + 1, 0), tex.height - 1);
+
+    auto texel = [&](int x, int y) {
+        const float* p = &tex.rgba[(y * tex.width + x) * 4];
+        return glm::vec4(p[0], p[1], p[2], p[3]);
+    };
+    glm::vec4 top = texel(x0, y0) * (1.0f - tx) + texel(x1, y0) * tx;
+    glm::vec4 bottom = texel(x0, y1) * (1.0f - tx) + texel(x1, y1) * tx;
+    return top * (1.0f - ty) + bottom * ty;
+}
+
+//--------------------------------------------------------------
+const ofPixels& SoftwareRasterizer::getPixels() {
+    if (pixelsDirty) {
+        unsigned char* dst = pixels.getData();
+        for (size_t i = 0; i < colorBuffer.size(); ++i) {
+            const glm::vec4& c = colorBuffer[i];
+            dst[i * 4 + 0] = (unsigned char)(ofClamp(c.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+            dst[i * 4 + 1] = (unsigned char)(ofClamp(c.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+            dst[i * 4 + 2] = (unsigned char)(ofClamp(c.z, 0.0f, 1.0f) * 255.0f + 0.5f);
+            dst[i * 4 + 3] = (unsigned char)(ofClamp(c.w, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        pixelsDirty = false;
+    }
+    return pixels;
+}
+
+//--------------------------------------------------------------
+ImageDiff compareImages(const ofPixels& image, const ofPixels& reference, int tolerance, ofPixels* diffImage) {
+    ImageDiff diff;
+    size_t w = reference.getWidth(), h = reference.getHeight();
+    diff.sameSize = image.getWidth() == w && image.getHeight() == h;
+    if (!diff.sameSize) {
+        diff.mismatched = w * h;
+        diff.maxDiff = 255;
+        return diff;
+    }
+    if (diffImage) {
+        diffImage->allocate(w, h, OF_PIXELS_RGBA);
+    }
+
+    size_t imageChannels = image.getNumChannels(), referenceChannels = reference.getNumChannels();
+    auto channel = [](const unsigned char* p, size_t channels, int c) {
+        if (c == 3) {
+            return channels == 4 ? (int)p[3] : 255;
+        }
+        return channels >= 3 ? (int)p[c] : (int)p[0];
+    };
+    for (size_t i = 0; i < w * h; ++i) {
+        const unsigned char* a = image.getData() + i * imageChannels;
+        const unsigned char* b = reference.getData() + i * referenceChannels;
+        int pixelDiff = 0;
+        for (int c = 0; c < 4; ++c) {
+            pixelDiff = std::max(pixelDiff, std::abs(channel(a, imageChannels, c) - channel(b, referenceChannels, c)));
+        }
+        diff.maxDiff = std::max(diff.maxDiff, pixelDiff);
+        bool mismatch = pixelDiff > tolerance;
+        if (mismatch) {
+            diff.mismatched++;
+        }
+        if (diffImage) {
+            unsigned char* d = diffImage->getData() + i * 4;
+            for (int c = 0; c < 3; ++c) {
+                d[c] = mismatch ? (c == 0 ? 255 : 0) : (unsigned char)(channel(b, referenceChannels, c) / 4);
+            }
+            d[3] = 255;
+        }
+    }
+    return diff;
+}
+
+/**
+ 컴파일러, CPU 에 따라 float 연산 결과가 조금씩 다를 수 있으므로 채널 값 차이 2 까지는 같은 것으로 보고,
+ 삼각형 경계에 걸친 픽셀처럼 드물게 생기는 차이를 감안해서 전체 픽셀의 0.1% 까지는 허용함.
+ */
+bool compareWithGolden(const ofPixels& image, const std::string& goldenPath, const std::string& diffPath) {
+    const int tolerance = 2;
+    const double allowedFraction = 0.001;
+    ofPixels golden, diffPixels;
+    if (!ofLoadImage(golden, goldenPath)) {
+        ofLogError("SoftwareRasterizer") << "cannot load golden image " << goldenPath;
+        return false;
+    }
+    ImageDiff diff = compareImages(image, golden, tolerance, &diffPixels);
+    size_t allowed = (size_t)(golden.getWidth() * golden.getHeight() * allowedFraction);
+    bool passed = diff.sameSize && diff.mismatched <= allowed;
+    ofLogNotice("SoftwareRasterizer") << "compare with " << goldenPath << " " << (passed ? "passed" : "FAILED") << ", "
+        << diff.mismatched << " pixels differ by more than " << tolerance << " (allowed " << allowed << "), max difference " << diff.maxDiff
+        << (diff.sameSize ? "" : ", image sizes differ");
+    if (!passed && diff.sameSize) {
+        ofSaveImage(diffPixels, diffPath);
+        ofLogNotice("SoftwareRasterizer") << "difference image -> " << diffPath;
+    }
+    return passed;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "ofMain.h"
+#include "spriteBatch.h"
+#include "workerPool.h"
+
+/**
+ GPU 없이 CPU 만으로 현재 셰이더 파이프라인을 똑같이 흉내내서 그려주는 소프트웨어 래스터라이저.
+
+ SpriteRenderer 와 똑같이 SpriteBatch 의 그룹, 인스턴스 데이터를 받아서 그리므로,
+ ofApp::draw() 에서 만든 장면을 창(GL 컨텍스트) 없이 오프스크린 이미지로 렌더링할 수 있음.
+
+ 흉내내는 파이프라인
+ - 버텍스 셰이더: gl_Position = proj * view * model * vec4(pos, 1.0)
+                 fragUV = uvRect.xy + vec2(uv.x, 1.0 - uv.y) * uvRect.zw (spriteInstanced.vert)
+ - 프래그먼트 셰이더: alphaTest.frag (알파값 0.7 미만 discard) 또는 cloud.frag (알파값을 0.8 이하로 제한)
+ - 렌더 상태: SPRITE_PASS_OPAQUE 는 깊이테스트 o, SPRITE_PASS_TRANSPARENT 는 깊이테스트 x + OF_BLENDMODE_ALPHA 블렌딩
+ - 텍스쳐: GL 경로의 아틀라스 텍스쳐와 같은 GL_LINEAR_MIPMAP_LINEAR (확대할 때는 GL_LINEAR) + GL_CLAMP_TO_EDGE
+           밉맵 레벨은 GL 에 업로드하는 것과 같은 데이터(assetLoader 가 만든 레벨들)를 받고,
+           삼각형마다 화면 픽셀당 uv 변화량으로 GL 과 같은 방식으로 LOD 를 구해서 두 레벨을 섞음.
+ - 클리어 색: setClearColor() 로 GL 경로의 배경색과 같은 색을 지정함.
+
+ 화면을 타일(TILE_SIZE * TILE_SIZE 픽셀) 단위로 나눠서 각 타일에 걸치는 삼각형 목록을 만든 뒤 (binning),
+ 여러 스레드가 타일을 하나씩 가져가서 그림. 타일 안에서는 삼각형을 submit 순서대로 그리므로
+ 블렌딩 순서와 깊이테스트 결과가 GL 과 같음.
+
+ 현재 장면은 직교투영만 사용하므로 near 평면 클리핑과 원근 보정 보간은 하지 않음.
+ 대신 클립공간 z 범위 밖의 프래그먼트는 버려서, 프러스텀을 벗어난 메쉬가 그려지지 않는 동작은 똑같이 맞춤.
+ */
+
+enum RasterFragmentMode {
+    RASTER_FRAG_ALPHA_TEST = 0, // alphaTest.frag
+    RASTER_FRAG_ALPHA_CLAMP = 1, // cloud.frag
+};
+
+class SoftwareRasterizer {
+    public:
+        static const int TILE_SIZE = 64;
+
+        // numThreads 가 0 이면 하드웨어 스레드 개수만큼 사용함.
+        void setup(int width, int height, int numThreads = 0);
+        void setClearColor(const ofFloatColor& color) { clearColor = color; }
+
+        // SpriteRenderer 의 addShader(), addTexture(), addMesh() 와 같은 순서로 등록하면 같은 id 가 나옴.
+        int addProgram(RasterFragmentMode fragMode);
+        int addTexture(const ofPixels& pixels);
+        int addTexture(const std::vector<ofPixels>& levels); // 밉맵 레벨들 (0 번 레벨부터, 레벨마다 가로 세로 절반)
+        int addMesh(const ofMesh& mesh);
+
+        // 컬러버퍼, 깊이버퍼를 지운 뒤 배치 전체를 그림.
+        void draw(const SpriteBatch& batch, const glm::mat4& view, const glm::mat4& proj);
+
+        // 마지막으로 그린 결과를 8비트 RGBA 이미지로 리턴함.
+        const ofPixels& getPixels();
+
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
+        int getNumThreads() const { return numThreads; }
+
+    private:
+        struct Program {
+            RasterFragmentMode fragMode;
+        };
+
+        struct TextureLevel {
+            int width, height;
+            std::vector<float> rgba; // 0 ~ 1 범위의 float RGBA (첫 번째 행이 v = 0)
+        };
+
+        struct Texture {
+            std::vector<TextureLevel> levels;
+        };
+
+        struct Mesh {
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec2> texCoords;
+            std::vector<ofIndexType> indices;
+        };
+
+        // 버텍스 단계를 마친, 화면 좌표계의 삼각형 하나
+        struct Triangle {
+            glm::vec3 screen[3]; // x, y 는 픽셀 좌표 (y 는 위에서 아래로), z 는 0 ~ 1 깊이값
+            glm::vec2 uv[3];
+            glm::vec2 uvDx, uvDy; // 화면에서 오른쪽, 아래로 한 픽셀 갈 때 uv 변화량 (직교투영이라 삼각형 안에서 일정함)
+            float area; // 2배 넓이 (항상 양수가 되도록 버텍스 순서를 맞춰둠)
+            int texture;
+            int fragMode;
+            int pass;
+            int minX, minY, maxX, maxY; // 화면에 걸치는 픽셀 범위
+        };
+
+        void setupTriangles(const SpriteBatch& batch, const glm::mat4& viewProj);
+        void binTriangles();
+        void rasterizeTile(int tile);
+        float computeLod(const Texture& tex, const Triangle& tri) const;
+        glm::vec4 sample(const Texture& tex, glm::vec2 uv, float lod) const;
+        glm::vec4 sampleLevel(const TextureLevel& level, glm::vec2 uv) const;
+
+        int width = 0, height = 0;
+        int numThreads = 1;
+        int tilesX = 0, tilesY = 0;
+        ofFloatColor clearColor = ofFloatColor(0, 0, 0, 1);
+
+        std::vector<Program> programs;
+        std::vector<Texture> textures;
+        std::vector<Mesh> meshes;
+
+        std::vector<Triangle> triangles;
+        std::vector<std::vector<uint32_t>> tileBins; // 타일마다 걸치는 삼각형 인덱스 목록 (submit 순서)
+
+        std::vector<glm::vec4> colorBuffer;
+        std::vector<float> depthBuffer;
+        ofPixels pixels;
+        bool pixelsDirty = true;
+
+        WorkerPool pool;
+};
+
+// 두 이미지를 픽셀 단위로 비교한 결과 (헤드리스 모드에서 렌더링 결과를 기준 이미지(golden image)와 비교할 때 사용)
+struct ImageDiff {
+    bool sameSize = false;
+    size_t mismatched = 0; // 채널 하나라도 tolerance 보다 많이 다른 픽셀 수
+    int maxDiff = 0; // 가장 많이 다른 채널의 값 차이 (0 ~ 255)
+};
+
+/**
+ RGB, RGBA 이미지를 비교함. (알파채널이 없는 쪽은 알파값을 255 로 봄)
+ diffImage 를 넘기면 tolerance 보다 많이 다른 픽셀은 빨간색, 나머지는 기준 이미지를 어둡게 한 색으로 채운 이미지를 만듦.
+ */
+ImageDiff compareImages(const ofPixels& image, const ofPixels& reference, int tolerance, ofPixels* diffImage = nullptr);
+
+/**
+ image 를 goldenPath 의 기준 이미지와 비교해서 같다고 볼 수 있으면 true. (헤드리스 모드의 --compare, --bench raster 에서 사용)
+ 다르면 어디가 다른지 볼 수 있도록 다른 픽셀을 빨갛게 표시한 이미지를 diffPath 에 저장함.
+ */
+bool compareWithGolden(const ofPixels& image, const std::string& goldenPath, const std::string& diffPath);
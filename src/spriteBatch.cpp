@@ -0,0 +1,174 @@
+#include "spriteBatch.h"
+
+//--------------------------------------------------------------
+void SpriteBatch::clear() {
+    submissions.clear();
+    instances.clear();
+    sortEntries.clear();
+    instanceData.clear();
+    groups.clear();
+    stats = SpriteBatchStats();
+}
+
+//--------------------------------------------------------------
+void SpriteBatch::submit(int pass, int shader, int texture, int mesh, const SpriteInstance& instance) {
+    Submission s;
+    s.pass = pass;
+    s.shader = shader;
+    s.texture = texture;
+    s.mesh = mesh;
+    submissions.push_back(s);
+    instances.push_back(instance);
+}
+
+void SpriteBatch::submit(int pass, int shader, int texture, int mesh, const SpriteInstance* first, size_t count) {
+    Submission s;
+    s.pass = pass;
+    s.shader = shader;
+    s.texture = texture;
+    s.mesh = mesh;
+    submissions.insert(submissions.end(), count, s);
+    instances.insert(instances.end(), first, first + count);
+}
+
+void SpriteBatch::setOrderDependentShader(int shader, bool orderDependent) {
+    if ((size_t)shader >= orderDependentShaders.size()) {
+        orderDependentShaders.resize(shader + 1, false);
+    }
+    orderDependentShaders[shader] = orderDependent;
+}
+
+int SpriteBatch::getPass(const Submission& s) const {
+    if (s.pass == SPRITE_PASS_TRANSPARENT && transparentOrder == TRANSPARENT_ORDER_INDEPENDENT
+        && (size_t)s.shader < orderDependentShaders.size() && orderDependentShaders[s.shader]) {
+        return SPRITE_PASS_TRANSPARENT_SORTED;
+    }
+    return s.pass;
+}
+
+//--------------------------------------------------------------
+/**
+ float 을 비트 그대로 부호 없는 정수로 비교해도 크기 순서가 유지되도록 바꿈.
+ 양수는 부호 비트만 켜고, 음수는 모든 비트를 뒤집으면 (음수는 절대값이 클수록 작아야 하므로) 정수 비교 순서와 float 순서가 같아짐.
+ */
+static inline uint32_t sortableFloatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/**
+ 64비트 키를 8비트씩 8번 나눠서 하위 자리부터 정렬하는 LSD 기수 정렬.
+
+ 자리마다 개수를 세서(histogram) 각 값이 들어갈 시작 위치를 구한 뒤, 원래 순서대로 옮겨 담으므로 안정 정렬임.
+ 그래서 처음에 submit() 순서로 채워두면 키가 같은 항목끼리는 submit() 순서가 유지됨.
+ 모든 항목의 해당 자리 값이 같으면 (비워둔 비트, 대부분 같은 pass 비트 등) 그 자리는 옮기지 않고 건너뜀.
+ */
+void SpriteBatch::radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) {
+    size_t n = entries.size();
+    scratch.resize(n);
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const SortEntry& e : entries) {
+            counts[(e.key >> shift) & 0xFF]++;
+        }
+        if (n == 0 || counts[(entries[0].key >> shift) & 0xFF] == n) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t c = count;
+            count = offset;
+            offset += c;
+        }
+        for (const SortEntry& e : entries) {
+            scratch[counts[(e.key >> shift) & 0xFF]++] = e;
+        }
+        entries.swap(scratch);
+    }
+}
+
+//--------------------------------------------------------------
+void SpriteBatch::build(const glm::mat4& view) {
+    size_t n = instances.size();
+
+    /**
+     정렬 키 만들기 (상위 비트일수록 우선순위가 높음)
+
+     불투명 패스 (반투명 패스도 TRANSPARENT_ORDER_INDEPENDENT 이면 같은 키를 씀)
+     | pass (4bit) | shader (12bit) | texture (16bit) | mesh (16bit) | (16bit 비움) |
+
+     반투명 패스, TRANSPARENT_BACK_TO_FRONT (TRANSPARENT_ORDER_INDEPENDENT 일 때의 SPRITE_PASS_TRANSPARENT_SORTED 도 같음)
+     | pass (4bit) | 뷰 공간 깊이 (32bit) | (28bit 비움) |
+
+     불투명 패스는 깊이테스트로 앞뒤가 가려지므로 순서를 마음대로 바꿔도 되지만,
+     반투명 패스는 그리는 순서에 따라 블렌딩 결과가 달라지므로 기본적으로 pass 만 키로 쓰고 submit() 순서를 그대로 유지함.
+
+     뷰 공간에서는 카메라가 -z 방향을 보고 있으므로 z 가 작을수록 멀리 있음. 그래서 깊이 키를 오름차순으로 정렬하면
+     먼 것부터 그려지고, 깊이가 같은 인스턴스끼리는 submit() 순서가 유지됨.
+     깊이는 모델행렬의 이동 성분(메쉬 원점)을 뷰 공간으로 옮긴 값으로, 뷰행렬의 세 번째 행과 내적하면 됨.
+     */
+    sortEntries.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Submission& s = submissions[i];
+        int pass = getPass(s);
+        uint64_t key = (uint64_t)(pass & 0xF) << 60;
+        if (pass == SPRITE_PASS_OPAQUE || (pass == SPRITE_PASS_TRANSPARENT && transparentOrder == TRANSPARENT_ORDER_INDEPENDENT)) {
+            key |= (uint64_t)(s.shader & 0xFFF) << 48;
+            key |= (uint64_t)(s.texture & 0xFFFF) << 32;
+            key |= (uint64_t)(s.mesh & 0xFFFF) << 16;
+        } else if (pass == SPRITE_PASS_TRANSPARENT_SORTED || transparentOrder == TRANSPARENT_BACK_TO_FRONT) {
+            const glm::vec4& origin = instances[i].model[3];
+            float viewZ = view[0][2] * origin.x + view[1][2] * origin.y + view[2][2] * origin.z + view[3][2] * origin.w;
+            key |= (uint64_t)sortableFloatBits(viewZ) << 28;
+        }
+        sortEntries[i].key = key;
+        sortEntries[i].index = (uint32_t)i;
+    }
+    // 이전에는 std::sort 에 (key, index) 비교 함수를 넘겼는데, 인스턴스가 수만 개가 되면 비교 정렬보다 기수 정렬이 빠름.
+    radixSort(sortEntries, sortScratch);
+
+    // 정렬된 순서대로 인스턴스 데이터를 채우면서, 셰이더/텍스쳐/메쉬가 바뀌는 지점마다 새 그룹을 시작함.
+    instanceData.resize(n * FLOATS_PER_INSTANCE);
+    groups.clear();
+    stats = SpriteBatchStats();
+    stats.instances = (int)n;
+
+    for (size_t i = 0; i < n; ++i) {
+        const Submission& s = submissions[sortEntries[i].index];
+        const SpriteInstance& inst = instances[sortEntries[i].index];
+        int pass = getPass(s);
+
+        float* dst = &instanceData[i * FLOATS_PER_INSTANCE];
+        const float* model = &inst.model[0][0];
+        std::copy(model, model + 16, dst + MODEL_OFFSET);
+        dst[RECT_OFFSET + 0] = inst.uvRect.x;
+        dst[RECT_OFFSET + 1] = inst.uvRect.y;
+        dst[RECT_OFFSET + 2] = inst.uvRect.z;
+        dst[RECT_OFFSET + 3] = inst.uvRect.w;
+        dst[LAYER_OFFSET] = inst.layer;
+
+        SpriteDrawGroup* last = groups.empty() ? nullptr : &groups.back();
+        if (last && last->pass == pass && last->shader == s.shader && last->texture == s.texture && last->mesh == s.mesh) {
+            last->count++;
+            continue;
+        }
+
+        // 첫 그룹이면 모든 상태를 새로 바인딩해야 하므로 전부 변경으로 셈.
+        if (!last || last->pass != pass) stats.passChanges++;
+        if (!last || last->shader != s.shader) stats.shaderChanges++;
+        if (!last || last->texture != s.texture) stats.textureChanges++;
+        if (!last || last->mesh != s.mesh) stats.meshChanges++;
+
+        SpriteDrawGroup group;
+        group.pass = pass;
+        group.shader = s.shader;
+        group.texture = s.texture;
+        group.mesh = s.mesh;
+        group.first = i;
+        group.count = 1;
+        groups.push_back(group);
+    }
+    stats.drawCalls = (int)groups.size();
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ 스프라이트를 메쉬마다 draw() 하지 않고, 인스턴스 드로우 한 번으로 묶어서 그리기 위한 배치.
+
+ 이 클래스는 CPU 쪽 작업만 담당함. (GL 호출이 전혀 없으므로 창 없이도 돌려볼 수 있음)
+ 1. submit() 으로 이번 프레임에 그릴 스프라이트들을 모으고
+ 2. build() 에서 패스 -> 셰이더 -> 텍스쳐 -> 메쉬 순으로 정렬한 뒤
+ 3. 같은 조합끼리 하나의 그룹(= 인스턴스 드로우콜 하나)으로 묶고, 인스턴스 데이터를 float 배열 하나에 채워넣음.
+
+ 실제로 GL 에 업로드해서 그리는 건 spriteRenderer.h 의 SpriteRenderer 가 함.
+ 셰이더, 텍스쳐, 메쉬는 SpriteRenderer 에 등록할 때 받은 정수 id 로만 구분함.
+ */
+
+// 렌더 상태가 달라지는 패스 구분. 불투명 패스를 먼저 그리고, 반투명(알파 블렌딩) 패스를 나중에 그림.
+enum SpritePass {
+    SPRITE_PASS_OPAQUE = 0, // 깊이테스트 o, 블렌딩 x (알파테스트로 투명 픽셀은 discard)
+    SPRITE_PASS_TRANSPARENT = 1, // 깊이테스트 x, OF_BLENDMODE_ALPHA 블렌딩
+    SPRITE_PASS_TRANSPARENT_SORTED = 2, // TRANSPARENT_ORDER_INDEPENDENT 일 때 OIT 로 그릴 수 없는 셰이더의 반투명 스프라이트. OIT 합성 뒤에 깊이 정렬해서 알파 블렌딩함 (submit() 에는 쓰지 않음)
+};
+
+// 반투명 패스를 그리는 순서
+enum TransparentOrder {
+    TRANSPARENT_SUBMIT_ORDER = 0, // submit() 한 순서 그대로 (그리는 순서를 직접 맞춰서 submit 해야 함)
+    TRANSPARENT_BACK_TO_FRONT = 1, // 뷰 공간 깊이로 정렬해서 먼 것부터 그림
+    TRANSPARENT_ORDER_INDEPENDENT = 2, // 순서와 상관없는 블렌딩(OIT)으로 그리므로, 불투명 패스처럼 상태 변경이 적은 순서로 묶음
+};
+
+// 인스턴스 하나에 필요한 데이터. 원래 유니폼 변수로 매번 보내던 값들을 인스턴스 속성(attribute)으로 보냄.
+struct SpriteInstance {
+    glm::mat4 model; // 모델행렬
+    glm::vec4 uvRect = glm::vec4(0, 0, 1, 1); // 텍스쳐에서 그릴 영역. xy 는 uv 시작점, zw 는 uv 크기 (textureAtlas.h 의 AtlasFrame::uvRect)
+    float layer = 0.0f; // 텍스쳐 레이어 번호 (아틀라스 페이지 번호)
+};
+
+// 같은 셰이더, 텍스쳐, 메쉬를 쓰는 연속된 인스턴스 묶음. 그룹 하나가 인스턴스 드로우콜 하나가 됨.
+struct SpriteDrawGroup {
+    int pass;
+    int shader;
+    int texture;
+    int mesh;
+    size_t first; // 인스턴스 버퍼에서 이 그룹의 첫 번째 인스턴스 위치
+    size_t count; // 인스턴스 개수
+};
+
+// 프레임 당 드로우콜 및 상태 변경 횟수
+struct SpriteBatchStats {
+    int instances = 0;
+    int drawCalls = 0;
+    int passChanges = 0; // 깊이테스트, 블렌드모드 변경
+    int shaderChanges = 0;
+    int textureChanges = 0;
+    int meshChanges = 0;
+
+    int stateChanges() const { return passChanges + shaderChanges + textureChanges + meshChanges; }
+};
+
+class SpriteBatch {
+    public:
+        // 인스턴스 하나가 인스턴스 버퍼에서 차지하는 float 개수. model(16) + uvRect(4) + layer(1)
+        static const int FLOATS_PER_INSTANCE = 21;
+        static const int MODEL_OFFSET = 0; // 인스턴스 시작점 기준 float 단위 오프셋
+        static const int RECT_OFFSET = 16;
+        static const int LAYER_OFFSET = 20;
+
+        void clear();
+        void submit(int pass, int shader, int texture, int mesh, const SpriteInstance& instance);
+        // 같은 셰이더, 텍스쳐, 메쉬로 그릴 인스턴스 여러 개를 한꺼번에 추가함. (walkerAnimation.h 의 워커들처럼 수가 많을 때)
+        void submit(int pass, int shader, int texture, int mesh, const SpriteInstance* instances, size_t count);
+        // 반투명 패스 정렬 방식. 기본값은 TRANSPARENT_SUBMIT_ORDER
+        void setTransparentOrder(TransparentOrder order) { transparentOrder = order; }
+        TransparentOrder getTransparentOrder() const { return transparentOrder; }
+
+        /**
+         OIT 용 셰이더가 없어서 순서와 상관없는 블렌딩으로 그릴 수 없는 셰이더를 지정함. (기본값은 모두 false)
+         TRANSPARENT_ORDER_INDEPENDENT 일 때 이 셰이더로 submit() 한 반투명 스프라이트는 SPRITE_PASS_TRANSPARENT_SORTED 그룹으로 옮겨서
+         TRANSPARENT_BACK_TO_FRONT 처럼 뷰 공간 깊이로 정렬함.
+         */
+        void setOrderDependentShader(int shader, bool orderDependent);
+
+        // view 는 TRANSPARENT_BACK_TO_FRONT 일 때 인스턴스의 뷰 공간 깊이를 구하는 데 사용함.
+        void build(const glm::mat4& view = glm::mat4());
+
+        size_t size() const { return instances.size(); }
+        const std::vector<float>& getInstanceData() const { return instanceData; }
+        const std::vector<SpriteDrawGroup>& getGroups() const { return groups; }
+        const SpriteBatchStats& getStats() const { return stats; }
+
+    private:
+        struct SortEntry {
+            uint64_t key;
+            uint32_t index; // submit() 순서. 키가 같으면 이 순서를 유지함.
+        };
+
+        struct Submission {
+            int pass, shader, texture, mesh;
+        };
+
+        static void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+        int getPass(const Submission& s) const; // 정렬, 그룹화에 쓰는 패스 (SPRITE_PASS_TRANSPARENT_SORTED 로 옮겨진 경우 포함)
+
+        std::vector<Submission> submissions;
+        std::vector<SpriteInstance> instances;
+        std::vector<SortEntry> sortEntries;
+        std::vector<SortEntry> sortScratch; // 기수 정렬의 임시 버퍼
+        TransparentOrder transparentOrder = TRANSPARENT_SUBMIT_ORDER;
+        std::vector<bool> orderDependentShaders; // 셰이더 id 인덱스
+
+        std::vector<float> instanceData;
+        std::vector<SpriteDrawGroup> groups;
+        SpriteBatchStats stats;
+};
@@ -0,0 +1,206 @@
+#include "spriteCulling.h"
+#include <limits>
+
+//--------------------------------------------------------------
+SpriteBounds quadBounds(float w, float h, glm::vec3 pos) {
+    SpriteBounds b;
+    b.min = glm::vec3(pos.x - w, pos.y - h, pos.z);
+    b.max = glm::vec3(pos.x + w, pos.y + h, pos.z);
+    return b;
+}
+
+/**
+ 박스의 꼭짓점 8개를 전부 변환하는 대신, 행렬의 각 성분이 min, max 중 어느 쪽과 곱해질 때 더 크거나 작은지만 보고
+ 결과 AABB 를 바로 계산함. (Arvo 의 방법)
+ */
+SpriteBounds transformBounds(const SpriteBounds& local, const glm::mat4& m) {
+    SpriteBounds out;
+    for (int row = 0; row < 3; ++row) {
+        float lo = m[3][row];
+        float hi = m[3][row];
+        for (int col = 0; col < 3; ++col) {
+            float a = m[col][row] * local.min[col];
+            float b = m[col][row] * local.max[col];
+            lo += std::min(a, b);
+            hi += std::max(a, b);
+        }
+        out.min[row] = lo;
+        out.max[row] = hi;
+    }
+    return out;
+}
+
+//--------------------------------------------------------------
+ViewFrustum extractFrustum(const glm::mat4& viewProj) {
+    // glm 은 열 우선 행렬이므로, i번째 행은 (m[0][i], m[1][i], m[2][i], m[3][i]) 임.
+    auto row = [&](int i) {
+        return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+    };
+    glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    ViewFrustum f;
+    f.planes[0] = r3 + r0; // left   (-w <= x)
+    f.planes[1] = r3 - r0; // right  (x <= w)
+    f.planes[2] = r3 + r1; // bottom (-w <= y)
+    f.planes[3] = r3 - r1; // top    (y <= w)
+    f.planes[4] = r3 + r2; // near   (-w <= z)
+    f.planes[5] = r3 - r2; // far    (z <= w)
+
+    // NDC 큐브의 꼭짓점 8개를 월드 공간으로 되돌려서 프러스텀을 감싸는 AABB 를 구함.
+    glm::mat4 inv = glm::inverse(viewProj);
+    f.bounds.min = glm::vec3(std::numeric_limits<float>::max());
+    f.bounds.max = glm::vec3(-std::numeric_limits<float>::max());
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 corner = inv * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+        glm::vec3 p(corner.x / corner.w, corner.y / corner.w, corner.z / corner.w);
+        f.bounds.min = glm::min(f.bounds.min, p);
+        f.bounds.max = glm::max(f.bounds.max, p);
+    }
+    return f;
+}
+
+bool intersects(const ViewFrustum& frustum, const SpriteBounds& b) {
+    for (const glm::vec4& plane : frustum.planes) {
+        // 평면 법선 방향으로 가장 멀리 있는 꼭짓점마저 평면 바깥이면, 박스 전체가 프러스텀 밖에 있는 것임.
+        glm::vec3 p(plane.x >= 0.0f ? b.max.x : b.min.x,
+                    plane.y >= 0.0f ? b.max.y : b.min.y,
+                    plane.z >= 0.0f ? b.max.z : b.min.z);
+        if (plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+SpatialGrid::CellRange SpatialGrid::cellRange(const SpriteBounds& b) const {
+    CellRange r;
+    r.x0 = (int)std::floor(b.min.x / cellSize);
+    r.y0 = (int)std::floor(b.min.y / cellSize);
+    r.x1 = (int)std::floor(b.max.x / cellSize);
+    r.y1 = (int)std::floor(b.max.y / cellSize);
+    return r;
+}
+
+void SpatialGrid::addToCells(int handle, const CellRange& r) {
+    std::vector<uint32_t>& slots = cellSlots[handle];
+    slots.clear();
+    for (int y = r.y0; y <= r.y1; ++y) {
+        for (int x = r.x0; x <= r.x1; ++x) {
+            std::vector<int>& list = cells[cellKey(x, y)];
+            slots.push_back((uint32_t)list.size());
+            list.push_back(handle);
+        }
+    }
+}
+
+/**
+ 셀 목록에서 오브젝트를 찾아서 훑는 대신, addToCells() 에서 기록해둔 위치의 원소를 셀 목록의 마지막 원소와 바꿔서 지움.
+ 그래서 한 셀에 오브젝트가 아무리 많이 몰려 있어도 (군중, 스트레스 장면) 셀마다 상수 시간에 지워짐.
+ 마지막 원소였던 오브젝트는 위치가 바뀌었으므로, 그 오브젝트의 셀 범위에서 이 셀의 순서를 구해서 기록도 고쳐줌.
+ */
+void SpatialGrid::removeFromCells(int handle, const CellRange& r) {
+    const std::vector<uint32_t>& slots = cellSlots[handle];
+    size_t slot = 0;
+    for (int y = r.y0; y <= r.y1; ++y) {
+        for (int x = r.x0; x <= r.x1; ++x, ++slot) {
+            auto it = cells.find(cellKey(x, y));
+            std::vector<int>& list = it->second;
+            uint32_t index = slots[slot];
+            int moved = list.back();
+            list[index] = moved;
+            list.pop_back();
+            if (moved != handle) {
+                const CellRange& m = ranges[moved];
+                cellSlots[moved][(size_t)(y - m.y0) * (m.x1 - m.x0 + 1) + (x - m.x0)] = index;
+            }
+            if (list.empty()) {
+                cells.erase(it);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------
+int SpatialGrid::insert(const SpriteBounds& bounds, int id) {
+    int handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = (int)ranges.size();
+        ranges.push_back(CellRange());
+        ids.push_back(0);
+        alive.push_back(0);
+        cellSlots.push_back(std::vector<uint32_t>());
+    }
+    ranges[handle] = cellRange(bounds);
+    ids[handle] = id;
+    alive[handle] = 1;
+    addToCells(handle, ranges[handle]);
+    liveCount++;
+    return handle;
+}
+
+void SpatialGrid::update(int handle, const SpriteBounds& bounds) {
+    CellRange range = cellRange(bounds);
+    if (range == ranges[handle]) {
+        return; // 같은 셀 범위 안에서 움직였으면 아무것도 고칠 필요가 없음.
+    }
+    removeFromCells(handle, ranges[handle]);
+    ranges[handle] = range;
+    addToCells(handle, range);
+}
+
+void SpatialGrid::remove(int handle) {
+    if (!alive[handle]) {
+        return;
+    }
+    removeFromCells(handle, ranges[handle]);
+    alive[handle] = 0;
+    freeHandles.push_back(handle);
+    liveCount--;
+}
+
+//--------------------------------------------------------------
+void SpatialGrid::query(const SpriteBounds& region, std::vector<int>& out) const {
+    CellRange q = cellRange(region);
+
+    // 보이는 영역보다 셀이 적게 들어있으면 (넓은 영역을 조회할 때) 셀을 하나씩 찾는 대신 전체 셀을 훑음.
+    int64_t queryCells = (int64_t)(q.x1 - q.x0 + 1) * (q.y1 - q.y0 + 1);
+    bool scanAll = queryCells > (int64_t)cells.size();
+
+    auto visit = [&](int x, int y, const std::vector<int>& list) {
+        for (int handle : list) {
+            /**
+             여러 셀에 걸친 오브젝트가 중복으로 나오지 않도록,
+             '오브젝트의 셀 범위와 조회 범위가 겹치는 부분' 의 왼쪽 아래 셀에서만 결과에 넣음.
+             */
+            const CellRange& r = ranges[handle];
+            if (x == std::max(r.x0, q.x0) && y == std::max(r.y0, q.y0)) {
+                out.push_back(ids[handle]);
+            }
+        }
+    };
+
+    if (scanAll) {
+        for (const auto& cell : cells) {
+            int x = (int32_t)(uint32_t)(cell.first >> 32);
+            int y = (int32_t)(uint32_t)(cell.first & 0xFFFFFFFF);
+            if (x < q.x0 || x > q.x1 || y < q.y0 || y > q.y1) {
+                continue;
+            }
+            visit(x, y, cell.second);
+        }
+        return;
+    }
+
+    for (int y = q.y0; y <= q.y1; ++y) {
+        for (int x = q.x0; x <= q.x1; ++x) {
+            auto it = cells.find(cellKey(x, y));
+            if (it != cells.end()) {
+                visit(x, y, it->second);
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ofMain.h"
+#include <unordered_map>
+
+/**
+ 화면(프러스텀) 밖의 스프라이트를 spriteBatch 에 submit 하기 전에 걸러내기 위한 컬링 도구들.
+
+ 1. SpriteBounds: buildMesh() 로 만든 쿼드의 범위를 모델행렬로 변환한 월드 공간 AABB(축 정렬 바운딩 박스)
+ 2. ViewFrustum: proj * view 행렬에서 뽑아낸 프러스텀의 평면 6개. AABB 가 프러스텀과 겹치는지 정확하게 검사함.
+ 3. SpatialGrid: 월드 공간을 일정한 크기의 셀로 나눠서, 각 셀에 걸치는 스프라이트들을 기록해두는 균일 격자.
+    화면에 보이는 영역에 걸치는 셀들만 조회하면 되므로, 넓은 월드에서 화면 밖 스프라이트들은 아예 검사하지 않음.
+    스프라이트가 움직여도 걸치는 셀 범위가 바뀔 때만 셀 목록을 고치고, 셀 목록에서의 위치를 기억해둬서 셀에 몇 개가 몰려 있든 상수 시간에 지움.
+
+ 컬링되는 비율, 격자 조회와 전체 검사의 시간, 움직이는 스프라이트의 격자 갱신 비용은 --bench culling 으로 측정함. (benchmarks.cpp)
+ */
+
+struct SpriteBounds {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// buildMesh(mesh, w, h, pos) 로 만든 쿼드의 로컬 공간 범위
+SpriteBounds quadBounds(float w, float h, glm::vec3 pos);
+
+// 로컬 공간 AABB 를 행렬로 변환한 뒤, 변환된 박스 전체를 감싸는 AABB 를 리턴함.
+SpriteBounds transformBounds(const SpriteBounds& local, const glm::mat4& m);
+
+struct ViewFrustum {
+    glm::vec4 planes[6]; // xyz 는 프러스텀 안쪽을 향하는 법선, w 는 거리. dot(xyz, p) + w >= 0 이면 평면 안쪽.
+    SpriteBounds bounds; // 프러스텀 전체를 감싸는 월드 공간 AABB (SpatialGrid 조회 영역으로 사용)
+};
+
+// viewProj = proj * view. 클립공간의 -w <= x, y, z <= w 조건을 월드 공간 평면으로 바꿔서 프러스텀을 만듦.
+ViewFrustum extractFrustum(const glm::mat4& viewProj);
+
+// AABB 가 프러스텀과 조금이라도 겹치면 true
+bool intersects(const ViewFrustum& frustum, const SpriteBounds& bounds);
+
+class SpatialGrid {
+    public:
+        explicit SpatialGrid(float cellSize = 1.0f) : cellSize(cellSize) {}
+
+        // id 는 query() 결과로 돌려받을 값. 추가한 오브젝트의 핸들을 리턴함. (update(), remove() 에서 오브젝트를 가리킬 때 사용)
+        int insert(const SpriteBounds& bounds, int id);
+        void update(int handle, const SpriteBounds& bounds);
+        void remove(int handle);
+
+        // xy 평면에서 region 과 겹치는 셀에 들어있는 오브젝트의 id 를 out 에 추가함. (중복 없음)
+        // 셀 단위로 걸러내는 것이므로, 정확한 검사는 호출하는 쪽에서 intersects() 등으로 다시 해야 함.
+        void query(const SpriteBounds& region, std::vector<int>& out) const;
+
+        size_t size() const { return liveCount; }
+
+    private:
+        struct CellRange {
+            int x0, y0, x1, y1;
+            bool operator==(const CellRange& o) const { return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1; }
+        };
+
+        CellRange cellRange(const SpriteBounds& bounds) const;
+        static uint64_t cellKey(int x, int y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+        void addToCells(int handle, const CellRange& range);
+        void removeFromCells(int handle, const CellRange& range);
+
+        float cellSize;
+        std::unordered_map<uint64_t, std::vector<int>> cells; // 셀 좌표 -> 그 셀에 걸친 오브젝트 핸들 목록
+        std::vector<CellRange> ranges; // 핸들 -> 걸쳐있는 셀 범위
+        std::vector<std::vector<uint32_t>> cellSlots; // 핸들 -> 걸쳐있는 셀마다 (범위 안에서 행 우선 순서로) 셀 목록에서의 위치
+        std::vector<int> ids; // 핸들 -> insert() 에서 받은 id
+        std::vector<uint8_t> alive;
+        std::vector<int> freeHandles; // remove() 된 핸들은 다음 insert() 에서 재사용함.
+        size_t liveCount = 0;
+};
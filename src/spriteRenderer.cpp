@@ -0,0 +1,171 @@
+#include "spriteRenderer.h"
+
+//--------------------------------------------------------------
+void SpriteRenderer::setup() {
+    instanceBuffer.allocate(); // GL 버퍼 객체 생성. 실제 데이터는 매 프레임 draw() 에서 업로드함.
+    camera.setup();
+}
+
+//--------------------------------------------------------------
+int SpriteRenderer::addShader(ofShader& shader) {
+    camera.attach(shader);
+    UniformCache cache;
+    cache.setup(shader, { "tex" }); // UniformSlot 순서와 같아야 함.
+    shaders.push_back(&shader);
+    uniforms.push_back(cache);
+    oitVariants.push_back(-1);
+    oitFallbackLogged.push_back(false);
+    return (int)shaders.size() - 1;
+}
+
+void SpriteRenderer::setOITVariant(int shader, int oitShader) {
+    oitVariants[shader] = oitShader;
+}
+
+int SpriteRenderer::addTexture(ofTexture& texture) {
+    textures.push_back(&texture);
+    return (int)textures.size() - 1;
+}
+
+int SpriteRenderer::addMesh(const ofMesh& mesh, const std::string& name) {
+    std::unique_ptr<ofVbo> vbo(new ofVbo());
+    vbo->setMesh(mesh, GL_STATIC_DRAW); // 메쉬 버텍스는 바뀌지 않으므로 한 번만 업로드함.
+    meshes.push_back(std::move(vbo));
+    meshNames.push_back(name);
+    return (int)meshes.size() - 1;
+}
+
+void SpriteRenderer::updateMesh(int mesh, const ofMesh& data) {
+    meshes[mesh]->setMesh(data, GL_STATIC_DRAW);
+}
+
+void SpriteRenderer::reloadShader(int shader) {
+    camera.attach(*shaders[shader]);
+    uniforms[shader].setup(*shaders[shader], { "tex" }); // 프로그램이 새로 링크됐으므로 location 과 마지막으로 보낸 값을 다시 찾음
+}
+
+//--------------------------------------------------------------
+void SpriteRenderer::applyPass(int pass) {
+    if (pass == SPRITE_PASS_OPAQUE) {
+        ofDisableBlendMode();
+        ofEnableDepthTest(); // 캐릭터메쉬, 배경메쉬는 깊이를 구분해줘야 함.
+    } else {
+        ofDisableDepthTest(); // 투명 픽셀이 깊이버퍼값을 가져서 뒤에 있는 메쉬를 가리지 않도록 깊이테스트 비활성화
+        if (pass == SPRITE_PASS_TRANSPARENT && oit && oit->isAvailable()) {
+            oit->begin(); // 누적 버퍼 바인딩 및 버퍼별 블렌드 함수 설정
+            oitActive = true;
+        } else {
+            ofEnableBlendMode(ofBlendMode::OF_BLENDMODE_ALPHA);
+        }
+    }
+}
+
+void SpriteRenderer::resolveOIT() {
+    PROFILE_SCOPE("oit resolve");
+    GpuProfileScope gpuScope(gpuProfiler, "oit resolve");
+    oit->resolve();
+    oitActive = false;
+}
+
+void SpriteRenderer::logOITFallback(int shader, const char* message) {
+    if (!oitFallbackLogged[shader]) {
+        ofLogWarning("SpriteRenderer") << "shader " << shader << " has no OIT variant, " << message;
+        oitFallbackLogged[shader] = true;
+    }
+}
+
+//--------------------------------------------------------------
+void SpriteRenderer::draw(const SpriteBatch& batch, const glm::mat4& view, const glm::mat4& proj) {
+    uniformStats.reset();
+    const std::vector<SpriteDrawGroup>& groups = batch.getGroups();
+    if (groups.empty()) {
+        return;
+    }
+
+    // 카메라가 그대로면 유니폼 버퍼는 다시 업로드하지 않음.
+    camera.update(view, proj, uniformStats);
+
+    // 이번 프레임의 인스턴스 데이터 전체를 한 번에 업로드함.
+    instanceBuffer.setData(batch.getInstanceData(), GL_STREAM_DRAW);
+
+    const int stride = SpriteBatch::FLOATS_PER_INSTANCE * sizeof(float);
+    int currentPass = -1;
+    ofShader* currentShader = nullptr;
+    int currentTexture = -1; // 텍스쳐 바인딩은 셰이더를 바꿔도 유지되므로, 셰이더가 바뀌어도 다시 바인딩하지 않음.
+
+    for (const SpriteDrawGroup& group : groups) {
+        // OIT 로 그릴 수 없는 반투명 그룹은 합성 결과 위에 그려야 하므로, 그 패스로 넘어가기 전에 누적 버퍼를 합성함.
+        // 합성 셰이더가 셰이더와 0, 1 번 텍스쳐 유닛 바인딩을 바꾸므로 다시 바인딩하도록 함.
+        if (oitActive && group.pass == SPRITE_PASS_TRANSPARENT_SORTED) {
+            if (currentShader) {
+                currentShader->end();
+                currentShader = nullptr;
+            }
+            currentTexture = -1;
+            resolveOIT();
+        }
+
+        PROFILE_SCOPE(meshNames[group.mesh].c_str());
+        GpuProfileScope gpuScope(gpuProfiler, meshNames[group.mesh].c_str());
+
+        if (group.pass != currentPass) {
+            applyPass(group.pass);
+            currentPass = group.pass;
+        }
+
+        // OIT 로 그릴 때는 반투명 그룹의 셰이더를 누적 버퍼에 출력하는 셰이더로 바꿈.
+        // OIT 용 셰이더가 없는데 SPRITE_PASS_TRANSPARENT_SORTED 로 옮겨지지 않은 그룹은 누적 버퍼를 망가뜨리므로 그리지 않음.
+        int shaderId = group.shader;
+        if (oitActive && group.pass == SPRITE_PASS_TRANSPARENT) {
+            if (oitVariants[shaderId] < 0) {
+                logOITFallback(shaderId, "skipping its transparent sprites (mark it with SpriteBatch::setOrderDependentShader())");
+                continue;
+            }
+            shaderId = oitVariants[shaderId];
+        } else if (oit && group.pass == SPRITE_PASS_TRANSPARENT_SORTED) {
+            logOITFallback(shaderId, "drawing its transparent sprites depth-sorted after the OIT composite");
+        }
+        ofShader* shader = shaders[shaderId];
+        if (shader != currentShader) {
+            if (currentShader) {
+                currentShader->end();
+            }
+            shader->begin();
+            currentShader = shader;
+
+            // tex 는 항상 0 번 텍스쳐 유닛을 가리키므로, 셰이더마다 처음 한 번만 실제로 전송됨.
+            uniforms[shaderId].set(TEX_SLOT, 0, uniformStats);
+        }
+
+        if (group.texture != currentTexture) {
+            const ofTextureData& texData = textures[group.texture]->getTextureData();
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(texData.textureTarget, texData.textureID);
+            currentTexture = group.texture;
+        }
+
+        // 메쉬 vbo 의 인스턴스 속성들이 인스턴스 버퍼에서 이 그룹이 시작하는 위치를 가리키도록 함.
+        ofVbo& vbo = *meshes[group.mesh];
+        int base = (int)group.first * stride;
+        for (int col = 0; col < 4; ++col) {
+            vbo.setAttributeBuffer(MODEL_LOCATION + col, instanceBuffer, 4, stride, base + (SpriteBatch::MODEL_OFFSET + col * 4) * sizeof(float));
+            vbo.setAttributeDivisor(MODEL_LOCATION + col, 1); // 버텍스마다가 아니라 인스턴스마다 다음 값으로 넘어가도록 함.
+        }
+        vbo.setAttributeBuffer(RECT_LOCATION, instanceBuffer, 4, stride, base + SpriteBatch::RECT_OFFSET * sizeof(float));
+        vbo.setAttributeDivisor(RECT_LOCATION, 1);
+        vbo.setAttributeBuffer(LAYER_LOCATION, instanceBuffer, 1, stride, base + SpriteBatch::LAYER_OFFSET * sizeof(float));
+        vbo.setAttributeDivisor(LAYER_LOCATION, 1);
+
+        vbo.drawElementsInstanced(GL_TRIANGLES, vbo.getNumIndices(), (int)group.count);
+    }
+
+    if (currentShader) {
+        currentShader->end();
+    }
+
+    // 반투명 패스를 누적 버퍼에 그렸는데 아직 합성하지 않았으면 화면에 합성함.
+    // (반투명 패스는 정렬 키의 pass 값이 불투명 패스보다 커서 항상 나중에 그려지고, SPRITE_PASS_TRANSPARENT_SORTED 그룹이 있으면 루프 안에서 이미 합성함)
+    if (oitActive) {
+        resolveOIT();
+    }
+}
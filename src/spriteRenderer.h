@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ofMain.h"
+#include "spriteBatch.h"
+#include "uniformCache.h"
+#include "gpuProfiler.h"
+#include "weightedBlendedOIT.h"
+
+/**
+ SpriteBatch 가 만들어준 그룹과 인스턴스 데이터를 GL 로 그려주는 클래스.
+
+ 인스턴스 데이터 전체를 ofBufferObject 하나에 한 번만 업로드하고,
+ 그룹마다 메쉬 vbo 의 인스턴스 속성이 버퍼의 해당 구간을 가리키도록 바꾼 뒤
+ drawElementsInstanced() 로 그룹 전체를 한 번에 그림.
+
+ 인스턴스 속성의 location 은 spriteInstanced.vert 와 맞춰야 함.
+ (0 ~ 3 번은 오픈프레임웍스가 위치, 색상, 노멀, uv 좌표에 사용하고 있으므로 4번부터 사용)
+
+ 뷰행렬, 투영행렬은 셰이더마다 보내지 않고 CameraUniformBuffer 로 모든 셰이더가 공유하고,
+ 나머지 유니폼(tex)은 셰이더마다 UniformCache 로 같은 값을 다시 보내지 않음. (uniformCache.h 참고)
+
+ 그룹마다 메쉬 이름으로 CPU 구간(PROFILE_SCOPE)과 GPU 구간을 기록하므로, 프로파일러에서 메쉬별로 걸린 시간을 볼 수 있음.
+
+ setOrderIndependent() 로 WeightedBlendedOIT 를 지정하면, 반투명 패스는 OF_BLENDMODE_ALPHA 대신 OIT 누적 버퍼에 그리고
+ 패스가 끝나면 합성함. 이 때 반투명 그룹의 셰이더는 setOITVariant() 로 지정한 OIT 용 셰이더로 바꿔서 그림.
+ OIT 용 셰이더가 없는 셰이더는 누적 버퍼(MRT)에 일반 색상을 써서 결과를 망가뜨리므로 OIT 패스에서는 그리지 않음.
+ 이런 셰이더는 SpriteBatch::setOrderDependentShader() 로 지정해서 SPRITE_PASS_TRANSPARENT_SORTED 그룹으로 받고, 합성이 끝난 뒤 알파 블렌딩으로 그림.
+ */
+class SpriteRenderer {
+    public:
+        static const int MODEL_LOCATION = 4; // mat4 라서 4 ~ 7 번 location 4개를 차지함
+        static const int RECT_LOCATION = 8; // vec4 uvRect (xy = uv 시작점, zw = uv 크기)
+        static const int LAYER_LOCATION = 9; // float layer
+
+        void setup();
+
+        // 각 리소스를 등록하고, SpriteBatch::submit() 에 넘길 id 를 리턴받음.
+        // 셰이더와 텍스쳐는 포인터만 보관하므로, 등록한 객체가 렌더러보다 오래 살아있어야 함.
+        int addShader(ofShader& shader);
+        int addTexture(ofTexture& texture);
+        int addMesh(const ofMesh& mesh, const std::string& name = "mesh"); // name 은 프로파일러 구간 이름
+
+        // 장면 파일이 바뀌었을 때 (핫 리로드) 등록해둔 리소스를 갱신함. id 는 그대로 유지됨.
+        void updateMesh(int mesh, const ofMesh& data);
+        void reloadShader(int shader); // 셰이더를 다시 load() 한 뒤 호출해서 카메라 블록과 유니폼 location 을 다시 연결함
+
+        // 반투명 패스를 OIT 로 그릴 때 shader 대신 사용할 셰이더를 지정함. (둘 다 addShader() 로 등록한 id)
+        void setOITVariant(int shader, int oitShader);
+
+        // 반투명 패스를 OIT 로 그림. nullptr 이면 OF_BLENDMODE_ALPHA 로 그림.
+        void setOrderIndependent(WeightedBlendedOIT* oit) { this->oit = oit; }
+
+        // GPU 구간을 기록할 프로파일러를 지정함. nullptr 이면 CPU 구간만 기록함.
+        void setGpuProfiler(GpuProfiler* profiler) { gpuProfiler = profiler; }
+
+        void draw(const SpriteBatch& batch, const glm::mat4& view, const glm::mat4& proj);
+
+        // 마지막 draw() 에서 보낸 / 건너뛴 유니폼 수
+        const UniformStats& getUniformStats() const { return uniformStats; }
+
+    private:
+        enum UniformSlot {
+            TEX_SLOT = 0, // UniformCache::setup() 에 넘기는 이름 순서
+        };
+
+        void applyPass(int pass);
+        void resolveOIT();
+        void logOITFallback(int shader, const char* message); // 셰이더마다 한 번만 출력함
+
+        std::vector<ofShader*> shaders;
+        std::vector<UniformCache> uniforms; // shaders 와 같은 인덱스
+        std::vector<int> oitVariants; // shaders 와 같은 인덱스. OIT 용 셰이더 id (없으면 -1)
+        std::vector<bool> oitFallbackLogged; // shaders 와 같은 인덱스
+        WeightedBlendedOIT* oit = nullptr;
+        bool oitActive = false; // 이번 draw() 에서 OIT 누적 버퍼에 그리는 중
+        std::vector<ofTexture*> textures;
+        std::vector<std::unique_ptr<ofVbo>> meshes;
+        std::deque<std::string> meshNames; // meshes 와 같은 인덱스. 프로파일러가 문자열 포인터를 보관하므로, 추가해도 기존 원소가 옮겨지지 않는 deque 에 보관함
+        GpuProfiler* gpuProfiler = nullptr;
+
+        ofBufferObject instanceBuffer;
+        CameraUniformBuffer camera;
+        UniformStats uniformStats;
+};
@@ -0,0 +1,329 @@
+#include "textureAtlas.h"
+#include "fileTime.h"
+#include <fstream>
+#include <numeric>
+
+// 손상된 파일에서 읽은 개수로 엄청난 크기를 할당하지 않도록 둔 상한값
+static const uint32_t MAX_PAGES = 256;
+static const uint32_t MAX_FRAMES = 1 << 20;
+
+
+// 채널 수와 상관없이 8비트 RGBA 이미지로 바꿔줌. (forest.png 처럼 알파 채널이 없는 이미지는 알파 255 로 채움)
+static ofPixels toRGBA(const ofPixels& src) {
+    if (src.getNumChannels() == 4) {
+        return src;
+    }
+    ofPixels dst;
+    dst.allocate(src.getWidth(), src.getHeight(), OF_PIXELS_RGBA);
+    size_t channels = src.getNumChannels();
+    const unsigned char* in = src.getData();
+    unsigned char* out = dst.getData();
+    for (size_t i = 0; i < src.getWidth() * src.getHeight(); ++i) {
+        const unsigned char* p = in + i * channels;
+        unsigned char* q = out + i * 4;
+        if (channels >= 3) {
+            q[0] = p[0];
+            q[1] = p[1];
+            q[2] = p[2];
+        } else {
+            q[0] = q[1] = q[2] = p[0];
+        }
+        q[3] = channels == 2 ? p[1] : 255;
+    }
+    return dst;
+}
+
+//--------------------------------------------------------------
+/**
+ 선반(shelf) 방식으로 배치함.
+
+ 이미지를 높이가 큰 순서대로 정렬한 뒤, 각 이미지를 들어갈 수 있는 첫 번째 선반(가로 한 줄)의 오른쪽 끝에 붙임.
+ 들어갈 선반이 없으면 남은 공간이 있는 페이지 아래쪽에 새 선반을 만들고, 그래도 없으면 새 페이지를 만듦.
+ 높이 순으로 넣으므로 선반마다 낭비되는 세로 공간이 작고, 페이지는 마지막에 실제로 사용한 크기로 잘라냄.
+ */
+void TextureAtlas::build(const std::vector<AtlasSource>& input, int pageSize) {
+    pages.clear();
+    pageSizes.clear();
+    frames.clear();
+    sources.clear();
+    usedPixels = 0;
+
+    std::vector<size_t> order(input.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return input[a].pixels.getHeight() > input[b].pixels.getHeight();
+    });
+
+    struct Shelf {
+        int page, y, height, x;
+    };
+    struct Placement {
+        int page = -1;
+        int x = 0, y = 0; // 패딩을 포함한 영역의 왼쪽 위
+    };
+    std::vector<Shelf> shelves;
+    std::vector<Placement> placements(input.size());
+    std::vector<glm::ivec2> pageExtents; // 페이지마다 실제로 사용한 가로, 세로 크기
+
+    for (size_t index : order) {
+        const ofPixels& src = input[index].pixels;
+        int w = (int)src.getWidth() + PADDING * 2;
+        int h = (int)src.getHeight() + PADDING * 2;
+        if (w > pageSize || h > pageSize || !src.isAllocated()) {
+            ofLogError("TextureAtlas") << "build(): " << input[index].name << " (" << src.getWidth() << "x" << src.getHeight() << ") does not fit in a " << pageSize << " page";
+            continue;
+        }
+
+        Shelf* target = nullptr;
+        for (Shelf& shelf : shelves) {
+            if (h <= shelf.height && shelf.x + w <= pageSize) {
+                target = &shelf;
+                break;
+            }
+        }
+        if (!target) {
+            int page = -1;
+            for (size_t p = 0; p < pageExtents.size(); ++p) {
+                if (pageExtents[p].y + h <= pageSize) {
+                    page = (int)p;
+                    break;
+                }
+            }
+            if (page < 0) {
+                page = (int)pageExtents.size();
+                pageExtents.push_back(glm::ivec2(0, 0));
+            }
+            shelves.push_back({page, pageExtents[page].y, h, 0});
+            pageExtents[page].y += h;
+            target = &shelves.back();
+        }
+
+        placements[index].page = target->page;
+        placements[index].x = target->x;
+        placements[index].y = target->y;
+        target->x += w;
+        pageExtents[target->page].x = std::max(pageExtents[target->page].x, target->x);
+    }
+
+    pages.resize(pageExtents.size());
+    pageSizes = pageExtents;
+    for (size_t p = 0; p < pages.size(); ++p) {
+        pages[p].allocate(pageExtents[p].x, pageExtents[p].y, OF_PIXELS_RGBA);
+        memset(pages[p].getData(), 0, pages[p].getTotalBytes()); // 빈 공간은 투명하게
+    }
+
+    // 배치 순서와 상관없이 프레임 번호는 입력 순서대로 매김.
+    for (size_t i = 0; i < input.size(); ++i) {
+        const AtlasSource& source = input[i];
+        const Placement& place = placements[i];
+        if (place.page < 0) {
+            continue;
+        }
+
+        ofPixels rgba = toRGBA(source.pixels);
+
+        // 이미지를 복사하면서 패딩 영역은 가장 가까운 가장자리 픽셀로 채움. (GL_CLAMP_TO_EDGE 처럼 보이게)
+        ofPixels& page = pages[place.page];
+        int w = (int)rgba.getWidth();
+        int h = (int)rgba.getHeight();
+        for (int y = -PADDING; y < h + PADDING; ++y) {
+            int sy = std::min(std::max(y, 0), h - 1);
+            unsigned char* dstRow = page.getData() + ((size_t)(place.y + PADDING + y) * page.getWidth() + place.x) * 4;
+            const unsigned char* srcRow = rgba.getData() + (size_t)sy * w * 4;
+            for (int x = -PADDING; x < w + PADDING; ++x) {
+                int sx = std::min(std::max(x, 0), w - 1);
+                memcpy(dstRow + (x + PADDING) * 4, srcRow + sx * 4, 4);
+            }
+        }
+        usedPixels += (size_t)w * h;
+
+        // 스프라이트시트 프레임들의 uv 사각형을 페이지 uv 기준으로 바꿔둠.
+        SourceEntry entry;
+        entry.firstFrame = (int)frames.size();
+        entry.frameCount = source.frameCount;
+        sources[source.name] = entry;
+
+        float pageW = (float)page.getWidth();
+        float pageH = (float)page.getHeight();
+        glm::vec2 frameSize = source.frameSize * glm::vec2(w, h); // 프레임 하나의 픽셀 크기
+        for (int f = 0; f < source.frameCount; ++f) {
+            int column = f % source.columns;
+            int row = f / source.columns;
+            float x = place.x + PADDING + column * frameSize.x;
+            float y = place.y + PADDING + row * frameSize.y;
+
+            AtlasFrame frame;
+            frame.page = place.page;
+            frame.uvRect = glm::vec4(x / pageW, y / pageH, frameSize.x / pageW, frameSize.y / pageH);
+            frames.push_back(frame);
+        }
+    }
+}
+
+//--------------------------------------------------------------
+bool TextureAtlas::save(const std::string& descriptorPath) const {
+    std::ofstream out(ofToDataPath(descriptorPath), std::ios::binary);
+    if (!out) {
+        ofLogError("TextureAtlas") << "save(): cannot write " << descriptorPath;
+        return false;
+    }
+
+    auto write32 = [&](uint32_t v) { out.write((const char*)&v, sizeof(v)); };
+    auto writeFloat = [&](float v) { out.write((const char*)&v, sizeof(v)); };
+
+    out.write("ATL1", 4);
+    write32((uint32_t)pages.size());
+    for (const ofPixels& page : pages) {
+        write32((uint32_t)page.getWidth());
+        write32((uint32_t)page.getHeight());
+    }
+
+    write32((uint32_t)sources.size());
+    for (const auto& source : sources) {
+        uint16_t length = (uint16_t)source.first.size();
+        out.write((const char*)&length, sizeof(length));
+        out.write(source.first.data(), length);
+        write32((uint32_t)source.second.firstFrame);
+        write32((uint32_t)source.second.frameCount);
+    }
+
+    write32((uint32_t)frames.size());
+    for (const AtlasFrame& frame : frames) {
+        write32((uint32_t)frame.page);
+        writeFloat(frame.uvRect.x);
+        writeFloat(frame.uvRect.y);
+        writeFloat(frame.uvRect.z);
+        writeFloat(frame.uvRect.w);
+    }
+    if (!out) {
+        ofLogError("TextureAtlas") << "save(): failed while writing " << descriptorPath;
+        return false;
+    }
+
+    for (size_t p = 0; p < pages.size(); ++p) {
+        if (!ofSaveImage(pages[p], getPagePath(descriptorPath, p))) {
+            ofLogError("TextureAtlas") << "save(): cannot write " << getPagePath(descriptorPath, p);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TextureAtlas::load(const std::string& descriptorPath) {
+    pages.clear();
+    pageSizes.clear();
+    frames.clear();
+    sources.clear();
+    usedPixels = 0;
+
+    std::ifstream in(ofToDataPath(descriptorPath), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    auto read32 = [&]() { uint32_t v = 0; in.read((char*)&v, sizeof(v)); return v; };
+    auto readFloat = [&]() { float v = 0; in.read((char*)&v, sizeof(v)); return v; };
+    auto fail = [&](const std::string& reason) {
+        ofLogError("TextureAtlas") << "load(): " << descriptorPath << ": " << reason;
+        pageSizes.clear();
+        frames.clear();
+        sources.clear();
+        return false;
+    };
+
+    char magic[4] = {};
+    in.read(magic, 4);
+    if (!in || memcmp(magic, "ATL1", 4) != 0) {
+        return fail("not an atlas descriptor");
+    }
+
+    uint32_t pageCount = read32();
+    if (!in || pageCount > MAX_PAGES) {
+        return fail("bad page count");
+    }
+    pageSizes.resize(pageCount);
+    for (glm::ivec2& size : pageSizes) {
+        size.x = (int)read32();
+        size.y = (int)read32();
+    }
+
+    uint32_t sourceCount = read32();
+    for (uint32_t i = 0; i < sourceCount && in; ++i) {
+        uint16_t length = 0;
+        in.read((char*)&length, sizeof(length));
+        std::string name(length, '\0');
+        in.read(&name[0], length);
+        SourceEntry entry;
+        entry.firstFrame = (int)read32();
+        entry.frameCount = (int)read32();
+        sources[name] = entry;
+    }
+
+    uint32_t frameCount = read32();
+    if (!in || frameCount > MAX_FRAMES) {
+        return fail("bad frame count");
+    }
+    frames.resize(frameCount);
+    for (AtlasFrame& frame : frames) {
+        frame.page = (int)read32();
+        frame.uvRect.x = readFloat();
+        frame.uvRect.y = readFloat();
+        frame.uvRect.z = readFloat();
+        frame.uvRect.w = readFloat();
+        if (frame.page < 0 || frame.page >= (int)pageSizes.size()) {
+            return fail("frame refers to a missing page");
+        }
+    }
+    if (!in) {
+        return fail("truncated file");
+    }
+    for (const auto& source : sources) {
+        if (source.second.firstFrame < 0 || source.second.firstFrame + source.second.frameCount > (int)frames.size()) {
+            return fail("source " + source.first + " refers to missing frames");
+        }
+    }
+
+    for (const AtlasFrame& frame : frames) {
+        usedPixels += (size_t)(frame.uvRect.z * pageSizes[frame.page].x * frame.uvRect.w * pageSizes[frame.page].y);
+    }
+    return true;
+}
+
+// 디스크립터 경로에서 페이지 이미지 경로를 만듦. (atlas.bin -> atlas_0.png, atlas_1.png, ...)
+std::string TextureAtlas::getPagePath(const std::string& descriptorPath, size_t page) {
+    return ofFilePath::removeExt(descriptorPath) + "_" + ofToString(page) + ".png";
+}
+
+//--------------------------------------------------------------
+int TextureAtlas::findFrame(const std::string& name) const {
+    auto it = sources.find(name);
+    return it == sources.end() ? -1 : it->second.firstFrame;
+}
+
+int TextureAtlas::getFrameCount(const std::string& name) const {
+    auto it = sources.find(name);
+    return it == sources.end() ? 0 : it->second.frameCount;
+}
+
+float TextureAtlas::getPackingEfficiency() const {
+    size_t total = 0;
+    for (const glm::ivec2& size : pageSizes) {
+        total += (size_t)size.x * size.y;
+    }
+    return total == 0 ? 0.0f : (float)usedPixels / total;
+}
+
+//--------------------------------------------------------------
+bool isAtlasStale(const std::string& descriptorPath, const std::vector<std::string>& sourcePaths) {
+    // 에셋 로더의 캐시 파일과 마찬가지로 나노초 수정 시각으로 비교함. (파일이 없으면 0)
+    int64_t descriptor = getModifiedTime(descriptorPath);
+    if (descriptor == 0) {
+        return true;
+    }
+    for (const std::string& path : sourcePaths) {
+        if (getModifiedTime(path) > descriptor) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ 여러 텍스쳐 이미지를 하나(또는 몇 개)의 큰 아틀라스 페이지 이미지로 합쳐주는 텍스쳐 아틀라스.
+
+ 이미지마다 텍스쳐를 따로 바인딩하지 않고 페이지 하나만 바인딩하면 되므로 텍스쳐 변경 횟수가 줄고,
+ 시작할 때도 PNG 여러 개 대신 페이지 PNG 하나와 작은 바이너리 디스크립터만 로드하면 됨.
+
+ - 스프라이트시트 이미지는 프레임 단위로 잘라서 등록하므로, 각 프레임의 uv 사각형을 미리 계산해 둠.
+   (draw() 에서 spriteSize, frame % 3, frame / 3 으로 직접 계산하던 값을 프레임 번호 하나로 찾을 수 있음)
+ - uv 사각형은 fragUV 기준 (v = 0 이 이미지 첫 번째 행) 이고, xy 는 시작점, zw 는 크기임.
+   버텍스 셰이더에서 fragUV = uvRect.xy + vec2(uv.x, 1.0 - uv.y) * uvRect.zw 로 바로 사용할 수 있음.
+ - 선형 필터링으로 옆 이미지의 픽셀이 섞여 들어오지 않도록, 이미지 사이에 가장자리 픽셀을 늘려서 채운 여백(padding)을 둠.
+
+ 디스크립터 파일 형식 (리틀 엔디언)
+   char[4]  "ATL1"
+   uint32   페이지 수
+     uint32 width, uint32 height                     (페이지마다, 페이지 이미지는 <디스크립터 이름>_<페이지 번호>.png)
+   uint32   소스 이미지 수
+     uint16 이름 길이, char[] 이름, uint32 첫 프레임 번호, uint32 프레임 수   (소스마다)
+   uint32   프레임 수
+     uint32 페이지 번호, float x, y, w, h               (프레임마다)
+ */
+
+struct AtlasFrame {
+    int page;
+    glm::vec4 uvRect; // xy = uv 시작점, zw = uv 크기
+};
+
+// 아틀라스에 넣을 이미지 하나. 스프라이트시트라면 프레임 크기(이미지 uv 기준)와 가로 프레임 수, 전체 프레임 수를 지정함.
+struct AtlasSource {
+    std::string name; // 보통 파일 이름 (findFrame() 으로 찾을 때 사용)
+    ofPixels pixels;
+    glm::vec2 frameSize = glm::vec2(1, 1);
+    int columns = 1;
+    int frameCount = 1;
+};
+
+class TextureAtlas {
+    public:
+        static const int DEFAULT_PAGE_SIZE = 2048;
+        static const int PADDING = 2;
+
+        // 소스 이미지들을 페이지에 배치함. 이전 내용은 지워짐.
+        void build(const std::vector<AtlasSource>& sources, int pageSize = DEFAULT_PAGE_SIZE);
+
+        // save() 는 디스크립터와 페이지 이미지들을 저장함. (경로는 ofToDataPath() 기준)
+        // load() 는 디스크립터만 읽으므로, 페이지 이미지는 getPagePath() 로 따로 로드해야 함. (assetLoader.h 에서 병렬로 로드할 수 있도록)
+        bool save(const std::string& descriptorPath) const;
+        bool load(const std::string& descriptorPath);
+        static std::string getPagePath(const std::string& descriptorPath, size_t page);
+
+        // 소스 이미지 이름으로 첫 번째 프레임 번호를 찾음. 없으면 -1
+        int findFrame(const std::string& name) const;
+        int getFrameCount(const std::string& name) const;
+
+        const AtlasFrame& getFrame(int frame) const { return frames[frame]; }
+        size_t getNumFrames() const { return frames.size(); }
+
+        // 페이지 이미지는 build() 한 경우에만 들어있음.
+        const std::vector<ofPixels>& getPages() const { return pages; }
+        size_t getNumPages() const { return pageSizes.size(); }
+        glm::ivec2 getPageSize(size_t page) const { return pageSizes[page]; }
+
+        // 페이지 전체 넓이 중에서 실제 이미지가 차지하는 비율 (0 ~ 1)
+        float getPackingEfficiency() const;
+
+    private:
+        struct SourceEntry {
+            int firstFrame;
+            int frameCount;
+        };
+
+        std::vector<ofPixels> pages;
+        std::vector<glm::ivec2> pageSizes;
+        std::vector<AtlasFrame> frames;
+        std::map<std::string, SourceEntry> sources;
+        size_t usedPixels = 0; // 패딩을 뺀 이미지 픽셀 수 (load() 한 경우에는 프레임 넓이의 합)
+};
+
+// 디스크립터 파일이 소스 이미지 파일들보다 먼저 만들어졌거나 없으면 true (다시 build() 해야 함)
+bool isAtlasStale(const std::string& descriptorPath, const std::vector<std::string>& sourcePaths);
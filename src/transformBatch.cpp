@@ -0,0 +1,198 @@
+#include "transformBatch.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TRANSFORM_BATCH_SSE 1
+#endif
+
+//--------------------------------------------------------------
+void TransformSoA::resize(size_t n) {
+    tx.resize(n, 0.0f); ty.resize(n, 0.0f); tz.resize(n, 0.0f);
+    rot.resize(n, 0.0f);
+    sx.resize(n, 1.0f); sy.resize(n, 1.0f); sz.resize(n, 1.0f);
+}
+
+void TransformSoA::set(size_t i, glm::vec3 trans, float rotation, glm::vec3 scale) {
+    tx[i] = trans.x; ty[i] = trans.y; tz[i] = trans.z;
+    rot[i] = rotation;
+    sx[i] = scale.x; sy[i] = scale.y; sz[i] = scale.z;
+}
+
+size_t TransformSoA::add(glm::vec3 trans, float rotation, glm::vec3 scale) {
+    size_t i = size();
+    resize(i + 1);
+    set(i, trans, rotation, scale);
+    return i;
+}
+
+//--------------------------------------------------------------
+/**
+ T * R * S 를 직접 전개하면 아래와 같은 열 우선 행렬이 나옴. (c = cos(rot), s = sin(rot))
+
+   | c*sx  -s*sy  0   tx |
+   | s*sx   c*sy  0   ty |
+   | 0      0     sz  tz |
+   | 0      0     0   1  |
+
+ glm::rotate() 도 z축 회전이면 cos, sin 값을 그대로 넣기 때문에 buildMatrix() 와 같은 값이 나옴.
+ (rotate() 내부의 c + (1 - c) 계산 때문에 [2][2] 성분만 최대 1ulp 정도 차이날 수 있음)
+ */
+glm::mat4 composeTRS(glm::vec3 trans, float rot, glm::vec3 scale) {
+    float c = std::cos(rot);
+    float s = std::sin(rot);
+
+    glm::mat4 m;
+    m[0] = glm::vec4(c * scale.x, s * scale.x, 0.0f, 0.0f);
+    m[1] = glm::vec4(-s * scale.y, c * scale.y, 0.0f, 0.0f);
+    m[2] = glm::vec4(0.0f, 0.0f, scale.z, 0.0f);
+    m[3] = glm::vec4(trans.x, trans.y, trans.z, 1.0f);
+    return m;
+}
+
+/**
+ (T * R * S)^-1 = S^-1 * R^T * T^-1 이므로,
+ 회전 부분은 전치(transpose)하고 각 행을 크기값으로 나눈 뒤,
+ 이동 부분은 그 3*3 행렬에 -trans 를 곱한 값이 됨.
+
+   |  c/sx   s/sx   0      -( c*tx + s*ty)/sx |
+   | -s/sy   c/sy   0      -(-s*tx + c*ty)/sy |
+   |  0      0      1/sz   -tz/sz             |
+   |  0      0      0       1                 |
+ */
+glm::mat4 inverseTRS(glm::vec3 trans, float rot, glm::vec3 scale) {
+    float c = std::cos(rot);
+    float s = std::sin(rot);
+    float isx = 1.0f / scale.x;
+    float isy = 1.0f / scale.y;
+    float isz = 1.0f / scale.z;
+
+    glm::mat4 m;
+    m[0] = glm::vec4(c * isx, -s * isy, 0.0f, 0.0f);
+    m[1] = glm::vec4(s * isx, c * isy, 0.0f, 0.0f);
+    m[2] = glm::vec4(0.0f, 0.0f, isz, 0.0f);
+    m[3] = glm::vec4(-(c * trans.x + s * trans.y) * isx, -(-s * trans.x + c * trans.y) * isy, -trans.z * isz, 1.0f);
+    return m;
+}
+
+//--------------------------------------------------------------
+void buildMatrices(const TransformSoA& in, glm::mat4* outModel, glm::mat4* outInverse) {
+    buildMatrices(in, 0, in.size(), outModel, outInverse);
+}
+
+// 출력 배열도 입력과 같은 인덱스 [first, first + count) 위치에 기록함.
+void buildMatrices(const TransformSoA& in, size_t first, size_t count, glm::mat4* outModel, glm::mat4* outInverse) {
+    size_t i = first;
+    size_t end = first + count;
+
+#ifdef TRANSFORM_BATCH_SSE
+    /**
+     오브젝트 4개를 SSE 레지스터 하나의 4개 레인에 나눠 담아서 계산함.
+
+     레지스터 하나에는 '4개 오브젝트의 같은 성분' 이 들어있으므로 (예: 4개 행렬의 [0][0] 성분),
+     _MM_TRANSPOSE4_PS 로 전치해서 '오브젝트 하나의 열(column) 하나' 로 바꾼 다음 저장함.
+
+     sin/cos 은 SSE 명령어가 따로 없어서 레인별로 std::cos/std::sin 을 호출함.
+     (buildMatrix() 와 결과를 똑같이 맞추기 위해서이기도 함)
+     */
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= end; i += 4) {
+        alignas(16) float cs[4];
+        alignas(16) float sn[4];
+        for (int k = 0; k < 4; ++k) {
+            cs[k] = std::cos(in.rot[i + k]);
+            sn[k] = std::sin(in.rot[i + k]);
+        }
+        __m128 c = _mm_load_ps(cs);
+        __m128 s = _mm_load_ps(sn);
+        __m128 tx = _mm_loadu_ps(&in.tx[i]);
+        __m128 ty = _mm_loadu_ps(&in.ty[i]);
+        __m128 tz = _mm_loadu_ps(&in.tz[i]);
+        __m128 sx = _mm_loadu_ps(&in.sx[i]);
+        __m128 sy = _mm_loadu_ps(&in.sy[i]);
+        __m128 sz = _mm_loadu_ps(&in.sz[i]);
+
+        if (outModel) {
+            // 각 변수 이름은 행렬 성분 위치를 뜻함. (m01 = 0번째 열의 1번째 행)
+            __m128 m00 = _mm_mul_ps(c, sx);
+            __m128 m01 = _mm_mul_ps(s, sx);
+            __m128 m10 = _mm_sub_ps(zero, _mm_mul_ps(s, sy));
+            __m128 m11 = _mm_mul_ps(c, sy);
+
+            __m128 col0a = m00, col0b = m01, col0c = zero, col0d = zero;
+            __m128 col1a = m10, col1b = m11, col1c = zero, col1d = zero;
+            __m128 col2a = zero, col2b = zero, col2c = sz, col2d = zero;
+            __m128 col3a = tx, col3b = ty, col3c = tz, col3d = one;
+            _MM_TRANSPOSE4_PS(col0a, col0b, col0c, col0d);
+            _MM_TRANSPOSE4_PS(col1a, col1b, col1c, col1d);
+            _MM_TRANSPOSE4_PS(col2a, col2b, col2c, col2d);
+            _MM_TRANSPOSE4_PS(col3a, col3b, col3c, col3d);
+
+            // 전치가 끝나면 colNa, colNb, colNc, colNd 가 각각 0~3번째 오브젝트의 N번째 열이 됨.
+            const __m128 cols[4][4] = {
+                { col0a, col1a, col2a, col3a },
+                { col0b, col1b, col2b, col3b },
+                { col0c, col1c, col2c, col3c },
+                { col0d, col1d, col2d, col3d },
+            };
+            for (int k = 0; k < 4; ++k) {
+                float* dst = &outModel[i + k][0][0];
+                _mm_storeu_ps(dst + 0, cols[k][0]);
+                _mm_storeu_ps(dst + 4, cols[k][1]);
+                _mm_storeu_ps(dst + 8, cols[k][2]);
+                _mm_storeu_ps(dst + 12, cols[k][3]);
+            }
+        }
+
+        if (outInverse) {
+            __m128 isx = _mm_div_ps(one, sx);
+            __m128 isy = _mm_div_ps(one, sy);
+            __m128 isz = _mm_div_ps(one, sz);
+
+            __m128 m00 = _mm_mul_ps(c, isx);
+            __m128 m01 = _mm_sub_ps(zero, _mm_mul_ps(s, isy));
+            __m128 m10 = _mm_mul_ps(s, isx);
+            __m128 m11 = _mm_mul_ps(c, isy);
+            __m128 m30 = _mm_sub_ps(zero, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(c, tx), _mm_mul_ps(s, ty)), isx));
+            __m128 m31 = _mm_sub_ps(zero, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(c, ty), _mm_mul_ps(s, tx)), isy));
+            __m128 m32 = _mm_sub_ps(zero, _mm_mul_ps(tz, isz));
+
+            __m128 col0a = m00, col0b = m01, col0c = zero, col0d = zero;
+            __m128 col1a = m10, col1b = m11, col1c = zero, col1d = zero;
+            __m128 col2a = zero, col2b = zero, col2c = isz, col2d = zero;
+            __m128 col3a = m30, col3b = m31, col3c = m32, col3d = one;
+            _MM_TRANSPOSE4_PS(col0a, col0b, col0c, col0d);
+            _MM_TRANSPOSE4_PS(col1a, col1b, col1c, col1d);
+            _MM_TRANSPOSE4_PS(col2a, col2b, col2c, col2d);
+            _MM_TRANSPOSE4_PS(col3a, col3b, col3c, col3d);
+
+            const __m128 cols[4][4] = {
+                { col0a, col1a, col2a, col3a },
+                { col0b, col1b, col2b, col3b },
+                { col0c, col1c, col2c, col3c },
+                { col0d, col1d, col2d, col3d },
+            };
+            for (int k = 0; k < 4; ++k) {
+                float* dst = &outInverse[i + k][0][0];
+                _mm_storeu_ps(dst + 0, cols[k][0]);
+                _mm_storeu_ps(dst + 4, cols[k][1]);
+                _mm_storeu_ps(dst + 8, cols[k][2]);
+                _mm_storeu_ps(dst + 12, cols[k][3]);
+            }
+        }
+    }
+#endif
+
+    // SSE 로 처리하고 남은 오브젝트들 (또는 SSE 가 없는 플랫폼의 전체 오브젝트) 은 스칼라 경로로 계산함.
+    for (; i < end; ++i) {
+        glm::vec3 trans(in.tx[i], in.ty[i], in.tz[i]);
+        glm::vec3 scale(in.sx[i], in.sy[i], in.sz[i]);
+        if (outModel) {
+            outModel[i] = composeTRS(trans, in.rot[i], scale);
+        }
+        if (outInverse) {
+            outInverse[i] = inverseTRS(trans, in.rot[i], scale);
+        }
+    }
+}
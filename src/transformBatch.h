@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ 수천 개의 스프라이트 변환행렬을 한꺼번에 계산하기 위한 배치 변환 커널.
+
+ ofApp.cpp 의 buildMatrix() 는 이동/회전/크기 행렬 3개를 만든 뒤 4*4 행렬곱을 두 번 하고,
+ buildViewMatrix() 는 거기에 범용 inverse() 까지 돌림.
+
+ 그런데 z축 회전만 하는 TRS 행렬은 곱셈 결과를 닫힌 형태(closed form)로 바로 쓸 수 있고,
+ 역행렬도 S^-1 * R^T * T^-1 로 바로 쓸 수 있으므로, 행렬곱과 inverse() 를 전부 생략할 수 있음.
+
+ 입력은 SoA(structure of arrays) 형태로 받아서, SSE 가 있으면 4개씩 묶어서 계산하고
+ 나머지(또는 SSE 가 없는 플랫폼)는 스칼라 경로로 계산함.
+ */
+
+// 변환 데이터를 성분별 배열로 저장하는 SoA 구조체. 인덱스 i 가 오브젝트 하나에 해당함.
+struct TransformSoA {
+    std::vector<float> tx, ty, tz; // 이동값
+    std::vector<float> rot; // z축 회전 각도 (라디안)
+    std::vector<float> sx, sy, sz; // 크기값
+
+    size_t size() const { return rot.size(); }
+    void resize(size_t n);
+    void set(size_t i, glm::vec3 trans, float rotation, glm::vec3 scale);
+    size_t add(glm::vec3 trans, float rotation, glm::vec3 scale); // 맨 뒤에 추가하고 인덱스를 리턴
+};
+
+// buildMatrix() 와 같은 결과(translation * rotation * scaler)를 행렬곱 없이 바로 계산함.
+glm::mat4 composeTRS(glm::vec3 trans, float rot, glm::vec3 scale);
+
+// inverse(buildMatrix()) 와 같은 결과를 범용 역행렬 계산 없이 바로 계산함. (크기값에 0 이 들어오면 안 됨)
+glm::mat4 inverseTRS(glm::vec3 trans, float rot, glm::vec3 scale);
+
+/**
+ in 에 담긴 모든 오브젝트의 모델행렬을 outModel 에, 역행렬(뷰행렬)을 outInverse 에 기록함.
+
+ 두 출력 배열은 in.size() 개 이상의 공간이 있어야 하고, 필요 없는 쪽은 nullptr 을 넘기면 계산을 건너뜀.
+ sin/cos 은 오브젝트 당 한 번만 계산해서 두 출력에서 같이 사용함.
+ */
+void buildMatrices(const TransformSoA& in, glm::mat4* outModel, glm::mat4* outInverse = nullptr);
+
+// [first, first + count) 범위만 계산하는 버전. (여러 스레드로 나눠서 돌리거나, 일부만 갱신할 때 사용)
+void buildMatrices(const TransformSoA& in, size_t first, size_t count, glm::mat4* outModel, glm::mat4* outInverse = nullptr);
@@ -0,0 +1,150 @@
+#include "transformHierarchy.h"
+#include <cassert>
+
+//--------------------------------------------------------------
+int TransformHierarchy::addNode(int parentNode, glm::vec3 pos, float rotation, glm::vec3 scale, glm::vec3 pivotOffset) {
+    int node = (int)size();
+    assert(parentNode == NO_PARENT || (parentNode >= 0 && parentNode < node)); // 부모는 항상 자식보다 앞에 있어야 함.
+
+    parent.push_back(parentNode);
+    lastDescendant.push_back(node);
+    for (int p = parentNode; p != NO_PARENT; p = parent[p]) {
+        lastDescendant[p] = node; // 새 노드가 가장 뒤에 있으므로 모든 조상의 마지막 자손이 됨.
+    }
+    position.push_back(pos);
+    pivot.push_back(pivotOffset);
+    local.add(pos, rotation, scale);
+    localMatrix.push_back(glm::mat4());
+    worldMatrix.push_back(glm::mat4());
+    dirty.push_back(0);
+    changedGeneration.push_back(0);
+
+    updateLocalTranslation(node);
+    markDirty(node);
+    return node;
+}
+
+//--------------------------------------------------------------
+void TransformHierarchy::setPosition(int node, glm::vec3 pos) {
+    if (position[node] == pos) {
+        return; // 값이 그대로면 dirty 표시를 하지 않음.
+    }
+    position[node] = pos;
+    updateLocalTranslation(node);
+    markDirty(node);
+}
+
+void TransformHierarchy::setRotation(int node, float rotation) {
+    if (local.rot[node] == rotation) {
+        return;
+    }
+    local.rot[node] = rotation;
+    updateLocalTranslation(node); // pivot 이 있으면 회전값에 따라 이동 보정값도 바뀜.
+    markDirty(node);
+}
+
+void TransformHierarchy::setScale(int node, glm::vec3 scale) {
+    if (getScale(node) == scale) {
+        return;
+    }
+    local.sx[node] = scale.x;
+    local.sy[node] = scale.y;
+    local.sz[node] = scale.z;
+    markDirty(node);
+}
+
+void TransformHierarchy::setPivot(int node, glm::vec3 pivotOffset) {
+    if (pivot[node] == pivotOffset) {
+        return;
+    }
+    pivot[node] = pivotOffset;
+    updateLocalTranslation(node);
+    markDirty(node);
+}
+
+//--------------------------------------------------------------
+/**
+ T(position) * T(pivot) * R * T(-pivot) * S 를 정리하면
+ T(position + pivot - R * pivot) * R * S 가 되므로,
+ 이동값만 미리 보정해두면 pivot 이 있어도 buildMatrix() 와 같은 TRS 형태로 계산할 수 있음.
+ */
+void TransformHierarchy::updateLocalTranslation(int node) {
+    glm::vec3 p = position[node];
+    glm::vec3 v = pivot[node];
+    if (v.x != 0.0f || v.y != 0.0f) {
+        float c = std::cos(local.rot[node]);
+        float s = std::sin(local.rot[node]);
+        p.x += v.x - (c * v.x - s * v.y);
+        p.y += v.y - (s * v.x + c * v.y);
+    }
+    local.tx[node] = p.x;
+    local.ty[node] = p.y;
+    local.tz[node] = p.z;
+}
+
+void TransformHierarchy::markDirty(int node) {
+    if (!dirty[node]) {
+        dirty[node] = 1;
+        dirtyNodes.push_back(node);
+    }
+}
+
+//--------------------------------------------------------------
+void TransformHierarchy::update() {
+    updatedNodes.clear();
+    lastVisitCount = 0; // 바뀐 노드가 없어서 바로 리턴해도 지난 update() 의 수가 남지 않도록 먼저 지움.
+    ++generation; // 바뀐 노드가 없어도 generation 을 올려야 wasUpdated() 가 지난 update() 결과를 리턴하지 않음.
+    if (dirtyNodes.empty()) {
+        return; // 바뀐 노드가 없으면 아무것도 하지 않음.
+    }
+
+    std::sort(dirtyNodes.begin(), dirtyNodes.end());
+
+    // 1. dirty 노드들의 로컬행렬 계산. 인덱스가 연속된 구간끼리 묶어서 buildMatrices() 에 한 번에 넘김.
+    size_t runStart = 0;
+    for (size_t i = 1; i <= dirtyNodes.size(); ++i) {
+        if (i == dirtyNodes.size() || dirtyNodes[i] != dirtyNodes[i - 1] + 1) {
+            size_t first = dirtyNodes[runStart];
+            size_t count = i - runStart;
+            buildMatrices(local, first, count, localMatrix.data());
+            runStart = i;
+        }
+    }
+
+    /**
+     2. 월드행렬 계산.
+
+     부모가 항상 자식보다 앞에 있으므로, dirty 노드부터 그 노드의 마지막 자손까지만 앞에서부터 훑으면 됨.
+     dirty 노드들을 인덱스 순으로 보면서, 앞의 dirty 노드의 구간에 이미 들어있던 dirty 노드는 건너뜀.
+
+     구간 안에는 (노드를 추가한 순서에 따라) 자손이 아닌 노드가 섞여 있을 수 있으므로,
+     자기 자신이 dirty 이거나, 부모의 월드행렬이 이번 update() 에서 바뀐 노드만 다시 계산하고,
+     다시 계산한 노드의 자손이 구간 밖에 있으면 구간을 그만큼 늘림.
+     '이번 update() 에서 바뀌었다' 는 표시를 매번 지우지 않아도 되도록 generation 값을 비교해서 판단함.
+     */
+    size_t next = 0; // 아직 훑지 않은 dirty 노드
+    while (next < dirtyNodes.size()) {
+        int i = dirtyNodes[next];
+        int last = lastDescendant[i];
+        for (; i <= last; ++i) {
+            int p = parent[i];
+            bool parentChanged = p != NO_PARENT && changedGeneration[p] == generation;
+            if (!dirty[i] && !parentChanged) {
+                continue;
+            }
+
+            worldMatrix[i] = (p == NO_PARENT) ? localMatrix[i] : worldMatrix[p] * localMatrix[i];
+            changedGeneration[i] = generation;
+            dirty[i] = 0;
+            last = std::max(last, lastDescendant[i]);
+            updatedNodes.push_back(i);
+        }
+        lastVisitCount += i - dirtyNodes[next];
+
+        while (next < dirtyNodes.size() && dirtyNodes[next] < i) {
+            ++next;
+        }
+    }
+
+    dirtyNodes.clear();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ofMain.h"
+#include "transformBatch.h"
+
+/**
+ 부모/자식 관계를 갖는 변환 노드들을 관리하는 계층 구조 (씬 그래프).
+
+ - 노드들은 포인터로 연결된 트리가 아니라 배열 하나에 평평하게 저장되고,
+   부모 노드는 항상 자식 노드보다 앞 인덱스에 있음. (위상 정렬 순서)
+   그래서 앞에서부터 한 번만 훑으면 부모의 월드행렬이 항상 자식보다 먼저 계산됨.
+
+ - 로컬 변환값(이동, 회전, 크기)이 바뀐 노드에만 dirty 표시를 하고,
+   update() 에서는 dirty 노드와 그 자손들의 행렬만 다시 계산함.
+   배경이나 태양처럼 움직이지 않는 노드는 처음 한 번 계산한 뒤로는 비용이 들지 않음.
+
+ - 노드마다 자손 중 가장 뒤에 있는 인덱스를 기록해둬서, dirty 노드의 자손들이 있는 구간 [node, lastDescendant] 만 훑음.
+   그래서 update() 비용은 전체 노드 수가 아니라 dirty 노드들의 서브트리 크기에 비례함.
+
+ - 로컬행렬은 buildMatrix() 와 같은 결과를 내는 transformBatch.h 의 buildMatrices() 로 계산함.
+
+ 로컬행렬 = T(position) * T(pivot) * R * T(-pivot) * S
+ 즉, pivot 은 position 을 기준으로 회전 중심을 얼마나 떨어뜨릴지를 나타냄. (pivot 이 0 이면 buildMatrix() 와 같음)
+ */
+class TransformHierarchy {
+    public:
+        static const int NO_PARENT = -1;
+
+        // parent 는 NO_PARENT 이거나 이미 추가된 노드여야 함. 추가된 노드의 인덱스를 리턴함.
+        int addNode(int parent, glm::vec3 position, float rotation = 0.0f, glm::vec3 scale = glm::vec3(1, 1, 1), glm::vec3 pivot = glm::vec3(0, 0, 0));
+
+        void setPosition(int node, glm::vec3 position);
+        void setRotation(int node, float rotation);
+        void setScale(int node, glm::vec3 scale);
+        void setPivot(int node, glm::vec3 pivot);
+
+        glm::vec3 getPosition(int node) const { return position[node]; }
+        float getRotation(int node) const { return local.rot[node]; }
+        glm::vec3 getScale(int node) const { return glm::vec3(local.sx[node], local.sy[node], local.sz[node]); }
+        glm::vec3 getPivot(int node) const { return pivot[node]; }
+        int getParent(int node) const { return parent[node]; }
+
+        // dirty 노드들과 그 자손들의 로컬행렬, 월드행렬을 다시 계산함.
+        void update();
+
+        const glm::mat4& getLocalMatrix(int node) const { return localMatrix[node]; }
+        const glm::mat4& getWorldMatrix(int node) const { return worldMatrix[node]; }
+
+        // 마지막 update() 에서 월드행렬이 다시 계산된 노드이면 true (월드행렬에 의존하는 바운딩 박스 등을 갱신할 때 사용)
+        bool wasUpdated(int node) const { return changedGeneration[node] == generation; }
+
+        // 마지막 update() 에서 월드행렬이 다시 계산된 노드들 (인덱스 순). 바뀐 노드에 딸린 것만 갱신할 때 전체 노드를 훑지 않도록 사용함.
+        const std::vector<int>& getUpdatedNodes() const { return updatedNodes; }
+
+        size_t size() const { return parent.size(); }
+        size_t getLastUpdateCount() const { return updatedNodes.size(); } // 지난 update() 에서 월드행렬을 다시 계산한 노드 수
+        size_t getLastVisitCount() const { return lastVisitCount; } // 지난 update() 에서 훑어본 노드 수 (다시 계산하지 않은 노드 포함)
+
+    private:
+        void markDirty(int node);
+        void updateLocalTranslation(int node);
+
+        std::vector<int> parent;
+        std::vector<int> lastDescendant; // 자손 중 가장 뒤에 있는 노드 인덱스 (자손이 없으면 자기 자신). 자손은 모두 [node, lastDescendant] 안에 있음
+        std::vector<glm::vec3> position;
+        std::vector<glm::vec3> pivot;
+
+        // buildMatrices() 에 그대로 넘길 수 있도록 로컬 변환값을 SoA 로 저장함.
+        // 이동값에는 position 에 pivot 보정까지 더한 값이 들어있음. (updateLocalTranslation() 참고)
+        TransformSoA local;
+
+        std::vector<glm::mat4> localMatrix;
+        std::vector<glm::mat4> worldMatrix;
+
+        std::vector<uint8_t> dirty; // 로컬 변환값이 바뀌어서 로컬행렬을 다시 계산해야 하는 노드
+        std::vector<int> dirtyNodes; // dirty 노드 인덱스 목록
+        std::vector<uint32_t> changedGeneration; // 이번 update() 에서 월드행렬이 바뀐 노드는 generation 값이 기록됨
+        uint32_t generation = 0;
+
+        std::vector<int> updatedNodes;
+        size_t lastVisitCount = 0;
+};
@@ -0,0 +1,99 @@
+#include "uniformCache.h"
+
+//--------------------------------------------------------------
+void CameraUniformBuffer::setup() {
+    buffer.allocate(sizeof(CameraBlock), GL_DYNAMIC_DRAW);
+    buffer.bindBase(GL_UNIFORM_BUFFER, BINDING);
+    valid = false;
+}
+
+void CameraUniformBuffer::attach(ofShader& shader) const {
+    shader.bindUniformBlock(BINDING, "Camera");
+}
+
+bool CameraUniformBuffer::update(const glm::mat4& view, const glm::mat4& proj, UniformStats& stats) {
+    if (valid && current.view == view && current.proj == proj) {
+        stats.skipped++;
+        return false;
+    }
+    current.view = view;
+    current.proj = proj;
+    current.viewProj = proj * view;
+    buffer.updateData(0, sizeof(CameraBlock), &current);
+    valid = true;
+    stats.uploads++;
+    return true;
+}
+
+//--------------------------------------------------------------
+void UniformCache::setup(ofShader& shader, const std::vector<std::string>& names) {
+    slots.clear();
+    for (const std::string& name : names) {
+        Slot slot;
+        slot.location = shader.getUniformLocation(name);
+        if (slot.location < 0) {
+            ofLogWarning("UniformCache") << "setup(): uniform " << name << " not found (unused uniforms are removed by the shader compiler)";
+        }
+        slots.push_back(slot);
+    }
+}
+
+bool UniformCache::changed(int slot, const float* value, int size) {
+    Slot& s = slots[slot];
+    if (s.size == size && memcmp(s.value, value, size * sizeof(float)) == 0) {
+        return false;
+    }
+    memcpy(s.value, value, size * sizeof(float));
+    s.size = size;
+    return true;
+}
+
+void UniformCache::set(int slot, int value, UniformStats& stats) {
+    float bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (slots[slot].location < 0) {
+        return;
+    }
+    if (!changed(slot, &bits, 1)) {
+        stats.skipped++;
+        return;
+    }
+    glUniform1i(slots[slot].location, value);
+    stats.uploads++;
+}
+
+void UniformCache::set(int slot, float value, UniformStats& stats) {
+    if (slots[slot].location < 0) {
+        return;
+    }
+    if (!changed(slot, &value, 1)) {
+        stats.skipped++;
+        return;
+    }
+    glUniform1f(slots[slot].location, value);
+    stats.uploads++;
+}
+
+void UniformCache::set(int slot, const glm::vec4& value, UniformStats& stats) {
+    if (slots[slot].location < 0) {
+        return;
+    }
+    if (!changed(slot, &value[0], 4)) {
+        stats.skipped++;
+        return;
+    }
+    glUniform4fv(slots[slot].location, 1, &value[0]);
+    stats.uploads++;
+}
+
+void UniformCache::set(int slot, const glm::mat4& value, UniformStats& stats) {
+    if (slots[slot].location < 0) {
+        return;
+    }
+    if (!changed(slot, &value[0][0], 16)) {
+        stats.skipped++;
+        return;
+    }
+    glUniformMatrix4fv(slots[slot].location, 1, GL_FALSE, &value[0][0]);
+    stats.uploads++;
+}
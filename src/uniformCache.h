@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ 유니폼 변수 전송 횟수를 줄이기 위한 도구들.
+
+ 1. CameraUniformBuffer: 모든 셰이더가 똑같이 쓰는 뷰행렬, 투영행렬을 std140 레이아웃의 유니폼 버퍼(UBO) 하나에 넣어두고,
+    각 셰이더의 'Camera' 유니폼 블록을 같은 바인딩 포인트에 연결함. 셰이더를 바꿀 때마다 행렬을 다시 보낼 필요가 없고,
+    카메라가 그대로면 버퍼 업로드도 건너뜀.
+ 2. UniformCache: 셰이더 하나의 유니폼 location 을 등록할 때 한 번만 찾아두고, 마지막으로 보낸 값을 기억해서
+    같은 값을 다시 보내는 호출은 건너뜀. (setUniform*() 처럼 매번 이름 문자열로 location 을 찾지 않음)
+
+ 둘 다 건너뛴 호출 수를 UniformStats 에 세어두므로, 무거운 장면에서 드라이버 호출이 얼마나 줄었는지 확인할 수 있음.
+ */
+
+struct UniformStats {
+    int uploads = 0; // 실제로 GL 에 보낸 유니폼 값 / 유니폼 버퍼 업로드 수
+    int skipped = 0; // 마지막으로 보낸 값과 같아서 실제로 건너뛴 호출 수 (셰이더에 없는 유니폼은 세지 않음)
+
+    void reset() { *this = UniformStats(); }
+};
+
+// 셰이더의 'layout(std140) uniform Camera' 블록과 같은 메모리 레이아웃. (mat4 는 std140 에서도 vec4 열 4개라서 패딩이 없음)
+struct CameraBlock {
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::mat4 viewProj; // 버텍스마다 proj * view 를 곱하지 않도록 미리 곱해서 넣어둠.
+};
+
+class CameraUniformBuffer {
+    public:
+        static const int BINDING = 0; // 유니폼 버퍼 바인딩 포인트
+
+        void setup();
+
+        // 셰이더의 Camera 블록을 BINDING 에 연결함. (셰이더를 로드한 뒤 한 번만 호출)
+        void attach(ofShader& shader) const;
+
+        // 값이 바뀌었을 때만 버퍼를 업로드함. 업로드했으면 true
+        bool update(const glm::mat4& view, const glm::mat4& proj, UniformStats& stats);
+
+    private:
+        ofBufferObject buffer;
+        CameraBlock current;
+        bool valid = false;
+};
+
+class UniformCache {
+    public:
+        // 셰이더와 사용할 유니폼 이름들을 등록하고 location 을 미리 찾아둠. 등록한 순서대로 0, 1, 2, ... 의 슬롯 번호가 됨.
+        void setup(ofShader& shader, const std::vector<std::string>& names);
+
+        // 슬롯 번호로 유니폼 값을 보냄. 셰이더가 바인딩된 상태에서 호출해야 하고, 마지막으로 보낸 값과 같으면 건너뜀.
+        void set(int slot, int value, UniformStats& stats);
+        void set(int slot, float value, UniformStats& stats);
+        void set(int slot, const glm::vec4& value, UniformStats& stats);
+        void set(int slot, const glm::mat4& value, UniformStats& stats);
+
+        int getLocation(int slot) const { return slots[slot].location; }
+
+    private:
+        struct Slot {
+            int location;
+            float value[16]; // 마지막으로 보낸 값 (int 도 비트 그대로 저장)
+            int size = 0; // 0 이면 아직 보낸 적 없음
+        };
+
+        // 값이 같으면 false, 다르면 값을 기록하고 true
+        bool changed(int slot, const float* value, int size);
+
+        std::vector<Slot> slots;
+};
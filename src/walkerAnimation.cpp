@@ -0,0 +1,162 @@
+#include "walkerAnimation.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WALKER_ANIMATION_SSE 1
+#endif
+
+//--------------------------------------------------------------
+void WalkerSoA::resize(size_t n) {
+    posX.resize(n, 0.0f); posY.resize(n, 0.0f);
+    velX.resize(n, 0.0f); velY.resize(n, 0.0f);
+    clock.resize(n, 0.0f);
+    frame.resize(n, 0);
+}
+
+size_t WalkerSoA::add(glm::vec2 pos, glm::vec2 vel, float clockOffset) {
+    size_t i = size();
+    resize(i + 1);
+    posX[i] = pos.x; posY[i] = pos.y;
+    velX[i] = vel.x; velY[i] = vel.y;
+    clock[i] = clockOffset;
+    return i;
+}
+
+//--------------------------------------------------------------
+void WalkerAnimation::setup(const std::vector<AtlasFrame>& animFrames, float fps, glm::vec2 minBounds, glm::vec2 maxBounds, float walkerScale, float walkerZ) {
+    frames = animFrames;
+    framesPerSecond = fps;
+    cycleSeconds = frames.empty() ? 1.0f : frames.size() / fps;
+    boundsMin = minBounds;
+    boundsMax = maxBounds;
+    scale = walkerScale;
+    z = walkerZ;
+}
+
+void WalkerAnimation::update(float dt, SpriteInstance* out, int numThreads) {
+    size_t n = walkers.size();
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t numChunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (numThreads == 1 || numChunks <= 1) {
+        update(dt, 0, n, out);
+        return;
+    }
+
+    // 스레드들이 아직 아무도 안 가져간 구간을 하나씩 가져가서 처리함. (softwareRasterizer.cpp 의 타일 분배와 같은 방식)
+    pool.parallelFor(numChunks, numThreads, [&](size_t chunk) {
+        size_t first = chunk * CHUNK_SIZE;
+        update(dt, first, std::min(CHUNK_SIZE, n - first), out);
+    });
+}
+
+/**
+ 워커 하나의 SpriteInstance 를 채움.
+
+ 워커는 회전하지 않으므로 모델행렬은 translate(pos) * scale(s) 이고, composeTRS() 에서 회전을 뺀 형태로 바로 씀.
+
+   | s  0  0  x |
+   | 0  s  0  y |
+   | 0  0  1  z |
+   | 0  0  0  1 |
+ */
+static inline void writeInstance(SpriteInstance& inst, float x, float y, float z, float s, const AtlasFrame& frame) {
+    float* m = &inst.model[0][0];
+    m[0] = s;    m[1] = 0.0f; m[2] = 0.0f;  m[3] = 0.0f;
+    m[4] = 0.0f; m[5] = s;    m[6] = 0.0f;  m[7] = 0.0f;
+    m[8] = 0.0f; m[9] = 0.0f; m[10] = 1.0f; m[11] = 0.0f;
+    m[12] = x;   m[13] = y;   m[14] = z;    m[15] = 1.0f;
+    inst.uvRect = frame.uvRect;
+    inst.layer = (float)frame.page;
+}
+
+// 출력 배열도 입력과 같은 인덱스 [first, first + count) 위치에 기록함.
+void WalkerAnimation::update(float dt, size_t first, size_t count, SpriteInstance* out) {
+    if (frames.empty()) {
+        return;
+    }
+    size_t i = first;
+    size_t end = first + count;
+
+    float* posX = walkers.posX.data();
+    float* posY = walkers.posY.data();
+    const float* velX = walkers.velX.data();
+    const float* velY = walkers.velY.data();
+    float* clock = walkers.clock.data();
+    int32_t* frame = walkers.frame.data();
+
+    glm::vec2 size = boundsMax - boundsMin;
+    float lastFrame = (float)(frames.size() - 1);
+    float invCycle = 1.0f / cycleSeconds;
+
+#ifdef WALKER_ANIMATION_SSE
+    /**
+     워커 4개를 SSE 레지스터 하나의 4개 레인에 나눠 담아서 계산함.
+
+     범위를 벗어났는지, 사이클이 끝났는지는 분기 대신 비교 마스크로 처리함.
+     (비교 결과가 참인 레인만 모든 비트가 1 이므로, 마스크와 and 한 값을 더하거나 빼면 해당 레인만 되돌아감)
+     애니메이션 시간은 dt 가 한 사이클보다 길어도 되도록 clock - trunc(clock / cycle) * cycle 로 되돌림. (clock 은 항상 0 이상)
+     */
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 minX = _mm_set1_ps(boundsMin.x);
+    const __m128 minY = _mm_set1_ps(boundsMin.y);
+    const __m128 maxX = _mm_set1_ps(boundsMax.x);
+    const __m128 maxY = _mm_set1_ps(boundsMax.y);
+    const __m128 sizeX = _mm_set1_ps(size.x);
+    const __m128 sizeY = _mm_set1_ps(size.y);
+    const __m128 cycle = _mm_set1_ps(cycleSeconds);
+    const __m128 vinvCycle = _mm_set1_ps(invCycle);
+    const __m128 fps = _mm_set1_ps(framesPerSecond);
+    const __m128 vlastFrame = _mm_set1_ps(lastFrame);
+
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(_mm_loadu_ps(velX + i), vdt));
+        __m128 y = _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(_mm_loadu_ps(velY + i), vdt));
+        x = _mm_sub_ps(x, _mm_and_ps(_mm_cmpgt_ps(x, maxX), sizeX));
+        x = _mm_add_ps(x, _mm_and_ps(_mm_cmplt_ps(x, minX), sizeX));
+        y = _mm_sub_ps(y, _mm_and_ps(_mm_cmpgt_ps(y, maxY), sizeY));
+        y = _mm_add_ps(y, _mm_and_ps(_mm_cmplt_ps(y, minY), sizeY));
+
+        __m128 c = _mm_add_ps(_mm_loadu_ps(clock + i), vdt);
+        __m128 cycles = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(c, vinvCycle)));
+        c = _mm_sub_ps(c, _mm_mul_ps(cycles, cycle));
+
+        // 부동소수점 오차로 clock * fps 가 프레임 수와 같아지는 경우가 있으므로, 정수로 바꾸기 전에 마지막 프레임으로 잘라줌.
+        __m128i f = _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(c, fps), vlastFrame));
+
+        _mm_storeu_ps(posX + i, x);
+        _mm_storeu_ps(posY + i, y);
+        _mm_storeu_ps(clock + i, c);
+        _mm_storeu_si128((__m128i*)(frame + i), f);
+
+        if (out) {
+            for (size_t k = i; k < i + 4; ++k) {
+                writeInstance(out[k], posX[k], posY[k], z, scale, frames[frame[k]]);
+            }
+        }
+    }
+#endif
+
+    // SSE 로 처리하고 남은 워커들 (또는 SSE 가 없는 플랫폼의 전체 워커) 은 스칼라 경로로 계산함. (계산 순서는 SSE 경로와 같음)
+    for (; i < end; ++i) {
+        float x = posX[i] + velX[i] * dt;
+        float y = posY[i] + velY[i] * dt;
+        if (x > boundsMax.x) x -= size.x;
+        if (x < boundsMin.x) x += size.x;
+        if (y > boundsMax.y) y -= size.y;
+        if (y < boundsMin.y) y += size.y;
+
+        float c = clock[i] + dt;
+        c -= (float)(int32_t)(c * invCycle) * cycleSeconds;
+
+        posX[i] = x;
+        posY[i] = y;
+        clock[i] = c;
+        frame[i] = (int32_t)std::min(c * framesPerSecond, lastFrame);
+
+        if (out) {
+            writeInstance(out[i], x, y, z, scale, frames[frame[i]]);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ofMain.h"
+#include "spriteBatch.h"
+#include "textureAtlas.h"
+#include "workerPool.h"
+
+/**
+ 수많은 걷는 캐릭터(워커)를 한꺼번에 움직이고 애니메이션시키기 위한 데이터 지향(ECS 스타일) 애니메이션 시스템.
+
+ 캐릭터 하나는 draw() 에서 프레임 번호를 올리고 update() 에서 charPos 를 옮기는 식으로 처리했는데,
+ 이 방식은 캐릭터 수만큼 객체와 분기가 늘어나서 수천, 수만 개로 늘릴 수가 없음.
+
+ 여기서는 위치, 속도, 애니메이션 시간, 프레임 번호를 성분별 배열(SoA)에 연속으로 저장하고,
+ update() 한 번으로 모든 워커를 진행시킨 뒤 바로 SpriteBatch 에 넘길 인스턴스 데이터(모델행렬, 아틀라스 uv 영역)를 채움.
+
+ - 위치, 시간 갱신과 프레임 번호 계산은 SSE 가 있으면 4개씩 묶어서 계산함. (transformBatch.cpp 와 같은 방식)
+ - 워커 배열을 구간으로 나눠서 여러 스레드가 나눠 처리할 수 있음. (워커끼리는 서로 영향을 주지 않으므로 동기화가 필요 없음)
+   스레드는 프레임마다 만들지 않고 WorkerPool 에 만들어둔 스레드를 계속 사용함.
+ - 화면 범위(bounds)를 벗어난 워커는 반대편으로 넘어가서 계속 걸어감.
+ */
+
+// 워커 데이터를 성분별 배열로 저장하는 SoA 구조체. 인덱스 i 가 워커 하나에 해당함.
+struct WalkerSoA {
+    std::vector<float> posX, posY; // 월드 공간 위치
+    std::vector<float> velX, velY; // 초당 이동 거리
+    std::vector<float> clock; // 걷기 애니메이션 시간(초). 한 사이클이 지나면 0 부터 다시 시작함.
+    std::vector<int32_t> frame; // 현재 걷기 프레임 번호 (0 ~ 프레임 수 - 1, update() 에서 clock 으로 계산함)
+
+    size_t size() const { return posX.size(); }
+    void resize(size_t n);
+    size_t add(glm::vec2 pos, glm::vec2 vel, float clockOffset = 0.0f); // 맨 뒤에 추가하고 인덱스를 리턴
+};
+
+class WalkerAnimation {
+    public:
+        // 한 스레드가 한 번에 가져가는 워커 수 (SSE 4개 단위의 배수)
+        static const size_t CHUNK_SIZE = 4096;
+
+        /**
+         걷기 애니메이션 프레임들과 워커가 돌아다닐 범위를 지정함.
+
+         frames 는 같은 스프라이트시트의 프레임들이어야 함. (아틀라스는 이미지 하나를 한 페이지에 통째로 넣으므로 페이지가 모두 같음)
+         scale 은 캐릭터 메쉬에 곱할 크기, z 는 워커들을 그릴 깊이값.
+         */
+        void setup(const std::vector<AtlasFrame>& frames, float framesPerSecond, glm::vec2 boundsMin, glm::vec2 boundsMax, float scale = 1.0f, float z = 0.0f);
+
+        WalkerSoA& getWalkers() { return walkers; }
+        const WalkerSoA& getWalkers() const { return walkers; }
+
+        /**
+         모든 워커를 dt 초만큼 진행하고, out 이 nullptr 이 아니면 워커마다 SpriteInstance 를 하나씩 채움. (out 은 워커 수 이상의 공간이 있어야 함)
+         numThreads 가 0 이면 하드웨어 스레드 개수만큼 사용함.
+         */
+        void update(float dt, SpriteInstance* out = nullptr, int numThreads = 1);
+
+        // [first, first + count) 범위만 진행하는 버전. (update() 가 스레드마다 구간을 나눠서 호출함)
+        void update(float dt, size_t first, size_t count, SpriteInstance* out);
+
+        int getPage() const { return frames.empty() ? 0 : frames[0].page; }
+        float getCycleSeconds() const { return cycleSeconds; }
+
+    private:
+        WalkerSoA walkers;
+        std::vector<AtlasFrame> frames;
+        float framesPerSecond = 12.0f;
+        float cycleSeconds = 1.0f; // 프레임 수 / framesPerSecond
+        glm::vec2 boundsMin = glm::vec2(-1, -1);
+        glm::vec2 boundsMax = glm::vec2(1, 1);
+        float scale = 1.0f;
+        float z = 0.0f;
+        WorkerPool pool;
+};
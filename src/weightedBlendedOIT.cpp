@@ -0,0 +1,83 @@
+#include "weightedBlendedOIT.h"
+
+//--------------------------------------------------------------
+bool WeightedBlendedOIT::setup(int width, int height) {
+    GLint major = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    if (major < 4) {
+        ofLogNotice("WeightedBlendedOIT") << "setup(): GL " << major << ".x has no glBlendFunci, order independent transparency disabled";
+        available = false;
+        return false;
+    }
+
+    if (!compositeShader.load("oitComposite.vert", "oitComposite.frag")) {
+        available = false;
+        return false;
+    }
+
+    // 화면 전체를 덮는 쿼드. 위치를 NDC 좌표 그대로 사용함. (oitComposite.vert)
+    ofMesh quad;
+    quad.addVertex(glm::vec3(-1, -1, 0));
+    quad.addVertex(glm::vec3(-1, 1, 0));
+    quad.addVertex(glm::vec3(1, 1, 0));
+    quad.addVertex(glm::vec3(1, -1, 0));
+    ofIndexType indices[6] = {0, 1, 2, 2, 3, 0};
+    quad.addIndices(indices, 6);
+    fullscreenQuad.setMesh(quad, GL_STATIC_DRAW);
+
+    available = true;
+    resize(width, height);
+    return true;
+}
+
+void WeightedBlendedOIT::resize(int width, int height) {
+    if (!available || width <= 0 || height <= 0) {
+        return;
+    }
+    ofFbo::Settings settings;
+    settings.width = width;
+    settings.height = height;
+    settings.colorFormats = { GL_RGBA16F, GL_R16F }; // accum 은 가중치 때문에 1 을 훨씬 넘으므로 부동소수점 버퍼를 사용함.
+    settings.useDepth = false; // 반투명 패스는 깊이테스트를 하지 않음. (SpriteRenderer::applyPass())
+    settings.textureTarget = GL_TEXTURE_2D;
+    settings.minFilter = GL_NEAREST;
+    settings.maxFilter = GL_NEAREST;
+    fbo.allocate(settings);
+}
+
+//--------------------------------------------------------------
+void WeightedBlendedOIT::begin() {
+    if (!available) {
+        return;
+    }
+    // 오픈프레임웍스 행렬은 사용하지 않으므로 (카메라 행렬은 유니폼 버퍼로 보냄) 기본 행렬 설정 없이 바인딩만 함.
+    fbo.begin(OF_FBOMODE_NODEFAULTS);
+    fbo.activateAllDrawBuffers();
+
+    const GLfloat zero[4] = { 0, 0, 0, 0 };
+    const GLfloat one[4] = { 1, 1, 1, 1 };
+    glClearBufferfv(GL_COLOR, 0, zero); // 누적 색상 0 에서 시작
+    glClearBufferfv(GL_COLOR, 1, one); // 아무것도 안 그렸으면 뒤가 100% 비쳐 보임
+
+    glEnable(GL_BLEND);
+    glBlendFunci(0, GL_ONE, GL_ONE);
+    glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+    active = true;
+}
+
+void WeightedBlendedOIT::resolve() {
+    if (!active) {
+        return;
+    }
+    fbo.end();
+    active = false;
+
+    // (1 - revealage) 를 알파로 출력하므로 일반 알파 블렌딩으로 화면 위에 덮으면 됨.
+    ofDisableDepthTest();
+    ofEnableBlendMode(ofBlendMode::OF_BLENDMODE_ALPHA);
+    compositeShader.begin();
+    compositeShader.setUniformTexture("accumTex", fbo.getTexture(0), 0);
+    compositeShader.setUniformTexture("revealTex", fbo.getTexture(1), 1);
+    fullscreenQuad.drawElements(GL_TRIANGLES, fullscreenQuad.getNumIndices());
+    compositeShader.end();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ 반투명 스프라이트를 그리는 순서와 상관없이 블렌딩하는 weighted blended OIT (order independent transparency).
+
+ OF_BLENDMODE_ALPHA 블렌딩은 (src * a + dst * (1 - a)) 를 차례로 누적하므로 그리는 순서가 바뀌면 결과도 바뀜.
+ 그래서 반투명 스프라이트가 많이 겹치면 매 프레임 먼 것부터 정렬해서 그려야 함. (spriteBatch.h 의 TRANSPARENT_BACK_TO_FRONT)
+
+ weighted blended OIT 는 정렬 대신 두 개의 버퍼에 순서와 상관없는 연산(덧셈, 곱셈)으로만 누적해두고,
+ 마지막에 한 번 합성(resolve)해서 화면에 덮어씀.
+   - accum (RGBA16F): 프래그먼트마다 (rgb * a, a) * 가중치 를 더함. (glBlendFunci(0, GL_ONE, GL_ONE))
+   - revealage (R16F): 프래그먼트마다 (1 - a) 를 곱함. 뒤가 얼마나 비쳐 보이는지. (glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR))
+   - resolve: 평균 색상 accum.rgb / accum.a 를 (1 - revealage) 의 불투명도로 화면에 알파 블렌딩함.
+ 가중치는 가까운(gl_FragCoord.z 가 작은) 프래그먼트일수록 크게 줘서 앞쪽 색이 더 많이 보이도록 함. (cloudOIT.frag)
+
+ 정확한 정렬 결과와 완전히 같지는 않지만 (많이 겹치면 색이 평균에 가까워짐), 구름처럼 부드러운 반투명 스프라이트에서는 차이가 거의 없음.
+ 버퍼 2개에 동시에 쓰고 (MRT) 버퍼마다 블렌드 함수를 따로 지정해야 하므로 GL 4.0 의 glBlendFunci() 가 필요함.
+ */
+class WeightedBlendedOIT {
+    public:
+        // 화면 크기만큼 버퍼를 만들고 합성 셰이더를 로드함. GL 컨텍스트가 만들어진 뒤 호출해야 함.
+        bool setup(int width, int height);
+        void resize(int width, int height);
+        bool isAvailable() const { return available; }
+
+        // 누적 버퍼를 바인딩하고 초기화한 뒤, 버퍼별 블렌드 함수를 설정함. 이후 반투명 스프라이트를 OIT 셰이더로 그림.
+        void begin();
+
+        // 누적 버퍼 바인딩을 풀고, 누적한 결과를 현재 프레임버퍼에 합성함.
+        void resolve();
+
+    private:
+        ofFbo fbo; // 0 번 = accum, 1 번 = revealage
+        ofShader compositeShader;
+        ofVbo fullscreenQuad;
+        bool available = false;
+        bool active = false;
+};
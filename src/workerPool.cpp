@@ -0,0 +1,73 @@
+#include "workerPool.h"
+
+//--------------------------------------------------------------
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::parallelFor(size_t count, int numThreads, const std::function<void(size_t)>& fn) {
+    size_t helpers = std::min((size_t)std::max(numThreads, 1), count);
+    helpers = helpers > 0 ? helpers - 1 : 0;
+    if (helpers == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    // 스레드 수를 늘려서 부르면 그만큼만 더 만듦. 줄여서 부르면 남는 워커는 참여하지 않고 계속 기다림.
+    while (workers.size() < helpers) {
+        workers.emplace_back(&WorkerPool::workerLoop, this, workers.size());
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &fn;
+        taskCount = count;
+        nextTask = 0;
+        participants = helpers;
+        busy = helpers;
+        generation++;
+    }
+    wake.notify_all();
+
+    runTasks(); // 현재 스레드도 같이 일함.
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return busy == 0; });
+    task = nullptr;
+}
+
+void WorkerPool::runTasks() {
+    for (size_t i = nextTask++; i < taskCount; i = nextTask++) {
+        (*task)(i);
+    }
+}
+
+void WorkerPool::workerLoop(size_t index) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        if (index >= participants) {
+            continue;
+        }
+
+        lock.unlock();
+        runTasks();
+        lock.lock();
+        if (--busy == 0) {
+            done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ 매 프레임 같은 일을 여러 스레드로 나눠서 처리하기 위한, 계속 살아있는 워커 스레드 풀.
+
+ 워커 애니메이션, 소프트웨어 래스터라이저는 프레임마다 스레드를 만들고 join() 했는데,
+ 스레드 생성, 종료 비용(수십 us)이 워커 수천 개 갱신하는 시간과 비슷해서 스레드를 늘려도 빨라지지 않았음.
+ 여기서는 스레드를 처음 필요할 때 한 번만 만들어두고, 일이 없을 때는 조건 변수에서 기다리게 함.
+
+ parallelFor() 는 작업 번호 0 ~ count - 1 을 atomic 카운터로 하나씩 나눠주고 (먼저 끝난 스레드가 다음 번호를 가져감),
+ 호출한 스레드도 같이 일한 뒤 모든 작업이 끝나야 리턴함.
+ 한 풀은 한 스레드에서만 parallelFor() 를 호출해야 함. (쓰는 곳마다 풀을 하나씩 가지고 있음)
+ */
+class WorkerPool {
+    public:
+        WorkerPool() {}
+        ~WorkerPool();
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // 호출한 스레드를 포함해서 최대 numThreads 개의 스레드로 task(0) ~ task(count - 1) 을 처리함.
+        void parallelFor(size_t count, int numThreads, const std::function<void(size_t)>& task);
+
+        // 지금까지 만든 워커 스레드 수 (호출한 스레드는 빼고)
+        size_t getNumWorkers() const { return workers.size(); }
+
+    private:
+        void workerLoop(size_t index);
+        void runTasks();
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake; // 새 작업이 들어왔거나 종료할 때
+        std::condition_variable done; // 이번 작업에 참여한 워커가 모두 끝났을 때
+
+        // 아래 값들은 mutex 를 잡고 바꿈. (nextTask 만 작업 중에 락 없이 올림)
+        const std::function<void(size_t)>* task = nullptr;
+        size_t taskCount = 0;
+        std::atomic<size_t> nextTask{0};
+        size_t participants = 0; // 이번 작업에 참여할 워커 수 (인덱스가 이보다 작은 워커만 참여)
+        size_t busy = 0; // 아직 끝나지 않은 참여 워커 수
+        uint64_t generation = 0; // parallelFor() 호출마다 1 씩 올림
+        bool stopping = false;
+};